@@ -19,4 +19,8 @@
 #define OUZEL_ENABLE_COREAUDIO 1
 #define OUZEL_ENABLE_ALSA 1
 
+#define OUZEL_ENABLE_PROFILER 0
+
+#define OUZEL_CHECK_AUDIO_ALLOCATIONS 0
+
 #endif // OUZEL_CONFIG_H
@@ -0,0 +1,47 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_ASSETID_HPP
+#define OUZEL_ASSETS_ASSETID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include "../hash/Fnv1.hpp"
+
+namespace ouzel::assets
+{
+    // 64-bit FNV-1 hash of the name of an asset, the names are not compared when looking up assets, so in debug
+    // builds the cache checks that no two names have the same hash
+    class AssetId final
+    {
+    public:
+        constexpr AssetId() noexcept = default;
+        constexpr AssetId(const char* name) noexcept: AssetId(std::string_view{name}) {}
+        constexpr AssetId(const std::string_view name) noexcept: value(hash::fnv1::hashString<std::uint64_t>(name)) {}
+        AssetId(const std::string& name) noexcept: AssetId(std::string_view{name}) {}
+
+        constexpr auto getValue() const noexcept { return value; }
+
+        constexpr bool operator==(const AssetId& other) const noexcept { return value == other.value; }
+        constexpr bool operator!=(const AssetId& other) const noexcept { return value != other.value; }
+        constexpr bool operator<(const AssetId& other) const noexcept { return value < other.value; }
+
+    private:
+        std::uint64_t value = 0;
+    };
+}
+
+namespace std
+{
+    template <> struct hash<ouzel::assets::AssetId>
+    {
+        std::size_t operator()(const ouzel::assets::AssetId& assetId) const noexcept
+        {
+            return hash<std::uint64_t>()(assetId.getValue());
+        }
+    };
+}
+
+#endif // OUZEL_ASSETS_ASSETID_HPP
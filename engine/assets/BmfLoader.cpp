@@ -7,13 +7,13 @@
 namespace ouzel::assets
 {
     BmfLoader::BmfLoader(Cache& initCache):
-        Loader(initCache, Type::font)
+        Loader(initCache, Type::font, {"fnt"}, {"info"})
     {
     }
 
     bool BmfLoader::loadAsset(Bundle& bundle,
                               const std::string& name,
-                              const std::vector<std::byte>& data,
+                              const storage::FileData& data,
                               bool)
     {
         try
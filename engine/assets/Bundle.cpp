@@ -1,18 +1,126 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cctype>
 #include <stdexcept>
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "Loader.hpp"
+#include "../core/Engine.hpp"
+#include "../events/EventDispatcher.hpp"
 #include "../formats/Json.hpp"
+#include "../utils/Profiler.hpp"
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        // the assets of a later stage can depend on the assets of the earlier stages
+        std::uint32_t getStage(Loader::Type type) noexcept
+        {
+            switch (type)
+            {
+                case Loader::Type::sprite:
+                case Loader::Type::particleSystem:
+                case Loader::Type::material:
+                case Loader::Type::cue:
+                    return 1;
+                case Loader::Type::staticMesh:
+                case Loader::Type::skinnedMesh:
+                    return 2;
+                default:
+                    return 0;
+            }
+        }
+
+        template <class Map>
+        std::vector<AssetId> getKeys(const Map& map)
+        {
+            std::vector<AssetId> keys;
+            keys.reserve(map.size());
+            for (const auto& i : map)
+                keys.push_back(i.first);
+            return keys;
+        }
+
+        std::string getExtension(const std::string& filename)
+        {
+            auto extension = std::string(storage::Path(filename).getExtension());
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                           [](char c) noexcept { return static_cast<char>(std::tolower(c)); });
+            return extension;
+        }
+    }
+
+    Bundle::AsyncLoad::AsyncLoad(LoaderPool& loaderPool,
+                                 std::vector<std::shared_ptr<Item>> initItems,
+                                 std::size_t initBatchSize):
+        items(std::move(initItems)),
+        batchSize(std::max(initBatchSize, std::size_t{1})),
+        progress(std::make_shared<LoadProgress>(items.size()))
+    {
+#if defined(__EMSCRIPTEN__)
+        // the files are read on the update thread
+        for (const auto& item : items)
+        {
+            item->readable = false;
+            item->ready = true;
+        }
+#else
+        for (const auto& item : items)
+            if (item->readable)
+                loaderPool.addJob([item]() {
+                    if (!item->cancelled.load(std::memory_order_relaxed))
+                        readItem(*item);
+
+                    item->ready.store(true, std::memory_order_release);
+                });
+            else
+                item->ready = true;
+#endif
+    }
+
+    Bundle::AsyncLoad::~AsyncLoad()
+    {
+        // the jobs of the items that have not been read yet skip them
+        for (const auto& item : items)
+            item->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    void Bundle::AsyncLoad::readItem(Item& item)
+    {
+        try
+        {
+            item.data = storage::FileData::map(item.section.path, item.section.offset, item.section.size);
+
+            // only the loader that would be tried first decodes the data
+            std::vector<std::shared_ptr<Loader>> loaders;
+            Cache::selectLoaders(item.loaders, getExtension(item.asset.filename), item.data, loaders);
+            if (!loaders.empty())
+            {
+                item.decoded = loaders.front()->decodeAsset(item.data, item.asset.mipmaps);
+                if (item.decoded) item.decoder = loaders.front();
+            }
+        }
+        catch (const std::exception&)
+        {
+            // the asset is loaded on the update thread, which reports the error
+            item.readable = false;
+            item.data = storage::FileData{};
+            item.decoded.reset();
+            item.decoder.reset();
+        }
+    }
+
     Bundle::Bundle(Cache& initCache, storage::FileSystem& initFileSystem):
         cache(initCache), fileSystem(initFileSystem)
     {
         cache.addBundle(this);
+
+        updateHandler.updateHandler = [this](const UpdateEvent&) {
+            loadPendingAssets();
+            return false;
+        };
     }
 
     Bundle::~Bundle()
@@ -23,19 +131,40 @@ namespace ouzel::assets
     void Bundle::loadAsset(Loader::Type loaderType, const std::string& name,
                            const std::string& filename, bool mipmaps)
     {
-        const auto data = fileSystem.readFile(filename);
+        OUZEL_PROFILE_SCOPE("Bundle::loadAsset");
+
+        const auto data = fileSystem.mapFile(filename);
 
-        const auto& loaders = cache.getLoaders();
+        if (!loadAssetData(loaderType, name, filename, data, mipmaps))
+            throw std::runtime_error("Failed to load asset " + filename);
+    }
+
+    bool Bundle::loadAssetData(Loader::Type loaderType, const std::string& name, const std::string& filename,
+                               const storage::FileData& data, bool mipmaps)
+    {
+        std::vector<std::shared_ptr<Loader>> loaders;
+        cache.selectLoaders(loaderType, getExtension(filename), data, loaders);
 
-        for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+        for (const auto& loader : loaders)
         {
-            Loader* loader = i->get();
-            if (loader->getType() == loaderType &&
-                loader->loadAsset(*this, name, data, mipmaps))
-                return;
+            const auto startTime = std::chrono::steady_clock::now();
+
+            bool loaded;
+            try
+            {
+                loaded = loader->loadAsset(*this, name, data, mipmaps);
+            }
+            catch (...)
+            {
+                loader->addLoadTime(std::chrono::steady_clock::now() - startTime, false);
+                throw;
+            }
+
+            loader->addLoadTime(std::chrono::steady_clock::now() - startTime, loaded);
+            if (loaded) return true;
         }
 
-        throw std::runtime_error("Failed to load asset " + filename);
+        return false;
     }
 
     void Bundle::loadAssets(const std::string& filename)
@@ -57,9 +186,135 @@ namespace ouzel::assets
             loadAsset(asset.type, asset.name, asset.filename, asset.mipmaps);
     }
 
-    std::shared_ptr<graphics::Texture> Bundle::getTexture(const std::string& name) const
+    std::shared_ptr<const LoadProgress> Bundle::loadAssetsAsync(const std::string& filename, std::size_t batchSize)
     {
-        const auto i = textures.find(name);
+        const auto data = json::parse(fileSystem.readFile(filename));
+
+        std::vector<Asset> assets;
+
+        for (const auto& asset : data["assets"])
+        {
+            const auto file = asset["filename"].as<std::string>();
+            const auto name = asset.hasMember("name") ? asset["name"].as<std::string>() : file;
+            const auto mipmaps = asset.hasMember("mipmaps") ? asset["mipmaps"].as<bool>() : true;
+            assets.emplace_back(static_cast<Loader::Type>(asset["type"].as<std::uint32_t>()), name, file, mipmaps);
+        }
+
+        return loadAssetsAsync(assets, batchSize);
+    }
+
+    std::shared_ptr<const LoadProgress> Bundle::loadAssetsAsync(const std::vector<Asset>& assets, std::size_t batchSize)
+    {
+        std::vector<std::shared_ptr<AsyncLoad::Item>> items;
+        items.reserve(assets.size());
+
+        for (const Asset& asset : assets)
+        {
+            auto item = std::make_shared<AsyncLoad::Item>(asset);
+
+            try
+            {
+                item->section = fileSystem.getFileSection(asset.filename);
+                item->loaders = cache.getTypeLoaders(asset.type);
+                item->readable = true;
+            }
+            catch (const std::exception&)
+            {
+                // files that are not in the file system (e.g. Android assets) are read on the update thread
+            }
+
+            items.push_back(std::move(item));
+        }
+
+        std::stable_sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+            return getStage(a->asset.type) < getStage(b->asset.type);
+        });
+
+        auto asyncLoad = std::make_unique<AsyncLoad>(cache.loaderPool, std::move(items), batchSize);
+        auto progress = asyncLoad->progress;
+
+        if (!progress->isFinished())
+        {
+            if (asyncLoads.empty())
+                engine->getEventDispatcher().addEventHandler(updateHandler);
+
+            asyncLoads.push_back(std::move(asyncLoad));
+        }
+
+        return progress;
+    }
+
+    bool Bundle::loadDecodedAsset(Loader& loader, const std::string& name, DecodedAsset& decoded, bool mipmaps)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        bool loaded;
+        try
+        {
+            loaded = loader.loadDecodedAsset(*this, name, decoded, mipmaps);
+        }
+        catch (...)
+        {
+            loader.addLoadTime(std::chrono::steady_clock::now() - startTime, false);
+            throw;
+        }
+
+        loader.addLoadTime(std::chrono::steady_clock::now() - startTime, loaded);
+        return loaded;
+    }
+
+    void Bundle::loadPendingAssets()
+    {
+        OUZEL_PROFILE_SCOPE("Bundle::loadPendingAssets");
+
+        for (auto i = asyncLoads.begin(); i != asyncLoads.end();)
+        {
+            AsyncLoad& asyncLoad = **i;
+
+            // the assets are created in order, so that the assets they depend on are created first
+            for (std::size_t count = 0; count < asyncLoad.batchSize && asyncLoad.nextItem < asyncLoad.items.size(); ++count)
+            {
+                auto& item = *asyncLoad.items[asyncLoad.nextItem];
+                if (!item.ready.load(std::memory_order_acquire)) break;
+
+                const auto& asset = item.asset;
+
+                try
+                {
+                    if (!item.decoded || !loadDecodedAsset(*item.decoder, asset.name, *item.decoded, asset.mipmaps))
+                    {
+                        const auto data = item.readable ? std::move(item.data) : fileSystem.mapFile(asset.filename);
+
+                        if (!loadAssetData(asset.type, asset.name, asset.filename, data, asset.mipmaps))
+                            throw std::runtime_error("Failed to load asset " + asset.filename);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    asyncLoad.progress->setError(e.what());
+                }
+
+                item.data = storage::FileData{};
+                item.decoded.reset();
+                item.decoder.reset();
+                item.loaders.clear();
+
+                ++asyncLoad.nextItem;
+                asyncLoad.progress->loadedCount.fetch_add(1, std::memory_order_release);
+            }
+
+            if (asyncLoad.nextItem == asyncLoad.items.size())
+                i = asyncLoads.erase(i);
+            else
+                ++i;
+        }
+
+        if (asyncLoads.empty()) updateHandler.remove();
+    }
+
+    std::shared_ptr<graphics::Texture> Bundle::getTexture(const AssetId& id) const
+    {
+        const auto i = textures.find(id);
 
         if (i != textures.end())
             return i->second;
@@ -69,17 +324,21 @@ namespace ouzel::assets
 
     void Bundle::setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture)
     {
+        cache.checkAssetName(name);
         textures[name] = texture;
+        cache.addAsset(AssetType::texture, name);
     }
 
     void Bundle::releaseTextures()
     {
+        const auto ids = getAssetIds(AssetType::texture);
         textures.clear();
+        cache.updateIndex(AssetType::texture, ids);
     }
 
-    const graphics::Shader* Bundle::getShader(const std::string& name) const
+    const graphics::Shader* Bundle::getShader(const AssetId& id) const
     {
-        const auto i = shaders.find(name);
+        const auto i = shaders.find(id);
 
         if (i != shaders.end())
             return i->second.get();
@@ -89,17 +348,21 @@ namespace ouzel::assets
 
     void Bundle::setShader(const std::string& name, std::unique_ptr<graphics::Shader> shader)
     {
+        cache.checkAssetName(name);
         shaders[name] = std::move(shader);
+        cache.addAsset(AssetType::shader, name);
     }
 
     void Bundle::releaseShaders()
     {
+        const auto ids = getAssetIds(AssetType::shader);
         shaders.clear();
+        cache.updateIndex(AssetType::shader, ids);
     }
 
-    const graphics::BlendState* Bundle::getBlendState(const std::string& name) const
+    const graphics::BlendState* Bundle::getBlendState(const AssetId& id) const
     {
-        const auto i = blendStates.find(name);
+        const auto i = blendStates.find(id);
 
         if (i != blendStates.end())
             return i->second.get();
@@ -109,17 +372,21 @@ namespace ouzel::assets
 
     void Bundle::setBlendState(const std::string& name, std::unique_ptr<graphics::BlendState> blendState)
     {
+        cache.checkAssetName(name);
         blendStates[name] = std::move(blendState);
+        cache.addAsset(AssetType::blendState, name);
     }
 
     void Bundle::releaseBlendStates()
     {
+        const auto ids = getAssetIds(AssetType::blendState);
         blendStates.clear();
+        cache.updateIndex(AssetType::blendState, ids);
     }
 
-    const graphics::DepthStencilState* Bundle::getDepthStencilState(const std::string& name) const
+    const graphics::DepthStencilState* Bundle::getDepthStencilState(const AssetId& id) const
     {
-        const auto i = depthStencilStates.find(name);
+        const auto i = depthStencilStates.find(id);
 
         if (i != depthStencilStates.end())
             return i->second.get();
@@ -129,21 +396,23 @@ namespace ouzel::assets
 
     void Bundle::setDepthStencilState(const std::string& name, std::unique_ptr<graphics::DepthStencilState> depthStencilState)
     {
+        cache.checkAssetName(name);
         depthStencilStates[name] = std::move(depthStencilState);
+        cache.addAsset(AssetType::depthStencilState, name);
     }
 
     void Bundle::releaseDepthStencilStates()
     {
+        const auto ids = getAssetIds(AssetType::depthStencilState);
         depthStencilStates.clear();
+        cache.updateIndex(AssetType::depthStencilState, ids);
     }
 
     void Bundle::preloadSpriteData(const std::string& filename, bool mipmaps,
                                    std::uint32_t spritesX, std::uint32_t spritesY,
                                    const Vector2F& pivot)
     {
-        auto extension = std::string(storage::Path(filename).getExtension());
-        std::transform(extension.begin(), extension.end(), extension.begin(),
-                       [](char c) noexcept { return static_cast<char>(std::tolower(c)); });
+        const auto extension = getExtension(filename);
         const std::vector<std::string> imageExtensions{"jpg", "jpeg", "png", "bmp", "tga"};
 
         if (std::find(imageExtensions.begin(), imageExtensions.end(), extension) != imageExtensions.end())
@@ -180,17 +449,20 @@ namespace ouzel::assets
                 }
 
                 newSpriteData.animations[""] = std::move(animation);
+                newSpriteData.createBuffers();
 
+                cache.checkAssetName(filename);
                 spriteData[filename] = newSpriteData;
+                cache.addAsset(AssetType::spriteData, filename);
             }
         }
         else
             loadAsset(Loader::Type::sprite, filename, filename, mipmaps);
     }
 
-    const scene::SpriteData* Bundle::getSpriteData(const std::string& name) const
+    const scene::SpriteData* Bundle::getSpriteData(const AssetId& id) const
     {
-        const auto i = spriteData.find(name);
+        const auto i = spriteData.find(id);
 
         if (i != spriteData.end())
             return &i->second;
@@ -200,17 +472,22 @@ namespace ouzel::assets
 
     void Bundle::setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData)
     {
-        spriteData[name] = newSpriteData;
+        cache.checkAssetName(name);
+        auto& data = spriteData[name] = newSpriteData;
+        data.createBuffers();
+        cache.addAsset(AssetType::spriteData, name);
     }
 
     void Bundle::releaseSpriteData()
     {
+        const auto ids = getAssetIds(AssetType::spriteData);
         spriteData.clear();
+        cache.updateIndex(AssetType::spriteData, ids);
     }
 
-    const scene::ParticleSystemData* Bundle::getParticleSystemData(const std::string& name) const
+    const scene::ParticleSystemData* Bundle::getParticleSystemData(const AssetId& id) const
     {
-        const auto i = particleSystemData.find(name);
+        const auto i = particleSystemData.find(id);
 
         if (i != particleSystemData.end())
             return &i->second;
@@ -220,17 +497,21 @@ namespace ouzel::assets
 
     void Bundle::setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData)
     {
+        cache.checkAssetName(name);
         particleSystemData[name] = newParticleSystemData;
+        cache.addAsset(AssetType::particleSystemData, name);
     }
 
     void Bundle::releaseParticleSystemData()
     {
+        const auto ids = getAssetIds(AssetType::particleSystemData);
         particleSystemData.clear();
+        cache.updateIndex(AssetType::particleSystemData, ids);
     }
 
-    const gui::Font* Bundle::getFont(const std::string& name) const
+    const gui::Font* Bundle::getFont(const AssetId& id) const
     {
-        const auto i = fonts.find(name);
+        const auto i = fonts.find(id);
 
         if (i != fonts.end())
             return i->second.get();
@@ -240,17 +521,21 @@ namespace ouzel::assets
 
     void Bundle::setFont(const std::string& name, std::unique_ptr<gui::Font> font)
     {
+        cache.checkAssetName(name);
         fonts[name] = std::move(font);
+        cache.addAsset(AssetType::font, name);
     }
 
     void Bundle::releaseFonts()
     {
+        const auto ids = getAssetIds(AssetType::font);
         fonts.clear();
+        cache.updateIndex(AssetType::font, ids);
     }
 
-    const audio::Cue* Bundle::getCue(const std::string& name) const
+    const audio::Cue* Bundle::getCue(const AssetId& id) const
     {
-        const auto i = cues.find(name);
+        const auto i = cues.find(id);
 
         if (i != cues.end())
             return i->second.get();
@@ -260,17 +545,21 @@ namespace ouzel::assets
 
     void Bundle::setCue(const std::string& name, std::unique_ptr<audio::Cue> cue)
     {
+        cache.checkAssetName(name);
         cues[name] = std::move(cue);
+        cache.addAsset(AssetType::cue, name);
     }
 
     void Bundle::releaseCues()
     {
+        const auto ids = getAssetIds(AssetType::cue);
         cues.clear();
+        cache.updateIndex(AssetType::cue, ids);
     }
 
-    const audio::Sound* Bundle::getSound(const std::string& name) const
+    const audio::Sound* Bundle::getSound(const AssetId& id) const
     {
-        const auto i = sounds.find(name);
+        const auto i = sounds.find(id);
 
         if (i != sounds.end())
             return i->second.get();
@@ -280,17 +569,21 @@ namespace ouzel::assets
 
     void Bundle::setSound(const std::string& name, std::unique_ptr<audio::Sound> sound)
     {
+        cache.checkAssetName(name);
         sounds[name] = std::move(sound);
+        cache.addAsset(AssetType::sound, name);
     }
 
     void Bundle::releaseSounds()
     {
+        const auto ids = getAssetIds(AssetType::sound);
         sounds.clear();
+        cache.updateIndex(AssetType::sound, ids);
     }
 
-    const graphics::Material* Bundle::getMaterial(const std::string& name) const
+    const graphics::Material* Bundle::getMaterial(const AssetId& id) const
     {
-        const auto i = materials.find(name);
+        const auto i = materials.find(id);
 
         if (i != materials.end())
             return i->second.get();
@@ -300,17 +593,21 @@ namespace ouzel::assets
 
     void Bundle::setMaterial(const std::string& name, std::unique_ptr<graphics::Material> material)
     {
+        cache.checkAssetName(name);
         materials[name] = std::move(material);
+        cache.addAsset(AssetType::material, name);
     }
 
     void Bundle::releaseMaterials()
     {
+        const auto ids = getAssetIds(AssetType::material);
         materials.clear();
+        cache.updateIndex(AssetType::material, ids);
     }
 
-    const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(const std::string& name) const
+    const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(const AssetId& id) const
     {
-        const auto i = skinnedMeshData.find(name);
+        const auto i = skinnedMeshData.find(id);
 
         if (i != skinnedMeshData.end())
             return &i->second;
@@ -320,17 +617,21 @@ namespace ouzel::assets
 
     void Bundle::setSkinnedMeshData(const std::string& name, scene::SkinnedMeshData&& newSkinnedMeshData)
     {
+        cache.checkAssetName(name);
         skinnedMeshData[name] = std::move(newSkinnedMeshData);
+        cache.addAsset(AssetType::skinnedMeshData, name);
     }
 
     void Bundle::releaseSkinnedMeshData()
     {
+        const auto ids = getAssetIds(AssetType::skinnedMeshData);
         skinnedMeshData.clear();
+        cache.updateIndex(AssetType::skinnedMeshData, ids);
     }
 
-    const scene::StaticMeshData* Bundle::getStaticMeshData(const std::string& name) const
+    const scene::StaticMeshData* Bundle::getStaticMeshData(const AssetId& id) const
     {
-        const auto i = staticMeshData.find(name);
+        const auto i = staticMeshData.find(id);
 
         if (i != staticMeshData.end())
             return &i->second;
@@ -340,11 +641,55 @@ namespace ouzel::assets
 
     void Bundle::setStaticMeshData(const std::string& name, scene::StaticMeshData&& newStaticMeshData)
     {
+        cache.checkAssetName(name);
         staticMeshData[name] = std::move(newStaticMeshData);
+        cache.addAsset(AssetType::staticMeshData, name);
     }
 
     void Bundle::releaseStaticMeshData()
     {
+        const auto ids = getAssetIds(AssetType::staticMeshData);
         staticMeshData.clear();
+        cache.updateIndex(AssetType::staticMeshData, ids);
+    }
+
+    bool Bundle::hasAsset(AssetType type, const AssetId& id) const
+    {
+        switch (type)
+        {
+            case AssetType::texture: return textures.find(id) != textures.end();
+            case AssetType::shader: return shaders.find(id) != shaders.end();
+            case AssetType::blendState: return blendStates.find(id) != blendStates.end();
+            case AssetType::depthStencilState: return depthStencilStates.find(id) != depthStencilStates.end();
+            case AssetType::spriteData: return spriteData.find(id) != spriteData.end();
+            case AssetType::particleSystemData: return particleSystemData.find(id) != particleSystemData.end();
+            case AssetType::font: return fonts.find(id) != fonts.end();
+            case AssetType::cue: return cues.find(id) != cues.end();
+            case AssetType::sound: return sounds.find(id) != sounds.end();
+            case AssetType::material: return materials.find(id) != materials.end();
+            case AssetType::skinnedMeshData: return skinnedMeshData.find(id) != skinnedMeshData.end();
+            case AssetType::staticMeshData: return staticMeshData.find(id) != staticMeshData.end();
+            default: throw std::runtime_error("Invalid asset type");
+        }
+    }
+
+    std::vector<AssetId> Bundle::getAssetIds(AssetType type) const
+    {
+        switch (type)
+        {
+            case AssetType::texture: return getKeys(textures);
+            case AssetType::shader: return getKeys(shaders);
+            case AssetType::blendState: return getKeys(blendStates);
+            case AssetType::depthStencilState: return getKeys(depthStencilStates);
+            case AssetType::spriteData: return getKeys(spriteData);
+            case AssetType::particleSystemData: return getKeys(particleSystemData);
+            case AssetType::font: return getKeys(fonts);
+            case AssetType::cue: return getKeys(cues);
+            case AssetType::sound: return getKeys(sounds);
+            case AssetType::material: return getKeys(materials);
+            case AssetType::skinnedMeshData: return getKeys(skinnedMeshData);
+            case AssetType::staticMeshData: return getKeys(staticMeshData);
+            default: throw std::runtime_error("Invalid asset type");
+        }
     }
 }
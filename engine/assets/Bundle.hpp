@@ -3,12 +3,17 @@
 #ifndef OUZEL_ASSETS_BUNDLE_HPP
 #define OUZEL_ASSETS_BUNDLE_HPP
 
-#include <map>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include "AssetId.hpp"
 #include "Loader.hpp"
 #include "../audio/Cue.hpp"
 #include "../audio/Sound.hpp"
+#include "../events/EventHandler.hpp"
 #include "../graphics/BlendState.hpp"
 #include "../graphics/DepthStencilState.hpp"
 #include "../graphics/Material.hpp"
@@ -24,6 +29,7 @@
 namespace ouzel::assets
 {
     class Cache;
+    class LoaderPool;
 
     class Asset final
     {
@@ -45,6 +51,48 @@ namespace ouzel::assets
         bool mipmaps;
     };
 
+    // progress of an asynchronous load, can be read from any thread
+    class LoadProgress final
+    {
+        friend Bundle;
+    public:
+        explicit LoadProgress(std::size_t initAssetCount) noexcept:
+            assetCount(initAssetCount)
+        {
+        }
+
+        auto getAssetCount() const noexcept { return assetCount; }
+        auto getLoadedCount() const noexcept { return loadedCount.load(std::memory_order_acquire); }
+        auto isFinished() const noexcept { return getLoadedCount() == assetCount; }
+
+        float getProgress() const noexcept
+        {
+            return assetCount ? static_cast<float>(getLoadedCount()) / static_cast<float>(assetCount) : 1.0F;
+        }
+
+        // the assets that fail to load are counted as loaded, the error of the first one is kept
+        auto hasFailed() const noexcept { return failed.load(std::memory_order_acquire); }
+        std::string getError() const
+        {
+            std::lock_guard lock(errorMutex);
+            return error;
+        }
+
+    private:
+        void setError(const std::string& newError)
+        {
+            std::lock_guard lock(errorMutex);
+            if (!failed.load(std::memory_order_relaxed)) error = newError;
+            failed.store(true, std::memory_order_release);
+        }
+
+        std::size_t assetCount;
+        std::atomic<std::size_t> loadedCount{0};
+        std::atomic_bool failed{false};
+        mutable std::mutex errorMutex;
+        std::string error;
+    };
+
     class Bundle final
     {
         friend Cache;
@@ -63,73 +111,147 @@ namespace ouzel::assets
         void loadAssets(const std::string& filename);
         void loadAssets(const std::vector<Asset>& assets);
 
-        std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
+        // reads and decodes the files on worker threads and creates the assets on the update thread, at most batchSize
+        // assets per update, the assets are created after the assets they depend on (e.g. sprites after images and
+        // meshes after materials)
+        std::shared_ptr<const LoadProgress> loadAssetsAsync(const std::string& filename, std::size_t batchSize = 8);
+        std::shared_ptr<const LoadProgress> loadAssetsAsync(const std::vector<Asset>& assets, std::size_t batchSize = 8);
+
+        std::shared_ptr<graphics::Texture> getTexture(const AssetId& id) const;
         void setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture);
         void releaseTextures();
 
-        const graphics::Shader* getShader(const std::string& shaderName) const;
+        const graphics::Shader* getShader(const AssetId& id) const;
         void setShader(const std::string& name, std::unique_ptr<graphics::Shader> shader);
         void releaseShaders();
 
-        const graphics::BlendState* getBlendState(const std::string& name) const;
+        const graphics::BlendState* getBlendState(const AssetId& id) const;
         void setBlendState(const std::string& name, std::unique_ptr<graphics::BlendState> blendState);
         void releaseBlendStates();
 
-        const graphics::DepthStencilState* getDepthStencilState(const std::string& name) const;
+        const graphics::DepthStencilState* getDepthStencilState(const AssetId& id) const;
         void setDepthStencilState(const std::string& name, std::unique_ptr<graphics::DepthStencilState> depthStencilState);
         void releaseDepthStencilStates();
 
         void preloadSpriteData(const std::string& filename, bool mipmaps = true,
                                std::uint32_t spritesX = 1, std::uint32_t spritesY = 1,
                                const Vector2F& pivot = Vector2F{0.5F, 0.5F});
-        const scene::SpriteData* getSpriteData(const std::string& name) const;
+        const scene::SpriteData* getSpriteData(const AssetId& id) const;
         void setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData);
         void releaseSpriteData();
 
-        const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const;
+        const scene::ParticleSystemData* getParticleSystemData(const AssetId& id) const;
         void setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData);
         void releaseParticleSystemData();
 
-        const gui::Font* getFont(const std::string& name) const;
+        const gui::Font* getFont(const AssetId& id) const;
         void setFont(const std::string& name, std::unique_ptr<gui::Font> font);
         void releaseFonts();
 
-        const audio::Cue* getCue(const std::string& name) const;
+        const audio::Cue* getCue(const AssetId& id) const;
         void setCue(const std::string& name, std::unique_ptr<audio::Cue> cue);
         void releaseCues();
 
-        const audio::Sound* getSound(const std::string& name) const;
+        const audio::Sound* getSound(const AssetId& id) const;
         void setSound(const std::string& name, std::unique_ptr<audio::Sound> sound);
         void releaseSounds();
 
-        const graphics::Material* getMaterial(const std::string& name) const;
+        const graphics::Material* getMaterial(const AssetId& id) const;
         void setMaterial(const std::string& name, std::unique_ptr<graphics::Material> material);
         void releaseMaterials();
 
-        const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const;
+        const scene::SkinnedMeshData* getSkinnedMeshData(const AssetId& id) const;
         void setSkinnedMeshData(const std::string& name, scene::SkinnedMeshData&& newSkinnedMeshData);
         void releaseSkinnedMeshData();
 
-        const scene::StaticMeshData* getStaticMeshData(const std::string& name) const;
+        const scene::StaticMeshData* getStaticMeshData(const AssetId& id) const;
         void setStaticMeshData(const std::string& name, scene::StaticMeshData&& newStaticMeshData);
         void releaseStaticMeshData();
 
     private:
+        bool loadAssetData(Loader::Type loaderType, const std::string& name, const std::string& filename,
+                           const storage::FileData& data, bool mipmaps);
+        bool loadDecodedAsset(Loader& loader, const std::string& name, DecodedAsset& decoded, bool mipmaps);
+        void loadPendingAssets();
+
         Cache& cache;
         storage::FileSystem& fileSystem;
 
-        std::map<std::string, std::shared_ptr<graphics::Texture>> textures;
-        std::map<std::string, std::unique_ptr<graphics::Shader>> shaders;
-        std::map<std::string, scene::ParticleSystemData> particleSystemData;
-        std::map<std::string, std::unique_ptr<graphics::BlendState>> blendStates;
-        std::map<std::string, std::unique_ptr<graphics::DepthStencilState>> depthStencilStates;
-        std::map<std::string, scene::SpriteData> spriteData;
-        std::map<std::string, std::unique_ptr<gui::Font>> fonts;
-        std::map<std::string, std::unique_ptr<audio::Cue>> cues;
-        std::map<std::string, std::unique_ptr<audio::Sound>> sounds;
-        std::map<std::string, std::unique_ptr<graphics::Material>> materials;
-        std::map<std::string, scene::SkinnedMeshData> skinnedMeshData;
-        std::map<std::string, scene::StaticMeshData> staticMeshData;
+        class AsyncLoad final
+        {
+        public:
+            struct Item final
+            {
+                explicit Item(const Asset& initAsset): asset(initAsset) {}
+
+                Asset asset;
+                bool readable = false; // the file section is known, so the file can be read on a worker thread
+                storage::FileSection section;
+                storage::FileData data;
+                std::unique_ptr<DecodedAsset> decoded;
+                std::vector<std::shared_ptr<Loader>> loaders; // copied on the update thread when the load starts
+                std::shared_ptr<Loader> decoder;
+                std::atomic_bool ready{false};
+                std::atomic_bool cancelled{false};
+            };
+
+            AsyncLoad(LoaderPool& loaderPool,
+                      std::vector<std::shared_ptr<Item>> initItems,
+                      std::size_t initBatchSize);
+            ~AsyncLoad();
+
+            AsyncLoad(const AsyncLoad&) = delete;
+            AsyncLoad& operator=(const AsyncLoad&) = delete;
+
+            AsyncLoad(AsyncLoad&&) = delete;
+            AsyncLoad& operator=(AsyncLoad&&) = delete;
+
+            // runs on the loader pool of the cache
+            static void readItem(Item& item);
+
+            // the items are shared with the jobs of the loader pool, which can outlive the load
+            std::vector<std::shared_ptr<Item>> items; // in the order of creation
+            std::size_t batchSize;
+            std::shared_ptr<LoadProgress> progress;
+            std::size_t nextItem = 0; // next item to create the asset of
+        };
+
+        std::vector<std::unique_ptr<AsyncLoad>> asyncLoads;
+        EventHandler updateHandler;
+
+        enum class AssetType
+        {
+            texture,
+            shader,
+            blendState,
+            depthStencilState,
+            spriteData,
+            particleSystemData,
+            font,
+            cue,
+            sound,
+            material,
+            skinnedMeshData,
+            staticMeshData
+        };
+
+        static constexpr std::size_t assetTypeCount = static_cast<std::size_t>(AssetType::staticMeshData) + 1;
+
+        bool hasAsset(AssetType type, const AssetId& id) const;
+        std::vector<AssetId> getAssetIds(AssetType type) const;
+
+        std::unordered_map<AssetId, std::shared_ptr<graphics::Texture>> textures;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::Shader>> shaders;
+        std::unordered_map<AssetId, scene::ParticleSystemData> particleSystemData;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::BlendState>> blendStates;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::DepthStencilState>> depthStencilStates;
+        std::unordered_map<AssetId, scene::SpriteData> spriteData;
+        std::unordered_map<AssetId, std::unique_ptr<gui::Font>> fonts;
+        std::unordered_map<AssetId, std::unique_ptr<audio::Cue>> cues;
+        std::unordered_map<AssetId, std::unique_ptr<audio::Sound>> sounds;
+        std::unordered_map<AssetId, std::unique_ptr<graphics::Material>> materials;
+        std::unordered_map<AssetId, scene::SkinnedMeshData> skinnedMeshData;
+        std::unordered_map<AssetId, scene::StaticMeshData> staticMeshData;
     };
 }
 
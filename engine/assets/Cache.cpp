@@ -1,6 +1,7 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <stdexcept>
 #include "Cache.hpp"
 #include "BmfLoader.hpp"
 #include "ColladaLoader.hpp"
@@ -40,21 +41,41 @@ namespace ouzel::assets
     {
         const auto i = std::find(bundles.begin(), bundles.end(), bundle);
         if (i == bundles.end())
+        {
             bundles.push_back(bundle);
+
+            for (std::size_t type = 0; type < Bundle::assetTypeCount; ++type)
+                updateIndex(static_cast<Bundle::AssetType>(type),
+                            bundle->getAssetIds(static_cast<Bundle::AssetType>(type)));
+        }
     }
 
     void Cache::removeBundle(const Bundle* bundle)
     {
         const auto i = std::find(bundles.begin(), bundles.end(), bundle);
         if (i != bundles.end())
+        {
             bundles.erase(i);
+
+            // the assets of the bundle are looked up in the remaining bundles
+            for (std::size_t type = 0; type < Bundle::assetTypeCount; ++type)
+                updateIndex(static_cast<Bundle::AssetType>(type),
+                            bundle->getAssetIds(static_cast<Bundle::AssetType>(type)));
+        }
     }
 
     void Cache::addLoader(std::unique_ptr<Loader> loader)
     {
-        const auto i = std::find(loaders.begin(), loaders.end(), loader);
+        const auto i = std::find_if(loaders.begin(), loaders.end(), [&loader](const auto& ownedLoader) noexcept {
+            return loader.get() == ownedLoader.get();
+        });
         if (i == loaders.end())
-            loaders.push_back(std::move(loader));
+        {
+            std::shared_ptr<Loader> sharedLoader = std::move(loader);
+            auto& loadersOfType = typeLoaders[sharedLoader->getType()];
+            loadersOfType.insert(loadersOfType.begin(), sharedLoader);
+            loaders.push_back(std::move(sharedLoader));
+        }
     }
 
     void Cache::removeLoader(const Loader* loader)
@@ -63,114 +84,173 @@ namespace ouzel::assets
             return loader == ownedLoader.get();
         });
         if (i != loaders.end())
+        {
+            auto& loadersOfType = typeLoaders[loader->getType()];
+            loadersOfType.erase(std::find(loadersOfType.begin(), loadersOfType.end(), *i));
             loaders.erase(i);
+        }
     }
 
-    std::shared_ptr<graphics::Texture> Cache::getTexture(const std::string& name) const
+    std::vector<std::shared_ptr<Loader>> Cache::getTypeLoaders(Loader::Type type) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto texture = bundle->getTexture(name))
-                return texture;
-
-        return nullptr;
+        const auto i = typeLoaders.find(type);
+        return i != typeLoaders.end() ? i->second : std::vector<std::shared_ptr<Loader>>{};
     }
 
-    const graphics::Shader* Cache::getShader(const std::string& name) const
+    void Cache::selectLoaders(Loader::Type type, const std::string& extension,
+                              const storage::FileData& data, std::vector<std::shared_ptr<Loader>>& result) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto shader = bundle->getShader(name))
-                return shader;
-
-        return nullptr;
+        const auto i = typeLoaders.find(type);
+        if (i != typeLoaders.end())
+            selectLoaders(i->second, extension, data, result);
+        else
+            result.clear();
     }
 
-    const graphics::BlendState* Cache::getBlendState(const std::string& name) const
+    void Cache::selectLoaders(const std::vector<std::shared_ptr<Loader>>& candidateLoaders,
+                              const std::string& extension, const storage::FileData& data,
+                              std::vector<std::shared_ptr<Loader>>& result)
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto blendState = bundle->getBlendState(name))
-                return blendState;
+        result.clear();
+
+        struct Candidate final
+        {
+            const std::shared_ptr<Loader>* loader;
+            Loader::Match match;
+        };
+
+        std::vector<Candidate> candidates;
+        candidates.reserve(candidateLoaders.size());
 
-        return nullptr;
+        for (const auto& loader : candidateLoaders)
+        {
+            const auto match = loader->match(extension, data);
+            if (match != Loader::Match::none)
+                candidates.push_back(Candidate{&loader, match});
+        }
+
+        // the loaders that match equally well keep the order they were added in
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) noexcept {
+            return a.match > b.match;
+        });
+
+        for (const Candidate& candidate : candidates)
+            result.push_back(*candidate.loader);
     }
 
-    const graphics::DepthStencilState* Cache::getDepthStencilState(const std::string& name) const
+    void Cache::checkAssetName([[maybe_unused]] const std::string& name)
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto depthStencilState = bundle->getDepthStencilState(name))
-                return depthStencilState;
+#if !defined(NDEBUG)
+        const AssetId id(name);
+        const auto i = names.find(id);
+        if (i == names.end())
+            names[id] = name;
+        else if (i->second != name)
+            throw std::runtime_error("Asset " + name + " has the same hash as " + i->second);
+#endif
+    }
 
-        return nullptr;
+    void Cache::addAsset(Bundle::AssetType type, const std::string& name)
+    {
+        updateIndex(type, AssetId(name));
     }
 
-    const scene::SpriteData* Cache::getSpriteData(const std::string& name) const
+    void Cache::updateIndex(Bundle::AssetType type, const AssetId& id)
     {
+        auto& index = indices[static_cast<std::size_t>(type)];
+
         for (const Bundle* bundle : bundles)
-            if (const auto spriteData = bundle->getSpriteData(name))
-                return spriteData;
+            if (bundle->hasAsset(type, id))
+            {
+                index[id] = bundle;
+                return;
+            }
 
-        return nullptr;
+        index.erase(id);
     }
 
-    const scene::ParticleSystemData* Cache::getParticleSystemData(const std::string& name) const
+    void Cache::updateIndex(Bundle::AssetType type, const std::vector<AssetId>& ids)
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto particleSystemData = bundle->getParticleSystemData(name))
-                return particleSystemData;
+        for (const auto& id : ids)
+            updateIndex(type, id);
+    }
 
-        return nullptr;
+    const Bundle* Cache::findBundle(Bundle::AssetType type, const AssetId& id) const
+    {
+        const auto& index = indices[static_cast<std::size_t>(type)];
+        const auto i = index.find(id);
+        return i != index.end() ? i->second : nullptr;
     }
 
-    const gui::Font* Cache::getFont(const std::string& name) const
+    std::shared_ptr<graphics::Texture> Cache::getTexture(const AssetId& id) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto font = bundle->getFont(name))
-                return font;
+        const auto bundle = findBundle(Bundle::AssetType::texture, id);
+        return bundle ? bundle->getTexture(id) : nullptr;
+    }
 
-        return nullptr;
+    const graphics::Shader* Cache::getShader(const AssetId& id) const
+    {
+        const auto bundle = findBundle(Bundle::AssetType::shader, id);
+        return bundle ? bundle->getShader(id) : nullptr;
     }
 
-    const audio::Cue* Cache::getCue(const std::string& name) const
+    const graphics::BlendState* Cache::getBlendState(const AssetId& id) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto cue = bundle->getCue(name))
-                return cue;
+        const auto bundle = findBundle(Bundle::AssetType::blendState, id);
+        return bundle ? bundle->getBlendState(id) : nullptr;
+    }
 
-        return nullptr;
+    const graphics::DepthStencilState* Cache::getDepthStencilState(const AssetId& id) const
+    {
+        const auto bundle = findBundle(Bundle::AssetType::depthStencilState, id);
+        return bundle ? bundle->getDepthStencilState(id) : nullptr;
     }
 
-    const audio::Sound* Cache::getSound(const std::string& name) const
+    const scene::SpriteData* Cache::getSpriteData(const AssetId& id) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto sound = bundle->getSound(name))
-                return sound;
+        const auto bundle = findBundle(Bundle::AssetType::spriteData, id);
+        return bundle ? bundle->getSpriteData(id) : nullptr;
+    }
 
-        return nullptr;
+    const scene::ParticleSystemData* Cache::getParticleSystemData(const AssetId& id) const
+    {
+        const auto bundle = findBundle(Bundle::AssetType::particleSystemData, id);
+        return bundle ? bundle->getParticleSystemData(id) : nullptr;
     }
 
-    const graphics::Material* Cache::getMaterial(const std::string& name) const
+    const gui::Font* Cache::getFont(const AssetId& id) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto material = bundle->getMaterial(name))
-                return material;
+        const auto bundle = findBundle(Bundle::AssetType::font, id);
+        return bundle ? bundle->getFont(id) : nullptr;
+    }
 
-        return nullptr;
+    const audio::Cue* Cache::getCue(const AssetId& id) const
+    {
+        const auto bundle = findBundle(Bundle::AssetType::cue, id);
+        return bundle ? bundle->getCue(id) : nullptr;
     }
 
-    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(const std::string& name) const
+    const audio::Sound* Cache::getSound(const AssetId& id) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto meshData = bundle->getSkinnedMeshData(name))
-                return meshData;
+        const auto bundle = findBundle(Bundle::AssetType::sound, id);
+        return bundle ? bundle->getSound(id) : nullptr;
+    }
 
-        return nullptr;
+    const graphics::Material* Cache::getMaterial(const AssetId& id) const
+    {
+        const auto bundle = findBundle(Bundle::AssetType::material, id);
+        return bundle ? bundle->getMaterial(id) : nullptr;
     }
 
-    const scene::StaticMeshData* Cache::getStaticMeshData(const std::string& name) const
+    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(const AssetId& id) const
     {
-        for (const Bundle* bundle : bundles)
-            if (const auto meshData = bundle->getStaticMeshData(name))
-                return meshData;
+        const auto bundle = findBundle(Bundle::AssetType::skinnedMeshData, id);
+        return bundle ? bundle->getSkinnedMeshData(id) : nullptr;
+    }
 
-        return nullptr;
+    const scene::StaticMeshData* Cache::getStaticMeshData(const AssetId& id) const
+    {
+        const auto bundle = findBundle(Bundle::AssetType::staticMeshData, id);
+        return bundle ? bundle->getStaticMeshData(id) : nullptr;
     }
 }
@@ -3,9 +3,14 @@
 #ifndef OUZEL_ASSETS_CACHE_HPP
 #define OUZEL_ASSETS_CACHE_HPP
 
+#include <array>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "Bundle.hpp"
+#include "LoaderPool.hpp"
 
 namespace ouzel::assets
 {
@@ -27,18 +32,33 @@ namespace ouzel::assets
         auto& getBundles() const noexcept { return bundles; }
         auto& getLoaders() const noexcept { return loaders; }
 
-        std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
-        const graphics::Shader* getShader(const std::string& name) const;
-        const graphics::BlendState* getBlendState(const std::string& name) const;
-        const graphics::DepthStencilState* getDepthStencilState(const std::string& name) const;
-        const scene::SpriteData* getSpriteData(const std::string& name) const;
-        const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const;
-        const gui::Font* getFont(const std::string& name) const;
-        const audio::Cue* getCue(const std::string& name) const;
-        const audio::Sound* getSound(const std::string& name) const;
-        const graphics::Material* getMaterial(const std::string& name) const;
-        const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const;
-        const scene::StaticMeshData* getStaticMeshData(const std::string& name) const;
+        // loaders of the type, the last added loader first, the copy can be used on other threads while loaders are
+        // added and removed
+        std::vector<std::shared_ptr<Loader>> getTypeLoaders(Loader::Type type) const;
+
+        // loaders of the type ordered by how well they match the extension and the signature of the file, the loaders
+        // of other formats are left out
+        void selectLoaders(Loader::Type type, const std::string& extension,
+                           const storage::FileData& data, std::vector<std::shared_ptr<Loader>>& result) const;
+
+        // same as above, but selects from the given loaders, which are ordered as returned by getTypeLoaders
+        static void selectLoaders(const std::vector<std::shared_ptr<Loader>>& typeLoaders,
+                                  const std::string& extension, const storage::FileData& data,
+                                  std::vector<std::shared_ptr<Loader>>& result);
+
+        // the assets are looked up by the hash of their name in the first bundle that has the asset
+        std::shared_ptr<graphics::Texture> getTexture(const AssetId& id) const;
+        const graphics::Shader* getShader(const AssetId& id) const;
+        const graphics::BlendState* getBlendState(const AssetId& id) const;
+        const graphics::DepthStencilState* getDepthStencilState(const AssetId& id) const;
+        const scene::SpriteData* getSpriteData(const AssetId& id) const;
+        const scene::ParticleSystemData* getParticleSystemData(const AssetId& id) const;
+        const gui::Font* getFont(const AssetId& id) const;
+        const audio::Cue* getCue(const AssetId& id) const;
+        const audio::Sound* getSound(const AssetId& id) const;
+        const graphics::Material* getMaterial(const AssetId& id) const;
+        const scene::SkinnedMeshData* getSkinnedMeshData(const AssetId& id) const;
+        const scene::StaticMeshData* getStaticMeshData(const AssetId& id) const;
 
     private:
         void addBundle(const Bundle* bundle);
@@ -47,8 +67,25 @@ namespace ouzel::assets
         void addLoader(std::unique_ptr<Loader> loader);
         void removeLoader(const Loader* loader);
 
+        // throws in debug builds if a different name has the same hash, must be called before the asset is added
+        void checkAssetName(const std::string& name);
+        void addAsset(Bundle::AssetType type, const std::string& name);
+        void updateIndex(Bundle::AssetType type, const AssetId& id);
+        void updateIndex(Bundle::AssetType type, const std::vector<AssetId>& ids);
+        const Bundle* findBundle(Bundle::AssetType type, const AssetId& id) const;
+
         std::vector<const Bundle*> bundles;
-        std::vector<std::unique_ptr<Loader>> loaders;
+        // shared with the asynchronous loads, so that the loaders are not destroyed while they are in use
+        std::vector<std::shared_ptr<Loader>> loaders;
+        std::map<Loader::Type, std::vector<std::shared_ptr<Loader>>> typeLoaders; // the last added loader first
+
+        LoaderPool loaderPool;
+
+        // the first bundle that has the asset of the type
+        std::array<std::unordered_map<AssetId, const Bundle*>, Bundle::assetTypeCount> indices;
+#if !defined(NDEBUG)
+        std::unordered_map<AssetId, std::string> names;
+#endif
     };
 }
 
@@ -9,13 +9,13 @@
 namespace ouzel::assets
 {
     ColladaLoader::ColladaLoader(Cache& initCache):
-        Loader(initCache, Type::skinnedMesh)
+        Loader(initCache, Type::skinnedMesh, {"dae"})
     {
     }
 
     bool ColladaLoader::loadAsset(Bundle& bundle,
                                   const std::string& name,
-                                  const std::vector<std::byte>& data,
+                                  const storage::FileData& data,
                                   bool)
     {
         const auto colladaData = xml::parse(data);
@@ -10,7 +10,7 @@
 namespace ouzel::assets
 {
     CueLoader::CueLoader(Cache& initCache):
-        Loader(initCache, Type::cue)
+        Loader(initCache, Type::cue, {"json"})
     {
     }
 
@@ -112,7 +112,7 @@ namespace ouzel::assets
 
     bool CueLoader::loadAsset(Bundle& bundle,
                               const std::string& name,
-                              const std::vector<std::byte>& data,
+                              const storage::FileData& data,
                               bool)
     {
         audio::SourceDefinition sourceDefinition;
@@ -8,13 +8,13 @@
 namespace ouzel::assets
 {
     GltfLoader::GltfLoader(Cache& initCache):
-        Loader(initCache, Type::skinnedMesh)
+        Loader(initCache, Type::skinnedMesh, {"gltf"})
     {
     }
 
     bool GltfLoader::loadAsset(Bundle& bundle,
                                const std::string& name,
-                               const std::vector<std::byte>& data,
+                               const storage::FileData& data,
                                bool mipmaps)
     {
         const auto d = json::parse(data);
@@ -13,7 +13,7 @@ namespace ouzel::assets
         explicit GltfLoader(Cache& initCache);
         bool loadAsset(Bundle& bundle,
                        const std::string& name,
-                       const std::vector<std::byte>& data,
+                       const storage::FileData& data,
                        bool mipmaps = true) final;
     };
 }
@@ -44,15 +44,35 @@
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        class DecodedImage final: public DecodedAsset
+        {
+        public:
+            explicit DecodedImage(graphics::Image&& initImage):
+                image(std::move(initImage))
+            {
+            }
+
+            graphics::Image image;
+        };
+    }
+
     ImageLoader::ImageLoader(Cache& initCache):
-        Loader(initCache, Type::image)
+        Loader(initCache, Type::image, {"png", "jpg", "jpeg", "bmp", "tga"}, {"\x89PNG", "\xFF\xD8\xFF", "BM"})
     {
     }
 
     bool ImageLoader::loadAsset(Bundle& bundle,
                                 const std::string& name,
-                                const std::vector<std::byte>& data,
+                                const storage::FileData& data,
                                 bool mipmaps)
+    {
+        const auto decoded = decodeAsset(data, mipmaps);
+        return loadDecodedAsset(bundle, name, *decoded, mipmaps);
+    }
+
+    std::unique_ptr<DecodedAsset> ImageLoader::decodeAsset(const storage::FileData& data, bool)
     {
         int width;
         int height;
@@ -152,6 +172,16 @@ namespace ouzel::assets
                                      static_cast<std::uint32_t>(height)),
                               imageData);
 
+        return std::make_unique<DecodedImage>(std::move(image));
+    }
+
+    bool ImageLoader::loadDecodedAsset(Bundle& bundle,
+                                       const std::string& name,
+                                       DecodedAsset& decoded,
+                                       bool mipmaps)
+    {
+        const auto& image = static_cast<DecodedImage&>(decoded).image;
+
         auto texture = std::make_shared<graphics::Texture>(*engine->getGraphics(),
                                                            image.getData(),
                                                            image.getSize(),
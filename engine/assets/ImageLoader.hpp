@@ -13,8 +13,14 @@ namespace ouzel::assets
         explicit ImageLoader(Cache& initCache);
         bool loadAsset(Bundle& bundle,
                        const std::string& name,
-                       const std::vector<std::byte>& data,
+                       const storage::FileData& data,
                        bool mipmaps = true) final;
+
+        std::unique_ptr<DecodedAsset> decodeAsset(const storage::FileData& data, bool mipmaps) final;
+        bool loadDecodedAsset(Bundle& bundle,
+                              const std::string& name,
+                              DecodedAsset& decoded,
+                              bool mipmaps) final;
     };
 }
 
@@ -3,17 +3,39 @@
 #ifndef OUZEL_ASSETS_LOADER_HPP
 #define OUZEL_ASSETS_LOADER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
+#include "../storage/FileData.hpp"
 
 namespace ouzel::assets
 {
     class Cache;
     class Bundle;
 
+    // data decoded on a worker thread by the asynchronous loading
+    class DecodedAsset
+    {
+    public:
+        DecodedAsset() = default;
+        virtual ~DecodedAsset() = default;
+
+        DecodedAsset(const DecodedAsset&) = delete;
+        DecodedAsset& operator=(const DecodedAsset&) = delete;
+
+        DecodedAsset(DecodedAsset&&) = delete;
+        DecodedAsset& operator=(DecodedAsset&&) = delete;
+    };
+
     class Loader
     {
+        friend Bundle;
     public:
         enum class Type
         {
@@ -29,8 +51,13 @@ namespace ouzel::assets
             cue
         };
 
-        Loader(Cache& initCache, Type initType):
-            cache(initCache), type(initType)
+        // the extensions are lowercase and without the dot, the signatures are the bytes at the start of the files
+        Loader(Cache& initCache, Type initType,
+               std::vector<std::string> initExtensions = {},
+               std::vector<std::string> initSignatures = {}):
+            cache(initCache), type(initType),
+            extensions(std::move(initExtensions)),
+            signatures(std::move(initSignatures))
         {
         }
 
@@ -43,15 +70,84 @@ namespace ouzel::assets
         Loader& operator=(Loader&&) = delete;
 
         auto getType() const noexcept { return type; }
+        auto& getExtensions() const noexcept { return extensions; }
+        auto& getSignatures() const noexcept { return signatures; }
+
+        // how well the file matches the formats of the loader, the loaders are tried from the best match
+        enum class Match
+        {
+            none, // the file has a signature of another format
+            other, // the file has another extension
+            any, // the loader does not declare its formats
+            extension,
+            signature
+        };
+
+        Match match(const std::string& extension, const storage::FileData& data) const noexcept
+        {
+            const auto hasSignature = std::any_of(signatures.begin(), signatures.end(), [&data](const std::string& signature) noexcept {
+                return data.size() >= signature.size() &&
+                    std::memcmp(data.data(), signature.data(), signature.size()) == 0;
+            });
+
+            if (hasSignature) return Match::signature;
+            if (std::find(extensions.begin(), extensions.end(), extension) != extensions.end()) return Match::extension;
+            if (!signatures.empty()) return Match::none;
+            return extensions.empty() ? Match::any : Match::other;
+        }
+
+        // number of assets loaded by the loader and the number of assets the loader was tried with but failed to load
+        auto getLoadedCount() const noexcept { return loadedCount.load(std::memory_order_relaxed); }
+        auto getRejectedCount() const noexcept { return rejectedCount.load(std::memory_order_relaxed); }
+
+        // time spent in loadAsset and loadDecodedAsset, including the rejected assets
+        auto getLoadTime() const noexcept
+        {
+            return std::chrono::steady_clock::duration{loadTime.load(std::memory_order_relaxed)};
+        }
+
+        void resetStatistics() noexcept
+        {
+            loadedCount.store(0, std::memory_order_relaxed);
+            rejectedCount.store(0, std::memory_order_relaxed);
+            loadTime.store(0, std::memory_order_relaxed);
+        }
 
         virtual bool loadAsset(Bundle& bundle,
                                const std::string& name,
-                               const std::vector<std::byte>& data,
+                               const storage::FileData& data,
                                bool mipmaps = true) = 0;
 
+        // decodes the data without accessing the bundle, the cache or the graphics, so that it can be called on any
+        // thread, returns null if the loader does all of the work in loadAsset
+        virtual std::unique_ptr<DecodedAsset> decodeAsset(const storage::FileData&, bool)
+        {
+            return nullptr;
+        }
+
+        // creates the asset from the result of decodeAsset
+        virtual bool loadDecodedAsset(Bundle&, const std::string&, DecodedAsset&, bool)
+        {
+            return false;
+        }
+
     protected:
         Cache& cache;
         Type type;
+
+    private:
+        void addLoadTime(std::chrono::steady_clock::duration time, bool loaded) noexcept
+        {
+            (loaded ? loadedCount : rejectedCount).fetch_add(1, std::memory_order_relaxed);
+            loadTime.fetch_add(time.count(), std::memory_order_relaxed);
+        }
+
+        std::vector<std::string> extensions;
+        std::vector<std::string> signatures;
+
+        std::atomic<std::uint64_t> loadedCount{0};
+        std::atomic<std::uint64_t> rejectedCount{0};
+        std::atomic<std::chrono::steady_clock::duration::rep> loadTime{0};
     };
 }
 
@@ -0,0 +1,74 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <thread>
+#include "LoaderPool.hpp"
+#include "../core/Engine.hpp"
+#include "../utils/Log.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        constexpr std::uint32_t maxWorkerCount = 4;
+    }
+
+    LoaderPool::~LoaderPool()
+    {
+        std::unique_lock lock(mutex);
+        running = false;
+        jobs.clear();
+        lock.unlock();
+        condition.notify_all();
+
+        for (auto& worker : workers)
+            if (worker.isJoinable()) worker.join();
+    }
+
+    void LoaderPool::addJob(thread::Task job)
+    {
+#if defined(__EMSCRIPTEN__)
+        job();
+#else
+        std::unique_lock lock(mutex);
+
+        if (workers.empty())
+        {
+            const auto workerCount = std::clamp(std::thread::hardware_concurrency(), 1U, maxWorkerCount);
+
+            workers.reserve(workerCount);
+            for (std::uint32_t i = 0; i < workerCount; ++i)
+                workers.emplace_back(&LoaderPool::workerMain, this);
+        }
+
+        jobs.push_back(std::move(job));
+        lock.unlock();
+        condition.notify_one();
+#endif
+    }
+
+    void LoaderPool::workerMain()
+    {
+        thread::setCurrentThreadName("Asset loader");
+
+        for (;;)
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this]() { return !running || !jobs.empty(); });
+            if (!running) break;
+
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+
+            try
+            {
+                job();
+            }
+            catch (const std::exception& e)
+            {
+                logger.log(Log::Level::error) << e.what();
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_LOADERPOOL_HPP
+#define OUZEL_ASSETS_LOADERPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "../thread/Task.hpp"
+#include "../thread/Thread.hpp"
+
+namespace ouzel::assets
+{
+    // threads that read and decode the assets of all of the asynchronous loads of a cache, started when the first job
+    // is added, the jobs are run in the order they were added
+    class LoaderPool final
+    {
+    public:
+        LoaderPool() = default;
+        ~LoaderPool();
+
+        LoaderPool(const LoaderPool&) = delete;
+        LoaderPool& operator=(const LoaderPool&) = delete;
+
+        LoaderPool(LoaderPool&&) = delete;
+        LoaderPool& operator=(LoaderPool&&) = delete;
+
+        // the jobs that have not started when the pool is destroyed are not run
+        void addJob(thread::Task job);
+
+    private:
+        void workerMain();
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<thread::Task> jobs;
+        bool running = true;
+        std::vector<thread::Thread> workers;
+    };
+}
+
+#endif // OUZEL_ASSETS_LOADERPOOL_HPP
@@ -31,8 +31,8 @@ namespace ouzel::assets
             return static_cast<std::uint8_t>(c) <= 0x1F;
         }
 
-        void skipWhitespaces(std::vector<std::byte>::const_iterator& iterator,
-                             std::vector<std::byte>::const_iterator end)
+        void skipWhitespaces(const std::byte*& iterator,
+                             const std::byte* end)
         {
             while (iterator != end)
                 if (isWhitespace(*iterator))
@@ -41,8 +41,8 @@ namespace ouzel::assets
                     break;
         }
 
-        void skipLine(std::vector<std::byte>::const_iterator& iterator,
-                      std::vector<std::byte>::const_iterator end)
+        void skipLine(const std::byte*& iterator,
+                      const std::byte* end)
         {
             while (iterator != end)
             {
@@ -56,8 +56,8 @@ namespace ouzel::assets
             }
         }
 
-        std::string parseString(std::vector<std::byte>::const_iterator& iterator,
-                                std::vector<std::byte>::const_iterator end)
+        std::string parseString(const std::byte*& iterator,
+                                const std::byte* end)
         {
             std::string result;
 
@@ -74,8 +74,8 @@ namespace ouzel::assets
             return result;
         }
 
-        std::int32_t parseInt32(std::vector<std::byte>::const_iterator& iterator,
-                                std::vector<std::byte>::const_iterator end)
+        std::int32_t parseInt32(const std::byte*& iterator,
+                                const std::byte* end)
         {
             std::string value;
             std::uint32_t length = 1;
@@ -102,8 +102,8 @@ namespace ouzel::assets
             return std::stoi(value);
         }
 
-        float parseFloat(std::vector<std::byte>::const_iterator& iterator,
-                         std::vector<std::byte>::const_iterator end)
+        float parseFloat(const std::byte*& iterator,
+                         const std::byte* end)
         {
             std::string value;
             std::uint32_t length = 1;
@@ -174,8 +174,8 @@ namespace ouzel::assets
             return std::stof(value);
         }
 
-        bool parseToken(const std::vector<std::byte>& str,
-                        std::vector<std::byte>::const_iterator& iterator,
+        bool parseToken(const storage::FileData& str,
+                        const std::byte*& iterator,
                         char token)
         {
             if (iterator == str.end() || static_cast<char>(*iterator) != token) return false;
@@ -187,13 +187,13 @@ namespace ouzel::assets
     }
 
     ObjLoader::ObjLoader(Cache& initCache):
-        Loader(initCache, Type::staticMesh)
+        Loader(initCache, Type::staticMesh, {"obj"})
     {
     }
 
     bool ObjLoader::loadAsset(Bundle& bundle,
                               const std::string& name,
-                              const std::vector<std::byte>& data,
+                              const storage::FileData& data,
                               bool mipmaps)
     {
         std::string objectName = name;
@@ -9,13 +9,13 @@
 namespace ouzel::assets
 {
     ParticleSystemLoader::ParticleSystemLoader(Cache& initCache):
-        Loader(initCache, Type::particleSystem)
+        Loader(initCache, Type::particleSystem, {"json"})
     {
     }
 
     bool ParticleSystemLoader::loadAsset(Bundle& bundle,
                                          const std::string& name,
-                                         const std::vector<std::byte>& data,
+                                         const storage::FileData& data,
                                          bool mipmaps)
     {
         scene::ParticleSystemData particleSystemData;
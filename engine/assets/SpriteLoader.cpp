@@ -10,13 +10,13 @@
 namespace ouzel::assets
 {
     SpriteLoader::SpriteLoader(Cache& initCache):
-        Loader(initCache, Type::sprite)
+        Loader(initCache, Type::sprite, {"json"})
     {
     }
 
     bool SpriteLoader::loadAsset(Bundle& bundle,
                                  const std::string& name,
-                                 const std::vector<std::byte>& data,
+                                 const storage::FileData& data,
                                  bool mipmaps)
     {
         scene::SpriteData spriteData;
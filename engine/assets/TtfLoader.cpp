@@ -8,13 +8,13 @@
 namespace ouzel::assets
 {
     TtfLoader::TtfLoader(Cache& initCache):
-        Loader(initCache, Type::font)
+        Loader(initCache, Type::font, {"ttf", "otf"}, {std::string("\0\1\0\0", 4), "OTTO", "true"})
     {
     }
 
     bool TtfLoader::loadAsset(Bundle& bundle,
                               const std::string& name,
-                              const std::vector<std::byte>& data,
+                              const storage::FileData& data,
                               bool mipmaps)
     {
         try
@@ -8,13 +8,13 @@
 namespace ouzel::assets
 {
     VorbisLoader::VorbisLoader(Cache& initCache):
-        Loader(initCache, Type::sound)
+        Loader(initCache, Type::sound, {"ogg", "oga"}, {"OggS"})
     {
     }
 
     bool VorbisLoader::loadAsset(Bundle& bundle,
                                  const std::string& name,
-                                 const std::vector<std::byte>& data,
+                                 const storage::FileData& data,
                                  bool)
     {
         try
@@ -15,13 +15,13 @@ namespace
 namespace ouzel::assets
 {
     WaveLoader::WaveLoader(Cache& initCache):
-        Loader(initCache, Type::sound)
+        Loader(initCache, Type::sound, {"wav", "wave"}, {"RIFF"})
     {
     }
 
     bool WaveLoader::loadAsset(Bundle& bundle,
                                const std::string& name,
-                               const std::vector<std::byte>& data,
+                               const storage::FileData& data,
                                bool)
     {
         try
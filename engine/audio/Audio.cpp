@@ -1,6 +1,9 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
 #include "../core/Setup.h"
 #include "Audio.hpp"
 #include "AudioDevice.hpp"
@@ -146,24 +149,134 @@ namespace ouzel::audio
     }
 
     Audio::Audio(Driver driver, const Settings& settings):
-        device(createAudioDevice(driver,
+        device(createAudioDevice(settings.offline ? Driver::empty : driver,
                                  std::bind(&Audio::getSamples, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
                                  settings)),
-        mixer(device->getBufferSize(), device->getChannels(),
-              std::bind(&Audio::eventCallback, this, std::placeholders::_1)),
+        pcmCache(settings.pcmCacheSize, settings.pcmCacheMaxSoundSize,
+                 settings.pcmCacheInt16 ? PcmCache::Format::int16 : PcmCache::Format::float32),
+        mixer(device->getBufferSize(), device->getChannels(), device->getSampleRate(),
+              std::max(settings.bufferCount, 2U),
+              settings.resamplerQuality,
+              settings.maxVoices,
+              settings.audibilityThreshold,
+              settings.mixerThreads,
+              std::bind(&Audio::eventCallback, this, std::placeholders::_1),
+              settings.offline),
+        preresample(settings.preresample),
         masterMix(*this),
         rootNode(*this) // mixer.getRootObjectId()
     {
         addCommand(std::make_unique<mixer::SetMasterBusCommand>(masterMix.getBusId()));
-        device->start();
+
+        if (!settings.offline)
+            device->start();
+    }
+
+    void Audio::render(std::uint32_t frames, std::vector<float>& samples)
+    {
+        // the mixer thread of a real-time mixer is the only consumer of the command queue
+        if (!mixer.isOffline())
+            throw std::runtime_error("Only offline mixers can render");
+
+        // all of the pending commands are executed before the first frame, so that the result is deterministic
+        do
+        {
+            mixer.submitCommandBuffer(commandBuffer);
+            mixer.process();
+        }
+        while (!commandBuffer.isEmpty());
+
+        mixer.render(frames, samples);
+    }
+
+    namespace
+    {
+        void writeUInt16(std::ofstream& file, std::uint16_t value)
+        {
+            const char bytes[] = {
+                static_cast<char>(value & 0xFF),
+                static_cast<char>((value >> 8) & 0xFF)
+            };
+            file.write(bytes, sizeof(bytes));
+        }
+
+        void writeUInt32(std::ofstream& file, std::uint32_t value)
+        {
+            const char bytes[] = {
+                static_cast<char>(value & 0xFF),
+                static_cast<char>((value >> 8) & 0xFF),
+                static_cast<char>((value >> 16) & 0xFF),
+                static_cast<char>((value >> 24) & 0xFF)
+            };
+            file.write(bytes, sizeof(bytes));
+        }
+    }
+
+    void Audio::render(std::uint32_t frames, const storage::Path& path)
+    {
+        std::vector<float> samples;
+        render(frames, samples);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open file " + std::string(path));
+
+        constexpr std::uint16_t waveFormatIeeeFloat = 3;
+        const auto channels = device->getChannels();
+        const auto sampleRate = device->getSampleRate();
+        const auto dataSize = static_cast<std::uint32_t>(samples.size() * sizeof(float));
+
+        file.write("RIFF", 4);
+        writeUInt32(file, 4 + 8 + 16 + 8 + dataSize);
+        file.write("WAVE", 4);
+
+        file.write("fmt ", 4);
+        writeUInt32(file, 16);
+        writeUInt16(file, waveFormatIeeeFloat);
+        writeUInt16(file, static_cast<std::uint16_t>(channels));
+        writeUInt32(file, sampleRate);
+        writeUInt32(file, sampleRate * channels * static_cast<std::uint32_t>(sizeof(float)));
+        writeUInt16(file, static_cast<std::uint16_t>(channels * sizeof(float)));
+        writeUInt16(file, 32);
+
+        file.write("data", 4);
+        writeUInt32(file, dataSize);
+
+        for (const auto sample : samples)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &sample, sizeof(bits));
+            writeUInt32(file, bits);
+        }
+
+        if (!file)
+            throw std::runtime_error("Failed to write file " + std::string(path));
     }
 
     void Audio::update()
     {
-        // TODO: handle events from the audio device
+        if (const auto count = starvationCount.exchange(0, std::memory_order_relaxed))
+            logger.log(Log::Level::warning) << "Audio mixer could not keep up with the device " << count << " time(s)";
 
-        mixer.submitCommandBuffer(std::move(commandBuffer));
-        commandBuffer = mixer::CommandBuffer();
+        mixer.submitCommandBuffer(commandBuffer);
+    }
+
+    Audio::Statistics Audio::getStatistics() const
+    {
+        Statistics result;
+        result.mixer = mixer.getStatistics();
+        result.deviceUnderrunCount = device->getUnderrunCount();
+
+        const auto sampleRate = static_cast<float>(device->getSampleRate());
+        result.latency = static_cast<float>(result.mixer.bufferedFrames + device->getBufferSize()) / sampleRate;
+        result.targetLatency = static_cast<float>(result.mixer.targetBufferedFrames + device->getBufferSize()) / sampleRate;
+        return result;
+    }
+
+    void Audio::resetStatistics()
+    {
+        mixer.resetStatistics();
+        device->resetUnderrunCount();
     }
 
     void Audio::deleteObject(mixer::Mixer::ObjectId objectId)
@@ -210,7 +323,10 @@ namespace ouzel::audio
         mixer.getSamples(frames, channels, sampleRate, samples);
     }
 
-    void Audio::eventCallback(const mixer::Mixer::Event&)
+    void Audio::eventCallback(const mixer::Mixer::Event& event)
     {
+        // called from the audio device thread
+        if (event.type == mixer::Mixer::Event::Type::starvation)
+            starvationCount.fetch_add(1, std::memory_order_relaxed);
     }
 }
@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_AUDIO_HPP
 #define OUZEL_AUDIO_AUDIO_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -12,12 +13,15 @@
 #include "Driver.hpp"
 #include "Mix.hpp"
 #include "Node.hpp"
+#include "PcmCache.hpp"
 #include "Settings.hpp"
+#include "Streamer.hpp"
 #include "mixer/Commands.hpp"
 #include "mixer/Processor.hpp"
 #include "mixer/Mixer.hpp"
 #include "../math/Quaternion.hpp"
 #include "../math/Vector.hpp"
+#include "../storage/Path.hpp"
 
 namespace ouzel::audio
 {
@@ -33,10 +37,33 @@ namespace ouzel::audio
 
         auto getDevice() const noexcept { return device.get(); }
         mixer::Mixer& getMixer() { return mixer; }
+        Streamer& getStreamer() { return streamer; }
+        PcmCache& getPcmCache() { return pcmCache; }
+
+        bool isPreresampleEnabled() const noexcept { return preresample; }
         Mix& getMasterMix() { return masterMix; }
 
         void update();
 
+        bool isOffline() const noexcept { return mixer.isOffline(); }
+
+        struct Statistics final
+        {
+            mixer::Mixer::Statistics mixer;
+            std::uint64_t deviceUnderrunCount = 0;
+            float latency = 0.0F; // seconds of the samples mixed ahead and the buffer of the device
+            float targetLatency = 0.0F; // configured by the buffer size and the buffer count
+        };
+
+        // can be called from any thread, the processing times of the buses and processors are in getMixer().getTimings()
+        Statistics getStatistics() const;
+        void resetStatistics();
+
+        // submits the pending commands and renders interleaved samples as fast as possible, only in the offline mode
+        void render(std::uint32_t frames, std::vector<float>& samples);
+        // renders to a 32-bit float WAV file
+        void render(std::uint32_t frames, const storage::Path& path);
+
         void addCommand(std::unique_ptr<mixer::Command> command)
         {
             commandBuffer.pushCommand(std::move(command));
@@ -57,8 +84,12 @@ namespace ouzel::audio
         void eventCallback(const mixer::Mixer::Event& event);
 
         std::unique_ptr<AudioDevice> device;
+        PcmCache pcmCache; // must outlive the data of the mixer
+        Streamer streamer; // must outlive the streams of the mixer
         mixer::Mixer mixer;
         mixer::CommandBuffer commandBuffer;
+        std::atomic<std::uint32_t> starvationCount{0};
+        bool preresample = false;
         Mix masterMix;
         Node rootNode;
     };
@@ -28,28 +28,14 @@ namespace ouzel::audio
             {
                 result.resize(frames * channels * sizeof(std::int16_t));
                 auto resultPtr = reinterpret_cast<std::int16_t*>(result.data());
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                {
-                    float* bufferChannel = &buffer[channel * frames];
-
-                    for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        resultPtr[frame * channels + channel] = static_cast<std::int16_t>(bufferChannel[frame] * 32767.0F);
-                }
+                mixer::interleaveInt16(resultPtr, buffer.data(), channels, frames, frames, ditherState);
                 break;
             }
             case SampleFormat::float32:
             {
                 result.resize(frames * channels * sizeof(float));
                 auto resultPtr = reinterpret_cast<float*>(result.data());
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                {
-                    float* bufferChannel = &buffer[channel * frames];
-
-                    for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        resultPtr[frame * channels + channel] = bufferChannel[frame];
-                }
+                mixer::interleave(resultPtr, buffer.data(), channels, frames, frames);
                 break;
             }
             default:
@@ -3,11 +3,14 @@
 #ifndef OUZEL_AUDIO_AUDIODEVICE_HPP
 #define OUZEL_AUDIO_AUDIODEVICE_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include "Driver.hpp"
 #include "SampleFormat.hpp"
 #include "Settings.hpp"
+#include "mixer/Kernels.hpp"
 
 namespace ouzel::audio
 {
@@ -36,6 +39,10 @@ namespace ouzel::audio
         auto getSampleRate() const noexcept { return sampleRate; }
         auto getChannels() const noexcept { return channels; }
 
+        // number of times the device ran out of samples, only reported by the drivers that can detect it
+        auto getUnderrunCount() const noexcept { return underrunCount.load(std::memory_order_relaxed); }
+        void resetUnderrunCount() noexcept { underrunCount.store(0, std::memory_order_relaxed); }
+
         virtual void start() = 0;
         virtual void stop() = 0;
 
@@ -44,6 +51,7 @@ namespace ouzel::audio
 
     protected:
         void getData(std::uint32_t frames, std::vector<std::uint8_t>& result);
+        void reportUnderrun() noexcept { underrunCount.fetch_add(1, std::memory_order_relaxed); }
 
         std::uint16_t apiMajorVersion = 0;
         std::uint16_t apiMinorVersion = 0;
@@ -56,6 +64,8 @@ namespace ouzel::audio
     private:
         std::function<void(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples)> dataGetter;
         std::vector<float> buffer;
+        mixer::DitherState ditherState = mixer::initialDitherState;
+        std::atomic<std::uint64_t> underrunCount{0};
     };
 }
 
@@ -1,12 +1,26 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <stdexcept>
 #include "Effects.hpp"
 #include "Audio.hpp"
+#include "Sound.hpp"
+#include "mixer/Convolver.hpp"
+#include "mixer/Data.hpp"
+#include "mixer/DelayLine.hpp"
+#include "mixer/Kernels.hpp"
+#include "mixer/PhaseVocoder.hpp"
+#include "mixer/Resampler.hpp"
+#include "mixer/Spatializer.hpp"
+#include "mixer/Stream.hpp"
+#include "../assets/Cache.hpp"
+#include "../core/Engine.hpp"
 #include "../scene/Actor.hpp"
 #include "../math/MathUtils.hpp"
-#include "smbPitchShift.hpp"
+#include "../thread/Futex.hpp"
+#include "../thread/Thread.hpp"
 
 namespace ouzel::audio
 {
@@ -18,42 +32,40 @@ namespace ouzel::audio
         {
         }
 
-        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) final
+        void prepare(std::uint32_t, std::uint32_t channels, std::uint32_t sampleRate) final
         {
-            const auto delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
-            const auto bufferFrames = frames + delayFrames;
+            delayLines.resize(channels);
+            preparedSampleRate = sampleRate;
+            resizeDelayLines();
+        }
 
-            buffer.resize(bufferFrames * channels);
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     mixer::SampleView samples) final
+        {
+            if (delayLines.size() != channels || preparedSampleRate != sampleRate)
+                prepare(frames, channels, sampleRate);
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
-            {
-                float* bufferChannel = &buffer[channel * bufferFrames];
-                float* outputChannel = &samples[channel * frames];
-
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    bufferChannel[frame + delayFrames] += outputChannel[frame];
-
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    outputChannel[frame] = bufferChannel[frame];
-
-                // erase frames from beginning
-                for (std::uint32_t frame = 0; frame < bufferFrames - frames; ++frame)
-                    bufferChannel[frame] = bufferChannel[frame + frames];
-
-                for (std::uint32_t frame = bufferFrames - frames; frame < bufferFrames; ++frame)
-                    bufferChannel[frame] = 0.0F;
-            }
+                delayLines[channel].delay(&samples[channel * frames], frames);
         }
 
         void setDelay(float newDelay)
         {
             delay = newDelay;
+            resizeDelayLines();
         }
 
     private:
+        void resizeDelayLines()
+        {
+            const auto delayFrames = static_cast<std::size_t>(delay * preparedSampleRate);
+            for (auto& delayLine : delayLines)
+                if (delayLine.size() != delayFrames) delayLine.resize(delayFrames);
+        }
+
         float delay = 0.0F;
-        std::vector<float> buffer;
+        std::uint32_t preparedSampleRate = 0;
+        std::vector<mixer::DelayLine> delayLines;
     };
 
     Delay::Delay(Audio& initAudio, float initDelay):
@@ -89,10 +101,14 @@ namespace ouzel::audio
         }
 
         void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>& samples) final
+                     mixer::SampleView samples) final
+        {
+            mixer::scale(samples.data(), gainFactor, samples.size());
+        }
+
+        float getGain(const Vector3F&) const final
         {
-            for (float& sample : samples)
-                sample *= gainFactor;
+            return gainFactor;
         }
 
         void setGain(float newGain)
@@ -132,45 +148,123 @@ namespace ouzel::audio
     class PannerProcessor final: public mixer::Processor
     {
     public:
-        PannerProcessor()
+        explicit PannerProcessor(mixer::Spatializer& initSpatializer):
+            spatializer(initSpatializer)
         {
         }
 
-        void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>&) final
+        void detach() final
         {
+            if (registered)
+            {
+                spatializer.removeEmitter(emitter);
+                registered = false;
+            }
+
+            mixer::Processor::detach();
+        }
+
+        void prepare(std::uint32_t, std::uint32_t, std::uint32_t) final
+        {
+            if (!registered)
+            {
+                emitter = spatializer.addEmitter(this);
+                registered = true;
+                initialized = false;
+                spatializer.setPosition(emitter, position);
+                spatializer.setAttenuation(emitter, rolloffFactor, minDistance, maxDistance);
+            }
+        }
+
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t,
+                     mixer::SampleView samples) final
+        {
+            if (!registered) return;
+
+            // the gains of all of the emitters are calculated by the mixer before the block is mixed
+            const auto attenuation = spatializer.getAttenuation(emitter);
+            const auto leftGain = attenuation * spatializer.getLeftGain(emitter);
+            const auto rightGain = attenuation * spatializer.getRightGain(emitter);
+
+            if (!initialized)
+            {
+                currentAttenuation = attenuation;
+                currentLeftGain = leftGain;
+                currentRightGain = rightGain;
+                initialized = true;
+            }
+
+            // the gains are interpolated across the block to avoid zipper noise of moving emitters, only the front
+            // left and right channels are panned, the rest are attenuated
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+            {
+                float* channelSamples = &samples[channel * frames];
+
+                if (channels > 1 && channel == 0)
+                    mixer::scaleRamp(channelSamples, currentLeftGain, leftGain, frames);
+                else if (channels > 1 && channel == 1)
+                    mixer::scaleRamp(channelSamples, currentRightGain, rightGain, frames);
+                else
+                    mixer::scaleRamp(channelSamples, currentAttenuation, attenuation, frames);
+            }
+
+            currentAttenuation = attenuation;
+            currentLeftGain = leftGain;
+            currentRightGain = rightGain;
+        }
+
+        float getGain(const Vector3F& listenerPosition) const final
+        {
+            // inverse distance attenuation clamped to the minimum and maximum distance
+            const auto distance = std::min(position.distance(listenerPosition), maxDistance);
+            if (distance <= minDistance) return 1.0F;
+
+            return minDistance / (minDistance + rolloffFactor * (distance - minDistance));
         }
 
         void setPosition(const Vector3F& newPosition)
         {
             position = newPosition;
+            if (registered) spatializer.setPosition(emitter, position);
         }
 
         void setRolloffFactor(float newRolloffFactor)
         {
             rolloffFactor = newRolloffFactor;
+            if (registered) spatializer.setAttenuation(emitter, rolloffFactor, minDistance, maxDistance);
         }
 
         void setMinDistance(float newMinDistance)
         {
             minDistance = newMinDistance;
+            if (registered) spatializer.setAttenuation(emitter, rolloffFactor, minDistance, maxDistance);
         }
 
         void setMaxDistance(float newMaxDistance)
         {
             maxDistance = newMaxDistance;
+            if (registered) spatializer.setAttenuation(emitter, rolloffFactor, minDistance, maxDistance);
         }
 
     private:
+        mixer::Spatializer& spatializer;
+        std::uint32_t emitter = 0;
+        bool registered = false;
+        bool initialized = false;
+
         Vector3F position;
         float rolloffFactor = 1.0F;
         float minDistance = 1.0F;
         float maxDistance = FLT_MAX;
+
+        float currentAttenuation = 1.0F;
+        float currentLeftGain = 1.0F;
+        float currentRightGain = 1.0F;
     };
 
     Panner::Panner(Audio& initAudio):
         Effect(initAudio,
-               initAudio.initProcessor(std::make_unique<PannerProcessor>()))
+               initAudio.initProcessor(std::make_unique<PannerProcessor>(initAudio.getMixer().getSpatializer())))
     {
     }
 
@@ -225,38 +319,44 @@ namespace ouzel::audio
         constexpr float maxPitch = 2.0F;
     }
 
-    class PitchScaleProcessor final: public mixer::Processor
+    // used by both PitchScale and PitchShift, ratio of 2 shifts the pitch by an octave up
+    class PitchProcessor final: public mixer::Processor
     {
     public:
-        explicit PitchScaleProcessor(float initScale):
-            scale(std::clamp(initScale, minPitch, maxPitch))
+        explicit PitchProcessor(float initRatio):
+            ratio(std::clamp(initRatio, minPitch, maxPitch))
         {
         }
 
+        void prepare(std::uint32_t, std::uint32_t channels, std::uint32_t) final
+        {
+            phaseVocoders.resize(channels);
+        }
+
         void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) final
+                     mixer::SampleView samples) final
         {
-            pitchShift.resize(channels);
+            if (phaseVocoders.size() != channels)
+                prepare(frames, channels, sampleRate);
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
-                pitchShift[channel].process(scale, frames, sampleRate,
-                                            &samples[channel * frames],
-                                            &samples[channel * frames]);
+                phaseVocoders[channel].process(ratio, &samples[channel * frames],
+                                               &samples[channel * frames], frames);
         }
 
-        void setScale(float newScale)
+        void setRatio(float newRatio)
         {
-            scale = std::clamp(newScale, minPitch, maxPitch);
+            ratio = std::clamp(newRatio, minPitch, maxPitch);
         }
 
     private:
-        float scale = 1.0f;
-        std::vector<smb::PitchShift<1024, 4>> pitchShift;
+        float ratio = 1.0f;
+        std::vector<mixer::PhaseVocoder> phaseVocoders;
     };
 
     PitchScale::PitchScale(Audio& initAudio, float initScale):
         Effect(initAudio,
-               initAudio.initProcessor(std::make_unique<PitchScaleProcessor>(initScale))),
+               initAudio.initProcessor(std::make_unique<PitchProcessor>(initScale))),
         scale(initScale)
     {
     }
@@ -266,8 +366,8 @@ namespace ouzel::audio
         scale = newScale;
 
         audio.updateProcessor(processorId, [newScale](mixer::Object* node) {
-            auto pitchScaleProcessor = static_cast<PitchScaleProcessor*>(node);
-            pitchScaleProcessor->setScale(newScale);
+            auto pitchProcessor = static_cast<PitchProcessor*>(node);
+            pitchProcessor->setRatio(newScale);
         });
     }
 
@@ -277,32 +377,9 @@ namespace ouzel::audio
         // TODO: pass to processor
     }
 
-    class PitchShiftProcessor final: public mixer::Processor
-    {
-    public:
-        explicit PitchShiftProcessor(float initShift):
-            shift(initShift)
-        {
-        }
-
-        void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>&) final
-        {
-            // TODO: implement
-        }
-
-        void setShift(float newShift)
-        {
-            shift = newShift;
-        }
-
-    private:
-        float shift = 1.0f;
-    };
-
     PitchShift::PitchShift(Audio& initAudio, float initShift):
         Effect(initAudio,
-               initAudio.initProcessor(std::make_unique<PitchShiftProcessor>(initShift))),
+               initAudio.initProcessor(std::make_unique<PitchProcessor>(initShift))),
         shift(initShift)
     {
     }
@@ -312,8 +389,8 @@ namespace ouzel::audio
         shift = newShift;
 
         audio.updateProcessor(processorId, [newShift](mixer::Object* node) {
-            auto pitchShiftProcessor = static_cast<PitchShiftProcessor*>(node);
-            pitchShiftProcessor->setShift(newShift);
+            auto pitchProcessor = static_cast<PitchProcessor*>(node);
+            pitchProcessor->setRatio(newShift);
         });
     }
 
@@ -331,39 +408,32 @@ namespace ouzel::audio
         {
         }
 
-        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) final
+        void prepare(std::uint32_t, std::uint32_t channels, std::uint32_t sampleRate) final
         {
-            const auto delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
-            const auto bufferFrames = frames + delayFrames;
-
-            buffers.resize(channels);
-
-            for (std::uint32_t channel = 0; channel < channels; ++channel)
-            {
-                std::vector<float>& buffer = buffers[channel];
-                buffer.resize(bufferFrames);
-
-                float* outputChannel = &samples[channel * frames];
+            const auto delayFrames = static_cast<std::size_t>(delay * sampleRate);
 
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    buffer[frame] += outputChannel[frame];
+            delayLines.resize(channels);
+            for (auto& delayLine : delayLines)
+                delayLine.resize(delayFrames);
 
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    buffer[frame + delayFrames] += buffer[frame] * decay;
+            preparedSampleRate = sampleRate;
+        }
 
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    outputChannel[frame] = buffer[frame];
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     mixer::SampleView samples) final
+        {
+            if (delayLines.size() != channels || preparedSampleRate != sampleRate)
+                prepare(frames, channels, sampleRate);
 
-                // erase frames from beginning
-                buffer.erase(buffer.begin(), buffer.begin() + frames);
-            }
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                delayLines[channel].feedback(&samples[channel * frames], frames, decay);
         }
 
     private:
         float delay = 0.1F;
         float decay = 0.5F;
-        std::vector<std::vector<float>> buffers;
+        std::uint32_t preparedSampleRate = 0;
+        std::vector<mixer::DelayLine> delayLines;
     };
 
     Reverb::Reverb(Audio& initAudio, float initDelay, float initDecay):
@@ -374,33 +444,430 @@ namespace ouzel::audio
     {
     }
 
-    class LowPassProcessor final: public mixer::Processor
+    class ConvolutionReverbProcessor final: public mixer::Processor
     {
     public:
-        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) final
+        ConvolutionReverbProcessor(std::shared_ptr<const mixer::ImpulseResponse> initImpulseResponse,
+                                   float initWet, bool initAsynchronous):
+            impulseResponse(std::move(initImpulseResponse)),
+            wet(initWet),
+            asynchronous(initAsynchronous)
+        {
+        }
+
+        ~ConvolutionReverbProcessor() override
+        {
+            stopWorker();
+        }
+
+        void prepare(std::uint32_t, std::uint32_t channels, std::uint32_t) final
+        {
+            stopWorker();
+
+            convolver.prepare(impulseResponse, channels);
+
+            const auto blockSamples = channels * impulseResponse->getBlockSize();
+            inputBlock.assign(blockSamples, 0.0F);
+            outputBlock.assign(blockSamples, 0.0F);
+            jobInput.assign(blockSamples, 0.0F);
+            jobOutput.assign(blockSamples, 0.0F);
+            blockPosition = 0;
+
+            if (asynchronous)
+            {
+                running = true;
+                jobPending = false;
+                worker = thread::Thread(&ConvolutionReverbProcessor::workerMain, this);
+            }
+        }
+
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t,
+                     mixer::SampleView samples) final
+        {
+            // the processor is prepared when it is added to the bus, so this does not happen while mixing
+            if (convolver.getChannels() != channels) return;
+
+            // the input is collected into blocks of the impulse response block size, so the reverb is delayed
+            // by one block
+            const auto blockSize = convolver.getBlockSize();
+
+            for (std::uint32_t frame = 0; frame < frames;)
+            {
+                const auto count = std::min(frames - frame, blockSize - blockPosition);
+
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    float* channelSamples = &samples[channel * frames + frame];
+                    std::copy(channelSamples, channelSamples + count, &inputBlock[channel * blockSize + blockPosition]);
+                    mixer::scaleAccumulate(channelSamples, &outputBlock[channel * blockSize + blockPosition], wet, count);
+                }
+
+                frame += count;
+                blockPosition += count;
+
+                if (blockPosition == blockSize)
+                {
+                    processBlock();
+                    blockPosition = 0;
+                }
+            }
+        }
+
+        void setWet(float newWet)
         {
+            wet = newWet;
+        }
+
+    private:
+        void processBlock()
+        {
+            if (!asynchronous)
+            {
+                convolver.process(inputBlock.data(), outputBlock.data());
+                return;
+            }
+
+            // the mixer thread does not wait for the worker, if it has not finished the previous block, the block
+            // is skipped and the next block gets no reverb
+            if (jobPending.load(std::memory_order_acquire))
+            {
+                std::fill(outputBlock.begin(), outputBlock.end(), 0.0F);
+                return;
+            }
+
+            // take the output of the block given to the worker the last time and give it the new block
+            std::swap(inputBlock, jobInput);
+            std::swap(outputBlock, jobOutput);
+            jobPending.store(true, std::memory_order_release);
+            jobGeneration.increment();
+        }
+
+        void workerMain()
+        {
+            thread::setCurrentThreadName("Convolution");
+
+            auto generation = jobGeneration.load();
+
+            for (;;)
+            {
+                generation = jobGeneration.wait(generation);
+                if (!running.load(std::memory_order_acquire)) break;
+                if (!jobPending.load(std::memory_order_acquire)) continue;
+
+                convolver.process(jobInput.data(), jobOutput.data());
+
+                jobPending.store(false, std::memory_order_release);
+            }
+        }
+
+        void stopWorker()
+        {
+            running.store(false, std::memory_order_release);
+            jobGeneration.increment();
+
+            if (worker.isJoinable()) worker.join();
         }
+
+        std::shared_ptr<const mixer::ImpulseResponse> impulseResponse;
+        float wet = 1.0F;
+        bool asynchronous = false;
+        mixer::Convolver convolver;
+        std::vector<float> inputBlock;
+        std::vector<float> outputBlock;
+        std::uint32_t blockPosition = 0;
+
+        // the block that the worker is convolving, owned by the worker while the job is pending
+        std::vector<float> jobInput;
+        std::vector<float> jobOutput;
+        std::atomic_bool jobPending{false};
+        std::atomic_bool running{false};
+        thread::Futex jobGeneration;
+        thread::Thread worker;
     };
 
-    LowPass::LowPass(Audio& initAudio):
+    namespace
+    {
+        constexpr std::uint32_t maxImpulseResponseLength = 20; // seconds, in case the sound never ends
+        constexpr std::uint32_t impulseResponseReadFrames = 4096;
+
+        std::shared_ptr<const mixer::ImpulseResponse> createImpulseResponse(Audio& audio, const Sound& sound)
+        {
+            auto& data = sound.getData();
+            const auto channels = data.getChannels();
+            if (!channels) throw std::runtime_error("Impulse response has no channels");
+            if (data.isStreamed()) throw std::runtime_error("Impulse response can not be streamed");
+
+            // decode the whole sound
+            auto stream = data.createStream();
+            stream->play();
+
+            std::vector<std::vector<float>> channelSamples(channels);
+            std::vector<float> block;
+            std::uint32_t frames = 0;
+            const std::uint32_t maxFrames = data.getSampleRate() * maxImpulseResponseLength;
+
+            while (stream->isPlaying() && frames < maxFrames)
+            {
+                stream->getSamples(impulseResponseReadFrames, block);
+
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    channelSamples[channel].insert(channelSamples[channel].end(),
+                                                   block.begin() + channel * impulseResponseReadFrames,
+                                                   block.begin() + (channel + 1) * impulseResponseReadFrames);
+
+                frames += impulseResponseReadFrames;
+            }
+
+            frames = std::min(frames, maxFrames);
+
+            // drop the trailing silence, which includes the padding of the last read, so that it is not convolved
+            const auto isSilent = [&channelSamples](std::uint32_t frame) noexcept {
+                return std::all_of(channelSamples.begin(), channelSamples.end(), [frame](const auto& samplesOfChannel) noexcept {
+                    return samplesOfChannel[frame] == 0.0F;
+                });
+            };
+
+            while (frames > 1 && isSilent(frames - 1)) --frames;
+
+            std::vector<float> samples;
+            samples.reserve(channels * frames);
+            for (const auto& samplesOfChannel : channelSamples)
+                samples.insert(samples.end(), samplesOfChannel.begin(), samplesOfChannel.begin() + frames);
+
+            // resample to the sample rate of the buses
+            const auto sampleRate = audio.getDevice()->getSampleRate();
+            if (data.getSampleRate() != sampleRate)
+            {
+                const auto resampledFrames = static_cast<std::uint32_t>(static_cast<std::uint64_t>(frames) * sampleRate /
+                                                                        data.getSampleRate());
+
+                mixer::Resampler resampler(mixer::Resampler::Quality::sinc);
+                const auto neededFrames = resampler.getSourceFrames(channels, data.getSampleRate(), sampleRate, resampledFrames);
+
+                // pad the end with silence for the frames needed by the filter
+                std::vector<float> sourceSamples(neededFrames * channels, 0.0F);
+                const auto copyFrames = std::min(frames, neededFrames);
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    std::copy(samples.begin() + channel * frames,
+                              samples.begin() + channel * frames + copyFrames,
+                              sourceSamples.begin() + channel * neededFrames);
+
+                resampler.resample(sourceSamples, neededFrames, resampledFrames, samples);
+            }
+
+            // partitions of at least the buffer size, so that a buffer is convolved at most once
+            std::uint32_t blockSize = 64;
+            while (blockSize < audio.getDevice()->getBufferSize()) blockSize *= 2;
+
+            return std::make_shared<mixer::ImpulseResponse>(blockSize, channels, samples);
+        }
+
+        const Sound& getCachedSound(const std::string& name)
+        {
+            if (const auto sound = engine->getCache().getSound(name))
+                return *sound;
+
+            throw std::runtime_error("Sound " + name + " not found");
+        }
+    }
+
+    ConvolutionReverb::ConvolutionReverb(Audio& initAudio, const Sound& impulseResponse,
+                                         float initWet, bool asynchronous):
         Effect(initAudio,
-               initAudio.initProcessor(std::unique_ptr<LowPassProcessor>()))
+               initAudio.initProcessor(std::make_unique<ConvolutionReverbProcessor>(createImpulseResponse(initAudio, impulseResponse),
+                                                                                    initWet, asynchronous))),
+        wet(initWet)
+    {
+    }
+
+    ConvolutionReverb::ConvolutionReverb(Audio& initAudio, const std::string& impulseResponse,
+                                         float initWet, bool asynchronous):
+        ConvolutionReverb(initAudio, getCachedSound(impulseResponse), initWet, asynchronous)
     {
     }
 
-    class HighPassProcessor final: public mixer::Processor
+    void ConvolutionReverb::setWet(float newWet)
+    {
+        wet = newWet;
+
+        audio.updateProcessor(processorId, [newWet](mixer::Object* node) {
+            auto convolutionReverbProcessor = static_cast<ConvolutionReverbProcessor*>(node);
+            convolutionReverbProcessor->setWet(newWet);
+        });
+    }
+
+    class FilterProcessor final: public mixer::Processor
     {
     public:
+        FilterProcessor(mixer::Biquad::Type initType, float initFrequency, float initResonance, float initGain = 0.0F):
+            type(initType), frequency(initFrequency), resonance(initResonance), gain(initGain)
+        {
+        }
+
+        void prepare(std::uint32_t, std::uint32_t channels, std::uint32_t sampleRate) final
+        {
+            biquad.resize(channels);
+            preparedSampleRate = sampleRate;
+            updateCoefficients(true);
+        }
+
         void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) final
+                     mixer::SampleView samples) final
+        {
+            if (biquad.getChannels() != channels || preparedSampleRate != sampleRate)
+                prepare(frames, channels, sampleRate);
+
+            biquad.process(samples.data(), frames);
+        }
+
+        void setType(mixer::Biquad::Type newType)
+        {
+            type = newType;
+            updateCoefficients(false);
+        }
+
+        void setFrequency(float newFrequency)
+        {
+            frequency = newFrequency;
+            updateCoefficients(false);
+        }
+
+        void setResonance(float newResonance)
+        {
+            resonance = newResonance;
+            updateCoefficients(false);
+        }
+
+        void setGain(float newGain)
+        {
+            gain = newGain;
+            updateCoefficients(false);
+        }
+
+    private:
+        void updateCoefficients(bool immediate)
         {
+            if (preparedSampleRate)
+                biquad.setCoefficients(mixer::Biquad::getCoefficients(type, preparedSampleRate,
+                                                                      frequency, resonance, gain),
+                                       immediate);
         }
+
+        mixer::Biquad::Type type;
+        float frequency;
+        float resonance;
+        float gain;
+        std::uint32_t preparedSampleRate = 0;
+        mixer::Biquad biquad;
     };
 
-    HighPass::HighPass(Audio& initAudio):
+    Filter::Filter(Audio& initAudio, Type initType, float initFrequency,
+                   float initResonance, float initGain):
+        Effect(initAudio,
+               initAudio.initProcessor(std::make_unique<FilterProcessor>(initType, initFrequency,
+                                                                         initResonance, initGain))),
+        type(initType),
+        frequency(initFrequency),
+        resonance(initResonance),
+        gain(initGain)
+    {
+    }
+
+    void Filter::setType(Type newType)
+    {
+        type = newType;
+
+        audio.updateProcessor(processorId, [newType](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setType(newType);
+        });
+    }
+
+    void Filter::setFrequency(float newFrequency)
+    {
+        frequency = newFrequency;
+
+        audio.updateProcessor(processorId, [newFrequency](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setFrequency(newFrequency);
+        });
+    }
+
+    void Filter::setResonance(float newResonance)
+    {
+        resonance = newResonance;
+
+        audio.updateProcessor(processorId, [newResonance](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setResonance(newResonance);
+        });
+    }
+
+    void Filter::setGain(float newGain)
+    {
+        gain = newGain;
+
+        audio.updateProcessor(processorId, [newGain](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setGain(newGain);
+        });
+    }
+
+    LowPass::LowPass(Audio& initAudio, float initCutoff, float initResonance):
         Effect(initAudio,
-               initAudio.initProcessor(std::unique_ptr<HighPassProcessor>()))
+               initAudio.initProcessor(std::make_unique<FilterProcessor>(mixer::Biquad::Type::lowPass,
+                                                                         initCutoff, initResonance))),
+        cutoff(initCutoff),
+        resonance(initResonance)
+    {
+    }
+
+    void LowPass::setCutoff(float newCutoff)
     {
+        cutoff = newCutoff;
+
+        audio.updateProcessor(processorId, [newCutoff](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setFrequency(newCutoff);
+        });
+    }
+
+    void LowPass::setResonance(float newResonance)
+    {
+        resonance = newResonance;
+
+        audio.updateProcessor(processorId, [newResonance](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setResonance(newResonance);
+        });
+    }
+
+    HighPass::HighPass(Audio& initAudio, float initCutoff, float initResonance):
+        Effect(initAudio,
+               initAudio.initProcessor(std::make_unique<FilterProcessor>(mixer::Biquad::Type::highPass,
+                                                                         initCutoff, initResonance))),
+        cutoff(initCutoff),
+        resonance(initResonance)
+    {
+    }
+
+    void HighPass::setCutoff(float newCutoff)
+    {
+        cutoff = newCutoff;
+
+        audio.updateProcessor(processorId, [newCutoff](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setFrequency(newCutoff);
+        });
+    }
+
+    void HighPass::setResonance(float newResonance)
+    {
+        resonance = newResonance;
+
+        audio.updateProcessor(processorId, [newResonance](mixer::Object* node) {
+            auto filterProcessor = static_cast<FilterProcessor*>(node);
+            filterProcessor->setResonance(newResonance);
+        });
     }
 }
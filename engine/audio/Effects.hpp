@@ -4,13 +4,17 @@
 #define OUZEL_AUDIO_EFFECTS_HPP
 
 #include <cfloat>
+#include <string>
 #include <utility>
 #include "Effect.hpp"
+#include "mixer/Biquad.hpp"
 #include "../math/Vector.hpp"
 #include "../scene/Component.hpp"
 
 namespace ouzel::audio
 {
+    class Sound;
+
     class Delay final: public Effect
     {
     public:
@@ -144,26 +148,102 @@ namespace ouzel::audio
         float decay = 0.5F;
     };
 
+    class ConvolutionReverb final: public Effect
+    {
+    public:
+        // the impulse response is decoded and transformed when the effect is created, the asynchronous reverb is
+        // convolved on a worker thread and delayed by one more block
+        ConvolutionReverb(Audio& initAudio, const Sound& impulseResponse,
+                          float initWet = 1.0F, bool asynchronous = false);
+
+        // gets the impulse response from the asset cache
+        ConvolutionReverb(Audio& initAudio, const std::string& impulseResponse,
+                          float initWet = 1.0F, bool asynchronous = false);
+
+        ConvolutionReverb(const ConvolutionReverb&) = delete;
+        ConvolutionReverb& operator=(const ConvolutionReverb&) = delete;
+        ConvolutionReverb(ConvolutionReverb&&) = delete;
+        ConvolutionReverb& operator=(ConvolutionReverb&&) = delete;
+
+        auto getWet() const noexcept { return wet; }
+        void setWet(float newWet);
+
+    private:
+        float wet = 1.0F; // gain of the reverberated signal that is added to the input
+    };
+
+    class Filter final: public Effect
+    {
+    public:
+        using Type = mixer::Biquad::Type;
+
+        Filter(Audio& initAudio, Type initType, float initFrequency,
+               float initResonance = 0.7071F, float initGain = 0.0F);
+
+        Filter(const Filter&) = delete;
+        Filter& operator=(const Filter&) = delete;
+        Filter(Filter&&) = delete;
+        Filter& operator=(Filter&&) = delete;
+
+        auto getType() const noexcept { return type; }
+        void setType(Type newType);
+
+        auto getFrequency() const noexcept { return frequency; }
+        void setFrequency(float newFrequency);
+
+        auto getResonance() const noexcept { return resonance; }
+        void setResonance(float newResonance);
+
+        auto getGain() const noexcept { return gain; }
+        void setGain(float newGain);
+
+    private:
+        Type type;
+        float frequency;
+        float resonance = 0.7071F; // Q
+        float gain = 0.0F; // dB, used only by the shelf and peaking filters
+    };
+
     class LowPass final: public Effect
     {
     public:
-        explicit LowPass(Audio& initAudio);
+        LowPass(Audio& initAudio, float initCutoff = 5000.0F, float initResonance = 0.7071F);
 
         LowPass(const LowPass&) = delete;
         LowPass& operator=(const LowPass&) = delete;
         LowPass(LowPass&&) = delete;
         LowPass& operator=(LowPass&&) = delete;
+
+        auto getCutoff() const noexcept { return cutoff; }
+        void setCutoff(float newCutoff);
+
+        auto getResonance() const noexcept { return resonance; }
+        void setResonance(float newResonance);
+
+    private:
+        float cutoff = 5000.0F; // Hz
+        float resonance = 0.7071F; // Q
     };
 
     class HighPass final: public Effect
     {
     public:
-        explicit HighPass(Audio& initAudio);
+        HighPass(Audio& initAudio, float initCutoff = 200.0F, float initResonance = 0.7071F);
 
         HighPass(const HighPass&) = delete;
         HighPass& operator=(const HighPass&) = delete;
         HighPass(HighPass&&) = delete;
         HighPass& operator=(HighPass&&) = delete;
+
+        auto getCutoff() const noexcept { return cutoff; }
+        void setCutoff(float newCutoff);
+
+        auto getResonance() const noexcept { return resonance; }
+        void setResonance(float newResonance);
+
+    private:
+        float cutoff = 200.0F; // Hz
+        float resonance = 0.7071F; // Q
     };
 }
 
@@ -26,8 +26,20 @@ namespace ouzel::audio
         if (mix) mix->addListener(this);
     }
 
+    void Listener::setPosition(const Vector3F& newPosition)
+    {
+        position = newPosition;
+        if (mix) mix->updateListener();
+    }
+
+    void Listener::setRotation(const QuaternionF& newRotation)
+    {
+        rotation = newRotation;
+        if (mix) mix->updateListener();
+    }
+
     void Listener::updateTransform()
     {
-        transformDirty = true;
+        setPosition(actor->getWorldPosition());
     }
 }
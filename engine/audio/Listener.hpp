@@ -29,13 +29,13 @@ namespace ouzel::audio
         void setMix(Mix* newMix);
 
         auto& getPosition() const noexcept { return position; }
-        void setPosition(const Vector3F& newPosition) { position = newPosition; }
+        void setPosition(const Vector3F& newPosition);
 
         auto& getVelocity() const noexcept { return velocity; }
         void setVelocity(const Vector3F& newVelocity) { velocity = newVelocity; }
 
         auto& getRotation() const noexcept { return rotation; }
-        void setRotation(const QuaternionF& newRotation) { rotation = newRotation; }
+        void setRotation(const QuaternionF& newRotation);
 
     private:
         void updateTransform() final;
@@ -46,7 +46,6 @@ namespace ouzel::audio
         Vector3F position;
         Vector3F velocity;
         QuaternionF rotation;
-        bool transformDirty = true;
     };
 }
 
@@ -57,6 +57,13 @@ namespace ouzel::audio
         }
     }
 
+    void Mix::setMaxVoices(std::uint32_t newMaxVoices)
+    {
+        maxVoices = newMaxVoices;
+
+        audio.addCommand(std::make_unique<mixer::SetBusMaxStreamsCommand>(busId, maxVoices));
+    }
+
     void Mix::addInput(Submix* submix)
     {
         const auto i = std::find(inputSubmixes.begin(), inputSubmixes.end(), submix);
@@ -89,6 +96,7 @@ namespace ouzel::audio
             if (listener->mix) listener->mix->removeListener(listener);
             listener->mix = this;
             listeners.push_back(listener);
+            updateListener();
         }
     }
 
@@ -99,6 +107,18 @@ namespace ouzel::audio
         {
             listener->mix = nullptr;
             listeners.erase(i);
+            updateListener();
         }
     }
+
+    void Mix::updateListener()
+    {
+        // the bus uses the first listener of the mix
+        if (listeners.empty())
+            audio.addCommand(std::make_unique<mixer::SetBusListenerCommand>(busId, false, Vector3F{}, QuaternionF::identity()));
+        else
+            audio.addCommand(std::make_unique<mixer::SetBusListenerCommand>(busId, true,
+                                                                            listeners.front()->getPosition(),
+                                                                            listeners.front()->getRotation()));
+    }
 }
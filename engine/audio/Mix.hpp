@@ -33,6 +33,10 @@ namespace ouzel::audio
         void addEffect(Effect* effect);
         void removeEffect(Effect* effect);
 
+        // maximum number of input voices mixed at once, zero for no limit
+        auto getMaxVoices() const noexcept { return maxVoices; }
+        void setMaxVoices(std::uint32_t newMaxVoices);
+
     protected:
         void addInput(Submix* submix);
         void removeInput(Submix* submix);
@@ -40,6 +44,7 @@ namespace ouzel::audio
         void removeInput(Voice* voice);
         void addListener(Listener* listener);
         void removeListener(Listener* listener);
+        void updateListener();
 
         Audio& audio;
         std::size_t busId;
@@ -47,6 +52,7 @@ namespace ouzel::audio
         std::vector<Voice*> inputVoices;
         std::vector<Effect*> effects;
         std::vector<Listener*> listeners;
+        std::uint32_t maxVoices = 0;
     };
 }
 
@@ -1,5 +1,6 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "Oscillator.hpp"
 #include "Audio.hpp"
 #include "mixer/Data.hpp"
@@ -21,6 +22,7 @@ namespace ouzel::audio
         }
 
         void getSamples(std::uint32_t frames, std::vector<float>& samples) final;
+        void skip(std::uint32_t frames) final;
 
     private:
         std::uint32_t position = 0;
@@ -150,6 +152,25 @@ namespace ouzel::audio
         }
     }
 
+    void OscillatorStream::skip(std::uint32_t frames)
+    {
+        const auto length = static_cast<OscillatorData&>(data).getLength();
+
+        if (length > 0.0F)
+        {
+            const auto frameCount = static_cast<std::uint32_t>(length * data.getSampleRate());
+            position += std::min(frames, frameCount - position);
+
+            if ((frameCount - position) == 0)
+            {
+                playing = false;
+                reset();
+            }
+        }
+        else
+            position += frames;
+    }
+
     Oscillator::Oscillator(Audio& initAudio, float initFrequency,
                            Type initType, float initAmplitude, float initLength):
         Sound(initAudio,
@@ -161,4 +182,9 @@ namespace ouzel::audio
         length(initLength)
     {
     }
+
+    mixer::Data& Oscillator::getData() const noexcept
+    {
+        return *data;
+    }
 }
@@ -24,6 +24,8 @@ namespace ouzel::audio
                    Type initType = Type::sine,
                    float initAmplitude = 0.5F, float initLength = 0.0F);
 
+        mixer::Data& getData() const noexcept final;
+
     private:
         OscillatorData* data;
         Type type;
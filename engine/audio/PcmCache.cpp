@@ -0,0 +1,126 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "PcmCache.hpp"
+
+namespace ouzel::audio
+{
+    PcmCache::Buffer::Buffer(std::uint32_t initChannels, std::uint32_t initCapacity, Format initFormat):
+        channels(initChannels), capacity(initCapacity), format(initFormat)
+    {
+        if (format == Format::int16)
+            int16Samples.resize(static_cast<std::size_t>(channels) * capacity);
+        else
+            floatSamples.resize(static_cast<std::size_t>(channels) * capacity);
+    }
+
+    std::size_t PcmCache::Buffer::getSize() const noexcept
+    {
+        return floatSamples.size() * sizeof(float) + int16Samples.size() * sizeof(std::int16_t);
+    }
+
+    void PcmCache::Buffer::read(std::uint32_t position, std::uint32_t count, float* samples, std::size_t stride) const noexcept
+    {
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const auto offset = static_cast<std::size_t>(channel) * capacity + position;
+
+            if (format == Format::int16)
+                mixer::fromInt16(samples + channel * stride, &int16Samples[offset], count);
+            else
+                std::copy(&floatSamples[offset], &floatSamples[offset] + count, samples + channel * stride);
+        }
+    }
+
+    void PcmCache::Buffer::write(std::uint32_t position, std::uint32_t count, const float* samples, std::size_t stride) noexcept
+    {
+        count = std::min(count, capacity - position);
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const auto offset = static_cast<std::size_t>(channel) * capacity + position;
+
+            if (format == Format::int16)
+                mixer::interleaveInt16(&int16Samples[offset], samples + channel * stride, 1, count, 0, ditherState);
+            else
+                std::copy(samples + channel * stride, samples + channel * stride + count, &floatSamples[offset]);
+        }
+    }
+
+    void PcmCache::Buffer::finish(std::uint32_t frameCount) noexcept
+    {
+        frames = std::min(frameCount, capacity);
+        complete.store(true, std::memory_order_release);
+    }
+
+    bool PcmCache::isCacheable(std::uint32_t channels, std::uint32_t frames) const noexcept
+    {
+        const auto sampleSize = (format == Format::int16) ? sizeof(std::int16_t) : sizeof(float);
+        const auto size = static_cast<std::size_t>(channels) * frames * sampleSize;
+        return size > 0 && size <= std::min(maxBufferSize, maxSize);
+    }
+
+    std::shared_ptr<const PcmCache::Buffer> PcmCache::find(const void* key)
+    {
+        std::lock_guard lock(mutex);
+
+        const auto i = entryMap.find(key);
+        if (i == entryMap.end() || !i->second->buffer->isComplete())
+        {
+            ++statistics.misses;
+            return nullptr;
+        }
+
+        ++statistics.hits;
+        entries.splice(entries.begin(), entries, i->second);
+        return i->second->buffer;
+    }
+
+    std::shared_ptr<PcmCache::Buffer> PcmCache::insert(const void* key, std::uint32_t channels, std::uint32_t frames)
+    {
+        if (!isCacheable(channels, frames)) return nullptr;
+
+        auto buffer = std::make_shared<Buffer>(channels, frames, format);
+
+        std::lock_guard lock(mutex);
+
+        if (entryMap.find(key) != entryMap.end()) return nullptr;
+
+        // evict the least recently used buffers, the streams that play them keep them alive
+        while (!entries.empty() && statistics.size + buffer->getSize() > maxSize)
+        {
+            erase(std::prev(entries.end()));
+            ++statistics.evictions;
+        }
+
+        entries.push_front(Entry{key, buffer});
+        entryMap[key] = entries.begin();
+        statistics.size += buffer->getSize();
+        ++statistics.bufferCount;
+
+        return buffer;
+    }
+
+    void PcmCache::remove(const void* key, const Buffer* buffer)
+    {
+        std::lock_guard lock(mutex);
+
+        const auto i = entryMap.find(key);
+        if (i != entryMap.end() && (!buffer || i->second->buffer.get() == buffer))
+            erase(i->second);
+    }
+
+    PcmCache::Statistics PcmCache::getStatistics() const
+    {
+        std::lock_guard lock(mutex);
+        return statistics;
+    }
+
+    void PcmCache::erase(std::list<Entry>::iterator entry)
+    {
+        statistics.size -= entry->buffer->getSize();
+        --statistics.bufferCount;
+        entryMap.erase(entry->key);
+        entries.erase(entry);
+    }
+}
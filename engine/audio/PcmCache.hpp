@@ -0,0 +1,117 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_PCMCACHE_HPP
+#define OUZEL_AUDIO_PCMCACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "mixer/Kernels.hpp"
+
+namespace ouzel::audio
+{
+    // decoded samples of compressed sounds shared by all of their streams, the least recently used sounds are
+    // evicted when the cache is over its size
+    class PcmCache final
+    {
+    public:
+        enum class Format
+        {
+            float32,
+            int16
+        };
+
+        // planar samples of one sound, filled by the first stream that decodes the whole sound
+        class Buffer final
+        {
+        public:
+            Buffer(std::uint32_t initChannels, std::uint32_t initCapacity, Format initFormat);
+
+            auto getChannels() const noexcept { return channels; }
+            auto getCapacity() const noexcept { return capacity; }
+            auto getFormat() const noexcept { return format; }
+            std::size_t getSize() const noexcept;
+
+            // frames can be read only after the buffer is complete
+            auto isComplete() const noexcept { return complete.load(std::memory_order_acquire); }
+            auto getFrames() const noexcept { return frames; }
+
+            // copies the frames starting at the position to planar samples (channels are stride samples apart)
+            void read(std::uint32_t position, std::uint32_t count, float* samples, std::size_t stride) const noexcept;
+
+            // stores the planar samples (channels are stride samples apart) at the position
+            void write(std::uint32_t position, std::uint32_t count, const float* samples, std::size_t stride) noexcept;
+            void finish(std::uint32_t frameCount) noexcept;
+
+        private:
+            std::uint32_t channels;
+            std::uint32_t capacity;
+            std::uint32_t frames = 0;
+            Format format;
+            std::vector<float> floatSamples;
+            std::vector<std::int16_t> int16Samples;
+            mixer::DitherState ditherState = mixer::initialDitherState;
+            std::atomic<bool> complete{false};
+        };
+
+        struct Statistics final
+        {
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t evictions = 0;
+            std::size_t size = 0; // bytes
+            std::size_t bufferCount = 0;
+        };
+
+        PcmCache(std::size_t initMaxSize, std::size_t initMaxBufferSize, Format initFormat) noexcept:
+            maxSize(initMaxSize), maxBufferSize(initMaxBufferSize), format(initFormat)
+        {
+        }
+
+        PcmCache(const PcmCache&) = delete;
+        PcmCache& operator=(const PcmCache&) = delete;
+        PcmCache(PcmCache&&) = delete;
+        PcmCache& operator=(PcmCache&&) = delete;
+
+        auto getFormat() const noexcept { return format; }
+
+        // returns true if a sound of the given length is short enough to be cached
+        bool isCacheable(std::uint32_t channels, std::uint32_t frames) const noexcept;
+
+        // returns the complete buffer of the key and marks it as the most recently used or null on a miss
+        std::shared_ptr<const Buffer> find(const void* key);
+
+        // adds an empty buffer for the key that the caller must fill, returns null if there already is a buffer
+        // for the key or if it does not fit in the cache
+        std::shared_ptr<Buffer> insert(const void* key, std::uint32_t channels, std::uint32_t frames);
+
+        // removes the buffer of the key (if the buffer is given, only if the key still has it)
+        void remove(const void* key, const Buffer* buffer = nullptr);
+
+        Statistics getStatistics() const;
+
+    private:
+        struct Entry final
+        {
+            const void* key;
+            std::shared_ptr<Buffer> buffer;
+        };
+
+        void erase(std::list<Entry>::iterator entry);
+
+        std::size_t maxSize;
+        std::size_t maxBufferSize;
+        Format format;
+
+        mutable std::mutex mutex;
+        std::list<Entry> entries; // the most recently used entry is first
+        std::unordered_map<const void*, std::list<Entry>::iterator> entryMap;
+        Statistics statistics;
+    };
+}
+
+#endif // OUZEL_AUDIO_PCMCACHE_HPP
@@ -1,10 +1,12 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <iterator>
 #include <stdexcept>
 #include "PcmClip.hpp"
 #include "Audio.hpp"
 #include "mixer/Data.hpp"
+#include "mixer/Resampler.hpp"
 #include "mixer/Stream.hpp"
 
 namespace ouzel::audio
@@ -22,6 +24,7 @@ namespace ouzel::audio
         }
 
         void getSamples(std::uint32_t frames, std::vector<float>& samples) final;
+        void skip(std::uint32_t frames) final;
 
     private:
         std::uint32_t position = 0;
@@ -91,11 +94,63 @@ namespace ouzel::audio
         }
     }
 
+    void PcmStream::skip(std::uint32_t frames)
+    {
+        auto& pcmData = static_cast<PcmData&>(data);
+        const auto sourceFrames = static_cast<std::uint32_t>(pcmData.getSamples().size() / pcmData.getChannels());
+
+        position += std::min(frames, sourceFrames - position);
+
+        if ((sourceFrames - position) == 0)
+        {
+            playing = false;
+            reset();
+        }
+    }
+
+    namespace
+    {
+        PcmData* createData(Audio& audio, std::uint32_t channels, std::uint32_t sampleRate,
+                            const std::vector<float>& samples)
+        {
+            const auto targetSampleRate = audio.getDevice()->getSampleRate();
+
+            if (!audio.isPreresampleEnabled() || sampleRate == targetSampleRate || !channels)
+                return new PcmData(channels, sampleRate, samples);
+
+            // resample the whole clip once with the highest quality, so that the mixer does not have to do it
+            const auto sourceFrames = static_cast<std::uint32_t>(samples.size() / channels);
+            const auto frames = static_cast<std::uint32_t>((static_cast<std::uint64_t>(sourceFrames) * targetSampleRate +
+                                                            sampleRate - 1) / sampleRate); // round up
+
+            mixer::Resampler resampler(mixer::Resampler::Quality::sinc);
+            const auto neededFrames = resampler.getSourceFrames(channels, sampleRate, targetSampleRate, frames);
+
+            // pad the end of the clip with silence for the frames needed by the filter
+            const auto copyFrames = std::min(sourceFrames, neededFrames);
+            std::vector<float> sourceSamples(neededFrames * channels, 0.0F);
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                std::copy(samples.begin() + channel * sourceFrames,
+                          samples.begin() + channel * sourceFrames + copyFrames,
+                          sourceSamples.begin() + channel * neededFrames);
+
+            std::vector<float> resampledSamples;
+            resampler.resample(sourceSamples, neededFrames, frames, resampledSamples);
+
+            return new PcmData(channels, targetSampleRate, resampledSamples);
+        }
+    }
+
     PcmClip::PcmClip(Audio& initAudio, std::uint32_t channels, std::uint32_t sampleRate,
                       const std::vector<float>& samples):
         Sound(initAudio,
-              initAudio.initData(std::unique_ptr<mixer::Data>(data = new PcmData(channels, sampleRate, samples))),
+              initAudio.initData(std::unique_ptr<mixer::Data>(data = createData(initAudio, channels, sampleRate, samples))),
               Sound::Format::pcm)
     {
     }
+
+    mixer::Data& PcmClip::getData() const noexcept
+    {
+        return *data;
+    }
 }
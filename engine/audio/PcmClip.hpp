@@ -17,6 +17,8 @@ namespace ouzel::audio
         PcmClip(Audio& initAudio, std::uint32_t channels, std::uint32_t sampleRate,
                 const std::vector<float>& samples);
 
+        mixer::Data& getData() const noexcept final;
+
     private:
         PcmData* data;
     };
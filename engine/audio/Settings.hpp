@@ -3,8 +3,10 @@
 #ifndef OUZEL_AUDIO_SETTINGS_HPP
 #define OUZEL_AUDIO_SETTINGS_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include "SampleFormat.hpp"
+#include "mixer/Resampler.hpp"
 
 namespace ouzel::audio
 {
@@ -12,9 +14,19 @@ namespace ouzel::audio
     {
         bool debugAudio = false;
         std::uint32_t bufferSize = 512;
+        std::uint32_t bufferCount = 3; // number of buffers mixed ahead of the audio device
         std::uint32_t sampleRate = 44100;
         std::uint32_t channels = 0;
         SampleFormat sampleFormat = SampleFormat::float32;
+        mixer::Resampler::Quality resamplerQuality = mixer::Resampler::Quality::cubic;
+        bool preresample = false; // resample PCM clips to the sample rate of the device when they are created
+        std::uint32_t maxVoices = 64; // maximum number of voices mixed at once, the rest are virtual, zero for no limit
+        float audibilityThreshold = 0.001F; // voices quieter than this (-60 dB) are virtual
+        std::size_t pcmCacheSize = 16 * 1024 * 1024; // bytes of decoded samples of short compressed sounds, zero to disable
+        std::size_t pcmCacheMaxSoundSize = 1024 * 1024; // bytes of decoded samples of the longest sound that is cached
+        bool pcmCacheInt16 = false; // store the cached samples as 16-bit integers
+        std::uint32_t mixerThreads = 2; // worker threads that mix the independent buses in parallel, zero to disable
+        bool offline = false; // the audio device is not started, the samples are rendered with Audio::render
         std::string audioDevice;
     };
 }
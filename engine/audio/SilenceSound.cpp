@@ -1,5 +1,6 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "SilenceSound.hpp"
 #include "Audio.hpp"
 #include "mixer/Data.hpp"
@@ -20,6 +21,7 @@ namespace ouzel::audio
         }
 
         void getSamples(std::uint32_t frames, std::vector<float>& samples) final;
+        void skip(std::uint32_t frames) final;
 
     private:
         std::uint32_t position = 0;
@@ -91,6 +93,25 @@ namespace ouzel::audio
         }
     }
 
+    void SilenceStream::skip(std::uint32_t frames)
+    {
+        const auto length = static_cast<SilenceData&>(data).getLength();
+
+        if (length > 0.0F)
+        {
+            const auto frameCount = static_cast<std::uint32_t>(length * data.getSampleRate());
+            position += std::min(frames, frameCount - position);
+
+            if ((frameCount - position) == 0)
+            {
+                playing = false;
+                reset();
+            }
+        }
+        else
+            position += frames;
+    }
+
     SilenceSound::SilenceSound(Audio& initAudio, float initLength):
         Sound(initAudio,
               initAudio.initData(std::unique_ptr<mixer::Data>(data = new SilenceData(initLength))),
@@ -98,4 +119,9 @@ namespace ouzel::audio
         length(initLength)
     {
     }
+
+    mixer::Data& SilenceSound::getData() const noexcept
+    {
+        return *data;
+    }
 }
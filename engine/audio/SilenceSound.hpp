@@ -14,6 +14,8 @@ namespace ouzel::audio
     public:
         SilenceSound(Audio& initAudio, float initLength = 0.0F);
 
+        mixer::Data& getData() const noexcept final;
+
     private:
         SilenceData* data;
         float length;
@@ -12,6 +12,11 @@ namespace ouzel::audio
 {
     class Audio;
 
+    namespace mixer
+    {
+        class Data;
+    }
+
     class Sound
     {
         friend Audio;
@@ -34,6 +39,9 @@ namespace ouzel::audio
         auto getSourceId() const noexcept { return sourceId; }
         auto getFormat() const noexcept { return format; }
 
+        // the data is not modified after the sound is created, so its streams can be decoded on any thread
+        virtual mixer::Data& getData() const noexcept = 0;
+
     protected:
         Audio& audio;
         std::size_t sourceId = 0;
@@ -0,0 +1,101 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include "Streamer.hpp"
+#include "../core/Engine.hpp"
+#include "../utils/Log.hpp"
+
+namespace ouzel::audio
+{
+    namespace
+    {
+        // the sources are polled at least this often even if nobody notifies the thread
+        constexpr std::chrono::milliseconds pollInterval{10};
+    }
+
+    Streamer::~Streamer()
+    {
+        std::unique_lock lock(mutex);
+        running = false;
+        lock.unlock();
+        condition.notify_all();
+
+        if (streamerThread.isJoinable())
+            streamerThread.join();
+    }
+
+    void Streamer::addSource(Source& source)
+    {
+        std::unique_lock lock(mutex);
+        sources.push_back(&source);
+
+#if !defined(__EMSCRIPTEN__)
+        // the thread is started only when something is streamed
+        if (!running)
+        {
+            running = true;
+            streamerThread = thread::Thread(&Streamer::streamerMain, this);
+        }
+#endif
+        lock.unlock();
+
+        notify();
+    }
+
+    void Streamer::removeSource(Source& source)
+    {
+        std::unique_lock lock(mutex);
+
+        const auto i = std::find(sources.begin(), sources.end(), &source);
+        if (i != sources.end()) sources.erase(i);
+
+        readCondition.wait(lock, [this, &source]() { return currentSource != &source; });
+    }
+
+    void Streamer::notify()
+    {
+#if defined(__EMSCRIPTEN__)
+        // there are no threads, so the sources are read when they run out of data
+        for (Source* source : sources)
+            while (source->read());
+#else
+        condition.notify_one();
+#endif
+    }
+
+    void Streamer::streamerMain()
+    {
+        thread::setCurrentThreadName("Streamer");
+
+        std::unique_lock lock(mutex);
+
+        while (running)
+        {
+            bool dataRead = false;
+
+            // the lock is released while reading, the sources can be added and removed in the meantime
+            for (std::size_t i = 0; i < sources.size(); ++i)
+            {
+                currentSource = sources[i];
+                lock.unlock();
+
+                try
+                {
+                    if (currentSource->read()) dataRead = true;
+                }
+                catch (const std::exception& e)
+                {
+                    logger.log(Log::Level::error) << e.what();
+                }
+
+                lock.lock();
+                currentSource = nullptr;
+                readCondition.notify_all();
+            }
+
+            if (!dataRead)
+                condition.wait_for(lock, pollInterval);
+        }
+    }
+}
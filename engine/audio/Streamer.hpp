@@ -0,0 +1,61 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_STREAMER_HPP
+#define OUZEL_AUDIO_STREAMER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "../thread/Thread.hpp"
+
+namespace ouzel::audio
+{
+    // background thread that reads the data of the streamed sounds, so that the mixer never waits for I/O
+    class Streamer final
+    {
+    public:
+        class Source
+        {
+        public:
+            Source() = default;
+            virtual ~Source() = default;
+
+            Source(const Source&) = delete;
+            Source& operator=(const Source&) = delete;
+            Source(Source&&) = delete;
+            Source& operator=(Source&&) = delete;
+
+            // called on the streaming thread, returns true if data was read and it should be called again
+            virtual bool read() = 0;
+        };
+
+        Streamer() = default;
+        ~Streamer();
+
+        Streamer(const Streamer&) = delete;
+        Streamer& operator=(const Streamer&) = delete;
+        Streamer(Streamer&&) = delete;
+        Streamer& operator=(Streamer&&) = delete;
+
+        void addSource(Source& source);
+
+        // waits until the streaming thread is not reading the source
+        void removeSource(Source& source);
+
+        // wakes up the streaming thread, called when a source needs more data
+        void notify();
+
+    private:
+        void streamerMain();
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::condition_variable readCondition;
+        std::vector<Source*> sources;
+        Source* currentSource = nullptr;
+        bool running = false;
+        thread::Thread streamerThread;
+    };
+}
+
+#endif // OUZEL_AUDIO_STREAMER_HPP
@@ -191,6 +191,13 @@ namespace ouzel::audio
         engine->getEventDispatcher().postEvent(std::move(event));
     }*/
 
+    void Voice::setPriority(std::int32_t newPriority)
+    {
+        priority = newPriority;
+
+        audio.addCommand(std::make_unique<mixer::SetStreamPriorityCommand>(streamId, priority));
+    }
+
     void Voice::setOutput(Mix* newOutput)
     {
         if (output) output->removeInput(this);
@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_VOICE_HPP
 #define OUZEL_AUDIO_VOICE_HPP
 
+#include <cstdint>
 #include <memory>
 #include "Cue.hpp"
 #include "Node.hpp"
@@ -52,6 +53,10 @@ namespace ouzel::audio
 
         auto isPlaying() const noexcept { return playing; }
 
+        // voices with a higher priority are virtualized last when the voice limit is reached
+        auto getPriority() const noexcept { return priority; }
+        void setPriority(std::int32_t newPriority);
+
         void setOutput(Mix* newOutput);
 
     private:
@@ -62,6 +67,7 @@ namespace ouzel::audio
         Vector3F position;
         Vector3F velocity;
         bool playing = false;
+        std::int32_t priority = 0;
 
         Mix* output = nullptr;
     };
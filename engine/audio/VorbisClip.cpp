@@ -1,10 +1,20 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <fstream>
 #include <stdexcept>
+#include <vector>
 #include "VorbisClip.hpp"
 #include "Audio.hpp"
+#include "PcmCache.hpp"
+#include "Streamer.hpp"
 #include "mixer/Data.hpp"
 #include "mixer/Stream.hpp"
+#include "../core/Engine.hpp"
+#include "../storage/FileSystem.hpp"
 #include "../utils/Utils.hpp"
 
 #if defined(_MSC_VER)
@@ -48,30 +58,55 @@ namespace ouzel::audio
     class VorbisStream final: public mixer::Stream
     {
     public:
-        explicit VorbisStream(VorbisData& vorbisData);
+        VorbisStream(VorbisData& vorbisData, std::shared_ptr<PcmCache::Buffer> initCacheBuffer);
+        ~VorbisStream() override;
 
-        ~VorbisStream() override
+        void reset() final
         {
-            if (vorbisStream)
-                stb_vorbis_close(vorbisStream);
+            stb_vorbis_seek_start(vorbisStream);
+            position = 0;
+            skipFrames = 0;
+            cachedFrames = 0;
         }
 
+        void getSamples(std::uint32_t frames, std::vector<float>& samples) final;
+        void skip(std::uint32_t frames) final;
+
+    private:
+        stb_vorbis* vorbisStream = nullptr;
+        std::uint32_t frameCount = 0;
+        std::uint32_t position = 0;
+        std::uint32_t skipFrames = 0; // the stream seeks only when it is decoded again
+
+        // the decoded samples are stored in the cache buffer while the whole sound is played from the start
+        std::shared_ptr<PcmCache::Buffer> cacheBuffer;
+        std::uint32_t cachedFrames = 0;
+    };
+
+    // plays the samples decoded by another stream
+    class CachedVorbisStream final: public mixer::Stream
+    {
+    public:
+        CachedVorbisStream(VorbisData& vorbisData, std::shared_ptr<const PcmCache::Buffer> initBuffer);
+
         void reset() final
         {
-            stb_vorbis_seek_start(vorbisStream);
+            position = 0;
         }
 
         void getSamples(std::uint32_t frames, std::vector<float>& samples) final;
+        void skip(std::uint32_t frames) final;
 
     private:
-        stb_vorbis* vorbisStream = nullptr;
+        std::shared_ptr<const PcmCache::Buffer> buffer;
+        std::uint32_t position = 0;
     };
 
     class VorbisData final: public mixer::Data
     {
     public:
-        explicit VorbisData(const std::vector<std::byte>& initData):
-            data(initData)
+        VorbisData(const storage::FileData& initData, PcmCache& initCache):
+            data(initData.begin(), initData.end())
         {
             stb_vorbis* vorbisStream = stb_vorbis_open_memory(reinterpret_cast<const unsigned char*>(data.data()),
                                                               static_cast<int>(data.size()),
@@ -84,27 +119,66 @@ namespace ouzel::audio
 
             channels = static_cast<std::uint32_t>(info.channels);
             sampleRate = info.sample_rate;
+            frameCount = stb_vorbis_stream_length_in_samples(vorbisStream);
 
             stb_vorbis_close(vorbisStream);
+
+            // only short sounds are cached
+            if (initCache.isCacheable(channels, frameCount))
+                cache = &initCache;
+        }
+
+        ~VorbisData() override
+        {
+            if (cache) cache->remove(this);
         }
 
         auto& getData() const noexcept { return data; }
+        auto getCache() const noexcept { return cache; }
 
         std::unique_ptr<mixer::Stream> createStream() final
         {
-            return std::make_unique<VorbisStream>(*this);
+            if (!cache)
+                return std::make_unique<VorbisStream>(*this, nullptr);
+
+            if (auto buffer = cache->find(this))
+                return std::make_unique<CachedVorbisStream>(*this, std::move(buffer));
+
+            // the first stream to play the sound decodes it into the cache
+            return std::make_unique<VorbisStream>(*this, cache->insert(this, channels, frameCount));
         }
 
     private:
+        // the data is decoded on the mixer thread, so it is copied instead of being mapped from the file to avoid page
+        // faults while mixing
         std::vector<std::byte> data;
+        std::uint32_t frameCount = 0;
+        PcmCache* cache = nullptr;
     };
 
-    VorbisStream::VorbisStream(VorbisData& vorbisData):
-        Stream(vorbisData)
+    VorbisStream::VorbisStream(VorbisData& vorbisData, std::shared_ptr<PcmCache::Buffer> initCacheBuffer):
+        Stream(vorbisData),
+        cacheBuffer(std::move(initCacheBuffer))
     {
         vorbisStream = stb_vorbis_open_memory(reinterpret_cast<const unsigned char*>(vorbisData.getData().data()),
                                               static_cast<int>(vorbisData.getData().size()),
                                               nullptr, nullptr);
+
+        if (vorbisStream)
+            frameCount = stb_vorbis_stream_length_in_samples(vorbisStream);
+    }
+
+    VorbisStream::~VorbisStream()
+    {
+        if (vorbisStream)
+            stb_vorbis_close(vorbisStream);
+
+        // let another stream decode the sound if this one did not play it to the end
+        if (cacheBuffer && !cacheBuffer->isComplete())
+        {
+            auto& vorbisData = static_cast<VorbisData&>(data);
+            vorbisData.getCache()->remove(&vorbisData, cacheBuffer.get());
+        }
     }
 
     void VorbisStream::getSamples(std::uint32_t frames, std::vector<float>& samples)
@@ -119,7 +193,16 @@ namespace ouzel::audio
             if (vorbisStream->eof)
                 reset();
 
-            std::vector<float*> channelData(data.getChannels());
+            if (skipFrames)
+            {
+                position += skipFrames;
+                skipFrames = 0;
+                stb_vorbis_seek(vorbisStream, position);
+            }
+
+            const auto caching = cacheBuffer && !cacheBuffer->isComplete() && cachedFrames == position;
+
+            std::array<float*, 6> channelData{};
 
             switch (data.getChannels())
             {
@@ -152,6 +235,16 @@ namespace ouzel::audio
                                                         static_cast<int>(data.getChannels()),
                                                         channelData.data(),
                                                         static_cast<int>(frames));
+            position += static_cast<std::uint32_t>(resultFrames);
+
+            if (caching)
+            {
+                cacheBuffer->write(cachedFrames, static_cast<std::uint32_t>(resultFrames), samples.data(), frames);
+                cachedFrames += static_cast<std::uint32_t>(resultFrames);
+
+                if (vorbisStream->eof)
+                    cacheBuffer->finish(cachedFrames);
+            }
         }
 
         if (vorbisStream->eof)
@@ -165,9 +258,419 @@ namespace ouzel::audio
                 samples[channel * frames + frame] = 0.0F;
     }
 
-    VorbisClip::VorbisClip(Audio& initAudio, const std::vector<std::byte>& initData):
+    void VorbisStream::skip(std::uint32_t frames)
+    {
+        skipFrames += frames;
+
+        if (frameCount && position + skipFrames >= frameCount)
+        {
+            playing = false;
+            reset();
+        }
+    }
+
+    CachedVorbisStream::CachedVorbisStream(VorbisData& vorbisData, std::shared_ptr<const PcmCache::Buffer> initBuffer):
+        Stream(vorbisData),
+        buffer(std::move(initBuffer))
+    {
+    }
+
+    void CachedVorbisStream::getSamples(std::uint32_t frames, std::vector<float>& samples)
+    {
+        samples.resize(frames * data.getChannels());
+
+        const auto copyFrames = std::min(frames, buffer->getFrames() - position);
+        buffer->read(position, copyFrames, samples.data(), frames);
+        position += copyFrames;
+
+        for (std::uint32_t channel = 0; channel < data.getChannels(); ++channel)
+            std::fill(samples.begin() + channel * frames + copyFrames,
+                      samples.begin() + (channel + 1) * frames, 0.0F);
+
+        if (position == buffer->getFrames())
+        {
+            playing = false;
+            reset();
+        }
+    }
+
+    void CachedVorbisStream::skip(std::uint32_t frames)
+    {
+        position += std::min(frames, buffer->getFrames() - position);
+
+        if (position == buffer->getFrames())
+        {
+            playing = false;
+            reset();
+        }
+    }
+
+    namespace
+    {
+        constexpr std::size_t maxOggPageSize = 27 + 255 + 255 * 255; // header, segment table and 255 full segments
+        constexpr std::size_t minPrefetchSize = 4096;
+
+        // Vorbis order of 5.1 channels is L, C, R, SL, SR, LFE
+        constexpr std::array<std::uint32_t, 6> surroundChannels{0, 2, 1, 4, 5, 3};
+
+        // reads as much of the beginning of the file as is needed to parse the Vorbis headers
+        std::vector<unsigned char> readHeaders(const storage::FileSection& section, stb_vorbis_info& info)
+        {
+            std::ifstream file(section.path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("Failed to open Vorbis stream");
+
+            std::vector<unsigned char> headers;
+
+            for (std::size_t size = 4096;; size *= 2)
+            {
+                size = std::min(size, section.size);
+                headers.resize(size);
+
+                file.seekg(section.offset, std::ios::beg);
+                file.read(reinterpret_cast<char*>(headers.data()), static_cast<std::streamsize>(size));
+
+                int used = 0;
+                int error = 0;
+                if (stb_vorbis* vorbisStream = stb_vorbis_open_pushdata(headers.data(), static_cast<int>(file.gcount()),
+                                                                        &used, &error, nullptr))
+                {
+                    info = stb_vorbis_get_info(vorbisStream);
+                    stb_vorbis_close(vorbisStream);
+
+                    headers.resize(static_cast<std::size_t>(used));
+                    return headers;
+                }
+
+                if (error != VORBIS_need_more_data || size == section.size)
+                    throw std::runtime_error("Failed to load Vorbis stream");
+            }
+        }
+    }
+
+    class VorbisFileData;
+
+    // decodes a Vorbis file that is read in parts by the streamer
+    class VorbisFileStream final: public mixer::Stream, public Streamer::Source
+    {
+    public:
+        explicit VorbisFileStream(VorbisFileData& fileData);
+        ~VorbisFileStream() override;
+
+        void reset() final;
+        void getSamples(std::uint32_t frames, std::vector<float>& samples) final;
+        void skip(std::uint32_t frames) final;
+
+        bool read() final;
+
+    private:
+        std::uint32_t decode(std::uint32_t frames, float* samples);
+        bool decodeFrame();
+
+        Streamer& streamer;
+        stb_vorbis* vorbisStream = nullptr;
+
+        // accessed only by the streaming thread
+        std::ifstream file;
+        std::size_t filePosition = 0;
+        std::uint32_t readGeneration = 0;
+        bool endOfFile = false;
+
+        // prefetched compressed data, written by the streaming thread and read by the mixer thread
+        std::vector<unsigned char> buffer;
+        alignas(64) std::atomic<std::size_t> readPosition{0};
+        alignas(64) std::atomic<std::size_t> writePosition{0};
+
+        // the mixer thread increments the generation to restart the stream, the streaming thread acknowledges it
+        // after it starts reading from the first audio page at the restart position
+        std::atomic<std::uint32_t> requestedGeneration{0};
+        std::atomic<std::uint32_t> restartedGeneration{0};
+        std::atomic<std::size_t> restartPosition{0};
+        std::atomic<std::uint32_t> endGeneration{~0U}; // generation for which the whole file has been read
+
+        // accessed only by the mixer thread
+        std::vector<unsigned char> pageBuffer; // contiguous data for the decoder, fits at least one page
+        std::size_t pageBufferSize = 0;
+        float** decodedSamples = nullptr;
+        std::uint32_t decodedFrames = 0;
+        std::uint32_t decodedOffset = 0;
+        bool restarting = false;
+        bool ended = false;
+    };
+
+    class VorbisFileData final: public mixer::Data
+    {
+    public:
+        VorbisFileData(Streamer& initStreamer, const storage::FileSection& initSection, std::size_t initPrefetchSize):
+            streamer(initStreamer),
+            section(initSection),
+            prefetchSize(std::max(initPrefetchSize, minPrefetchSize))
+        {
+            stb_vorbis_info info;
+            headers = readHeaders(section, info);
+
+            channels = static_cast<std::uint32_t>(info.channels);
+            sampleRate = info.sample_rate;
+            streamed = true;
+
+            if (channels != 1 && channels != 2 && channels != 4 && channels != 6)
+                throw std::runtime_error("Unsupported channel count");
+        }
+
+        auto& getStreamer() const noexcept { return streamer; }
+        auto& getSection() const noexcept { return section; }
+        auto& getHeaders() const noexcept { return headers; }
+        auto getPrefetchSize() const noexcept { return prefetchSize; }
+
+        std::unique_ptr<mixer::Stream> createStream() final
+        {
+            return std::make_unique<VorbisFileStream>(*this);
+        }
+
+    private:
+        Streamer& streamer;
+        storage::FileSection section;
+        std::size_t prefetchSize;
+        std::vector<unsigned char> headers;
+    };
+
+    VorbisFileStream::VorbisFileStream(VorbisFileData& fileData):
+        Stream(fileData),
+        streamer(fileData.getStreamer()),
+        filePosition(fileData.getHeaders().size()),
+        buffer(fileData.getPrefetchSize()),
+        pageBuffer(maxOggPageSize)
+    {
+        int used = 0;
+        int error = 0;
+        vorbisStream = stb_vorbis_open_pushdata(fileData.getHeaders().data(),
+                                                static_cast<int>(fileData.getHeaders().size()),
+                                                &used, &error, nullptr);
+
+        if (!vorbisStream)
+            throw std::runtime_error("Failed to load Vorbis stream");
+
+        streamer.addSource(*this);
+    }
+
+    VorbisFileStream::~VorbisFileStream()
+    {
+        streamer.removeSource(*this);
+
+        if (vorbisStream)
+            stb_vorbis_close(vorbisStream);
+    }
+
+    void VorbisFileStream::reset()
+    {
+        // the decoder resynchronizes on the first page it gets after the flush
+        stb_vorbis_flush_pushdata(vorbisStream);
+        pageBufferSize = 0;
+        decodedFrames = 0;
+        decodedOffset = 0;
+        ended = false;
+
+        restarting = true;
+        requestedGeneration.store(requestedGeneration.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        streamer.notify();
+    }
+
+    void VorbisFileStream::getSamples(std::uint32_t frames, std::vector<float>& samples)
+    {
+        samples.resize(frames * data.getChannels());
+
+        const auto resultFrames = decode(frames, samples.data());
+
+        // silence if the streamer could not keep up
+        for (std::uint32_t channel = 0; channel < data.getChannels(); ++channel)
+            std::fill(samples.begin() + channel * frames + resultFrames,
+                      samples.begin() + (channel + 1) * frames, 0.0F);
+
+        if (ended)
+        {
+            playing = false;
+            reset();
+        }
+    }
+
+    void VorbisFileStream::skip(std::uint32_t frames)
+    {
+        // the stream can not seek to a sample, so the skipped frames are decoded and discarded
+        decode(frames, nullptr);
+
+        if (ended)
+        {
+            playing = false;
+            reset();
+        }
+    }
+
+    std::uint32_t VorbisFileStream::decode(std::uint32_t frames, float* samples)
+    {
+        if (restarting)
+        {
+            if (restartedGeneration.load(std::memory_order_acquire) != requestedGeneration.load(std::memory_order_relaxed))
+            {
+                streamer.notify();
+                return 0;
+            }
+
+            // skip the data that was read before the restart
+            readPosition.store(restartPosition.load(std::memory_order_relaxed), std::memory_order_release);
+            restarting = false;
+        }
+
+        const auto channels = data.getChannels();
+        std::uint32_t resultFrames = 0;
+
+        while (resultFrames < frames)
+        {
+            if (decodedOffset == decodedFrames)
+            {
+                if (!decodeFrame()) break;
+                continue;
+            }
+
+            const auto count = std::min(frames - resultFrames, decodedFrames - decodedOffset);
+
+            if (samples)
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    const auto outputChannel = (channels == 6) ? surroundChannels[channel] : channel;
+                    std::copy(decodedSamples[channel] + decodedOffset,
+                              decodedSamples[channel] + decodedOffset + count,
+                              samples + outputChannel * frames + resultFrames);
+                }
+
+            decodedOffset += count;
+            resultFrames += count;
+        }
+
+        // ask for more data before the prefetched data runs out
+        const auto prefetchedSize = writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed);
+        if (prefetchedSize < buffer.size() / 2)
+            streamer.notify();
+
+        return resultFrames;
+    }
+
+    bool VorbisFileStream::decodeFrame()
+    {
+        for (;;)
+        {
+            // the decoder needs contiguous data, so the prefetched data is moved to the page buffer
+            const auto position = readPosition.load(std::memory_order_relaxed);
+            const auto size = std::min(writePosition.load(std::memory_order_acquire) - position,
+                                       pageBuffer.size() - pageBufferSize);
+            const auto offset = position % buffer.size();
+            const auto firstSize = std::min(size, buffer.size() - offset);
+
+            std::copy(buffer.begin() + offset, buffer.begin() + offset + firstSize,
+                      pageBuffer.begin() + pageBufferSize);
+            std::copy(buffer.begin(), buffer.begin() + (size - firstSize),
+                      pageBuffer.begin() + pageBufferSize + firstSize);
+
+            pageBufferSize += size;
+            readPosition.store(position + size, std::memory_order_release);
+
+            int frameCount = 0;
+            float** frameSamples = nullptr;
+            const auto used = static_cast<std::size_t>(stb_vorbis_decode_frame_pushdata(vorbisStream,
+                                                                                        pageBuffer.data(),
+                                                                                        static_cast<int>(pageBufferSize),
+                                                                                        nullptr, &frameSamples, &frameCount));
+
+            std::copy(pageBuffer.begin() + used, pageBuffer.begin() + pageBufferSize, pageBuffer.begin());
+            pageBufferSize -= used;
+
+            if (frameCount > 0)
+            {
+                decodedSamples = frameSamples;
+                decodedFrames = static_cast<std::uint32_t>(frameCount);
+                decodedOffset = 0;
+                return true;
+            }
+
+            if (used == 0)
+            {
+                // a page that does not fit in the page buffer means that the file is corrupt
+                if (pageBufferSize == pageBuffer.size() ||
+                    (endGeneration.load(std::memory_order_acquire) == requestedGeneration.load(std::memory_order_relaxed) &&
+                     writePosition.load(std::memory_order_acquire) == readPosition.load(std::memory_order_relaxed)))
+                    ended = true;
+
+                return false;
+            }
+        }
+    }
+
+    bool VorbisFileStream::read()
+    {
+        auto& fileData = static_cast<VorbisFileData&>(data);
+        const auto& section = fileData.getSection();
+
+        const auto generation = requestedGeneration.load(std::memory_order_acquire);
+        if (generation != readGeneration)
+        {
+            // restart from the first audio page, the mixer thread skips the data that has been read until now
+            readGeneration = generation;
+            filePosition = fileData.getHeaders().size();
+            endOfFile = false;
+            restartPosition.store(writePosition.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            restartedGeneration.store(generation, std::memory_order_release);
+        }
+
+        if (endOfFile) return false;
+
+        // read in large blocks
+        const auto position = writePosition.load(std::memory_order_relaxed);
+        const auto freeSize = buffer.size() - (position - readPosition.load(std::memory_order_acquire));
+        if (freeSize < buffer.size() / 4) return false;
+
+        if (!file.is_open())
+        {
+            file.open(section.path, std::ios::binary);
+
+            if (!file)
+            {
+                endOfFile = true;
+                endGeneration.store(generation, std::memory_order_release);
+                throw std::runtime_error("Failed to open Vorbis stream");
+            }
+        }
+
+        const auto offset = position % buffer.size();
+        const auto size = std::min({freeSize, buffer.size() - offset, section.size - filePosition});
+
+        file.seekg(section.offset + static_cast<std::streamoff>(filePosition), std::ios::beg);
+        file.read(reinterpret_cast<char*>(&buffer[offset]), static_cast<std::streamsize>(size));
+
+        const auto readSize = static_cast<std::size_t>(file.gcount());
+        filePosition += readSize;
+        writePosition.store(position + readSize, std::memory_order_release);
+
+        if (readSize < size || filePosition == section.size)
+        {
+            file.clear();
+            endOfFile = true;
+            endGeneration.store(generation, std::memory_order_release);
+        }
+
+        return readSize > 0;
+    }
+
+    VorbisClip::VorbisClip(Audio& initAudio, const storage::FileData& initData):
+        Sound(initAudio,
+              initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisData(initData, initAudio.getPcmCache()))),
+              Sound::Format::vorbis)
+    {
+    }
+
+    VorbisClip::VorbisClip(Audio& initAudio, const storage::Path& filename, std::size_t prefetchSize):
         Sound(initAudio,
-              initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisData(initData))),
+              initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisFileData(initAudio.getStreamer(),
+                                                                                        engine->getFileSystem().getFileSection(filename),
+                                                                                        prefetchSize))),
               Sound::Format::vorbis)
     {
     }
@@ -6,18 +6,29 @@
 #include <cstdint>
 #include <vector>
 #include "Sound.hpp"
+#include "../storage/FileData.hpp"
+#include "../storage/Path.hpp"
 
 namespace ouzel::audio
 {
-    class VorbisData;
+    namespace mixer
+    {
+        class Data;
+    }
 
     class VorbisClip final: public Sound
     {
     public:
-        VorbisClip(Audio& initAudio, const std::vector<std::byte>& initData);
+        VorbisClip(Audio& initAudio, const storage::FileData& initData);
+
+        // streams the file from the disk instead of loading it into memory, each voice prefetches up to
+        // prefetchSize bytes of compressed data
+        VorbisClip(Audio& initAudio, const storage::Path& filename, std::size_t prefetchSize = 65536);
+
+        mixer::Data& getData() const noexcept final { return *data; }
 
     private:
-        VorbisData* data;
+        mixer::Data* data;
     };
 }
 
@@ -8,6 +8,7 @@
 #include "ALSAAudioDevice.hpp"
 #include "../../core/Engine.hpp"
 #include "../../utils/Log.hpp"
+#include "../../utils/Profiler.hpp"
 
 namespace ouzel::audio::alsa
 {
@@ -126,6 +127,7 @@ namespace ouzel::audio::alsa
     void AudioDevice::run()
     {
         thread::setCurrentThreadName("Audio");
+        OUZEL_PROFILE_THREAD("Audio");
 
         while (running)
         {
@@ -138,6 +140,7 @@ namespace ouzel::audio::alsa
                     if (frames == -EPIPE)
                     {
                         logger.log(Log::Level::warning) << "Buffer underrun occurred";
+                        reportUnderrun();
 
                         if (const auto result = snd_pcm_prepare(playbackHandle); result < 0)
                             throw std::system_error(-result, std::system_category(), "Failed to prepare audio interface");
@@ -165,6 +168,7 @@ namespace ouzel::audio::alsa
                     if (result == -EPIPE)
                     {
                         logger.log(Log::Level::warning) << "Buffer underrun occurred";
+                        reportUnderrun();
 
                         if (const auto result = snd_pcm_prepare(playbackHandle); result < 0)
                             throw std::system_error(-result, std::system_category(), "Failed to prepare audio interface");
@@ -9,6 +9,7 @@
 #include "DSErrorCategory.hpp"
 #include "../../core/Engine.hpp"
 #include "../../core/Window.hpp"
+#include "../../utils/Profiler.hpp"
 
 #ifndef WAVE_FORMAT_IEEE_FLOAT
 #  define WAVE_FORMAT_IEEE_FLOAT 0x0003
@@ -188,6 +189,7 @@ namespace ouzel::audio::directsound
     void AudioDevice::run()
     {
         thread::setCurrentThreadName("Audio");
+        OUZEL_PROFILE_THREAD("Audio");
 
         while (running)
         {
@@ -0,0 +1,82 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <chrono>
+#include "EmptyAudioDevice.hpp"
+#include "../../core/Engine.hpp"
+#include "../../utils/Log.hpp"
+#include "../../utils/Profiler.hpp"
+
+namespace ouzel::audio::empty
+{
+    AudioDevice::AudioDevice(const Settings& settings,
+                             const std::function<void(std::uint32_t frames,
+                                                      std::uint32_t channels,
+                                                      std::uint32_t sampleRate,
+                                                      std::vector<float>& samples)>& initDataGetter):
+        audio::AudioDevice(Driver::empty, settings, initDataGetter)
+    {
+        sampleFormat = SampleFormat::float32;
+    }
+
+    AudioDevice::~AudioDevice()
+    {
+        running = false;
+#if !defined(__EMSCRIPTEN__)
+        if (audioThread.isJoinable()) audioThread.join();
+#endif
+    }
+
+    void AudioDevice::start()
+    {
+#if !defined(__EMSCRIPTEN__)
+        running = true;
+        audioThread = thread::Thread(&AudioDevice::run, this);
+#endif
+    }
+
+    void AudioDevice::stop()
+    {
+        running = false;
+#if !defined(__EMSCRIPTEN__)
+        if (audioThread.isJoinable()) audioThread.join();
+#endif
+    }
+
+    void AudioDevice::run()
+    {
+        thread::setCurrentThreadName("Audio");
+        OUZEL_PROFILE_THREAD("Audio");
+
+        const auto bufferDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(static_cast<double>(bufferSize) / sampleRate));
+        auto nextBufferTime = std::chrono::steady_clock::now();
+        std::size_t failedBufferCount = 0;
+
+        while (running)
+        {
+            try
+            {
+                getData(bufferSize, data);
+
+                if (failedBufferCount > 1)
+                    logger.log(Log::Level::error) << "Failed to get " << failedBufferCount - 1 << " more buffers";
+                failedBufferCount = 0;
+            }
+            catch (const std::exception& e)
+            {
+                // only the first of the consecutive failures is logged
+                if (failedBufferCount++ == 0)
+                    logger.log(Log::Level::error) << e.what();
+            }
+
+            // don't try to catch up if the mixing fell behind
+            const auto currentTime = std::chrono::steady_clock::now();
+            nextBufferTime += bufferDuration;
+            if (nextBufferTime < currentTime) nextBufferTime = currentTime;
+
+            std::this_thread::sleep_until(nextBufferTime);
+        }
+
+        if (failedBufferCount > 1)
+            logger.log(Log::Level::error) << "Failed to get " << failedBufferCount - 1 << " more buffers";
+    }
+}
@@ -3,10 +3,14 @@
 #ifndef OUZEL_AUDIO_EMPTYAUDIODEVICE_HPP
 #define OUZEL_AUDIO_EMPTYAUDIODEVICE_HPP
 
+#include <atomic>
+#include <vector>
 #include "../AudioDevice.hpp"
+#include "../../thread/Thread.hpp"
 
 namespace ouzel::audio::empty
 {
+    // pulls the mixed samples in real time and discards them
     class AudioDevice final: public audio::AudioDevice
     {
     public:
@@ -14,13 +18,21 @@ namespace ouzel::audio::empty
                     const std::function<void(std::uint32_t frames,
                                              std::uint32_t channels,
                                              std::uint32_t sampleRate,
-                                             std::vector<float>& samples)>& initDataGetter):
-            audio::AudioDevice(Driver::empty, settings, initDataGetter)
-        {
-        }
+                                             std::vector<float>& samples)>& initDataGetter);
+        ~AudioDevice() override;
 
-        void start() final {}
-        void stop() final {}
+        void start() final;
+        void stop() final;
+
+    private:
+        void run();
+
+        std::vector<std::uint8_t> data;
+
+        std::atomic_bool running{false};
+#if !defined(__EMSCRIPTEN__)
+        thread::Thread audioThread;
+#endif
     };
 }
 
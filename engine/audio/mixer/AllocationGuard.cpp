@@ -0,0 +1,74 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include "AllocationGuard.hpp"
+
+#if OUZEL_CHECK_AUDIO_ALLOCATIONS
+#  include <cassert>
+#  include <cstdlib>
+#  include <new>
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        thread_local unsigned int guardCount = 0;
+
+        void* allocate(std::size_t size)
+        {
+            assert(guardCount == 0 && "Heap allocation while mixing audio");
+
+            if (void* result = std::malloc(size ? size : 1))
+                return result;
+
+            throw std::bad_alloc();
+        }
+
+        void deallocate(void* pointer) noexcept
+        {
+            assert((!pointer || guardCount == 0) && "Heap deallocation while mixing audio");
+            std::free(pointer);
+        }
+    }
+
+    AllocationGuard::AllocationGuard() noexcept
+    {
+        ++guardCount;
+    }
+
+    AllocationGuard::~AllocationGuard()
+    {
+        --guardCount;
+    }
+}
+
+// the replaced global allocation functions are linked in together with the guard
+void* operator new(std::size_t size)
+{
+    return ouzel::audio::mixer::allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return ouzel::audio::mixer::allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    ouzel::audio::mixer::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    ouzel::audio::mixer::deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    ouzel::audio::mixer::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    ouzel::audio::mixer::deallocate(pointer);
+}
+#endif
@@ -0,0 +1,30 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_ALLOCATIONGUARD_HPP
+#define OUZEL_AUDIO_MIXER_ALLOCATIONGUARD_HPP
+
+#include "../../core/Setup.h"
+
+#if OUZEL_CHECK_AUDIO_ALLOCATIONS
+namespace ouzel::audio::mixer
+{
+    // asserts on every heap allocation and deallocation made by the current thread while the guard exists
+    class AllocationGuard final
+    {
+    public:
+        AllocationGuard() noexcept;
+        ~AllocationGuard();
+
+        AllocationGuard(const AllocationGuard&) = delete;
+        AllocationGuard& operator=(const AllocationGuard&) = delete;
+        AllocationGuard(AllocationGuard&&) = delete;
+        AllocationGuard& operator=(AllocationGuard&&) = delete;
+    };
+}
+
+#  define OUZEL_AUDIO_ALLOCATION_GUARD() ouzel::audio::mixer::AllocationGuard allocationGuard
+#else
+#  define OUZEL_AUDIO_ALLOCATION_GUARD()
+#endif
+
+#endif // OUZEL_AUDIO_MIXER_ALLOCATIONGUARD_HPP
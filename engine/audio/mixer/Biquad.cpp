@@ -0,0 +1,249 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include "Biquad.hpp"
+#include "../../core/Engine.hpp"
+#include "../../math/Constants.hpp"
+
+namespace ouzel::audio::mixer
+{
+    Biquad::Coefficients Biquad::getCoefficients(Type type, std::uint32_t sampleRate,
+                                                 float frequency, float q, float gain) noexcept
+    {
+        // keep the frequency below the Nyquist frequency
+        const auto nyquist = static_cast<float>(sampleRate) / 2.0F;
+        const auto w0 = 2.0F * pi<float> * std::clamp(frequency, 1.0F, nyquist * 0.99F) / static_cast<float>(sampleRate);
+        const auto cosW0 = std::cos(w0);
+        const auto alpha = std::sin(w0) / (2.0F * std::max(q, 0.01F));
+        const auto a = std::pow(10.0F, gain / 40.0F);
+        const auto shelfAlpha = 2.0F * std::sqrt(a) * alpha;
+
+        float b0 = 1.0F, b1 = 0.0F, b2 = 0.0F;
+        float a0 = 1.0F, a1 = 0.0F, a2 = 0.0F;
+
+        switch (type)
+        {
+            case Type::lowPass:
+                b0 = (1.0F - cosW0) / 2.0F;
+                b1 = 1.0F - cosW0;
+                b2 = (1.0F - cosW0) / 2.0F;
+                a0 = 1.0F + alpha;
+                a1 = -2.0F * cosW0;
+                a2 = 1.0F - alpha;
+                break;
+            case Type::highPass:
+                b0 = (1.0F + cosW0) / 2.0F;
+                b1 = -(1.0F + cosW0);
+                b2 = (1.0F + cosW0) / 2.0F;
+                a0 = 1.0F + alpha;
+                a1 = -2.0F * cosW0;
+                a2 = 1.0F - alpha;
+                break;
+            case Type::bandPass: // 0 dB peak gain
+                b0 = alpha;
+                b1 = 0.0F;
+                b2 = -alpha;
+                a0 = 1.0F + alpha;
+                a1 = -2.0F * cosW0;
+                a2 = 1.0F - alpha;
+                break;
+            case Type::lowShelf:
+                b0 = a * ((a + 1.0F) - (a - 1.0F) * cosW0 + shelfAlpha);
+                b1 = 2.0F * a * ((a - 1.0F) - (a + 1.0F) * cosW0);
+                b2 = a * ((a + 1.0F) - (a - 1.0F) * cosW0 - shelfAlpha);
+                a0 = (a + 1.0F) + (a - 1.0F) * cosW0 + shelfAlpha;
+                a1 = -2.0F * ((a - 1.0F) + (a + 1.0F) * cosW0);
+                a2 = (a + 1.0F) + (a - 1.0F) * cosW0 - shelfAlpha;
+                break;
+            case Type::highShelf:
+                b0 = a * ((a + 1.0F) + (a - 1.0F) * cosW0 + shelfAlpha);
+                b1 = -2.0F * a * ((a - 1.0F) + (a + 1.0F) * cosW0);
+                b2 = a * ((a + 1.0F) + (a - 1.0F) * cosW0 - shelfAlpha);
+                a0 = (a + 1.0F) - (a - 1.0F) * cosW0 + shelfAlpha;
+                a1 = 2.0F * ((a - 1.0F) - (a + 1.0F) * cosW0);
+                a2 = (a + 1.0F) - (a - 1.0F) * cosW0 - shelfAlpha;
+                break;
+            case Type::peaking:
+                b0 = 1.0F + alpha * a;
+                b1 = -2.0F * cosW0;
+                b2 = 1.0F - alpha * a;
+                a0 = 1.0F + alpha / a;
+                a1 = -2.0F * cosW0;
+                a2 = 1.0F - alpha / a;
+                break;
+        }
+
+        return Coefficients{b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+    }
+
+    namespace
+    {
+        void advance(Biquad::Coefficients& c, const Biquad::Coefficients& delta) noexcept
+        {
+            c.b0 += delta.b0; c.b1 += delta.b1; c.b2 += delta.b2; c.a1 += delta.a1; c.a2 += delta.a2;
+        }
+
+        // filters the frames of one channel starting from the given state and the coefficients of the first frame
+        void filter(float* samples, std::uint32_t frames, float& s1, float& s2,
+                    Biquad::Coefficients c, const Biquad::Coefficients& delta) noexcept
+        {
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+            {
+                advance(c, delta);
+
+                const auto x = samples[frame];
+                const auto y = c.b0 * x + s1;
+                s1 = c.b1 * x + s2 - c.a1 * y;
+                s2 = c.b2 * x - c.a2 * y;
+                samples[frame] = y;
+            }
+        }
+
+#if defined(__ARM_NEON__)
+        void transpose(float32x4_t& r0, float32x4_t& r1, float32x4_t& r2, float32x4_t& r3) noexcept
+        {
+            const auto t01 = vtrnq_f32(r0, r1);
+            const auto t23 = vtrnq_f32(r2, r3);
+            r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+            r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+            r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+            r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+        }
+#endif
+    }
+
+    void Biquad::resize(std::uint32_t newChannels)
+    {
+        channels = newChannels;
+        z1.assign(channels, 0.0F);
+        z2.assign(channels, 0.0F);
+    }
+
+    void Biquad::reset() noexcept
+    {
+        std::fill(z1.begin(), z1.end(), 0.0F);
+        std::fill(z2.begin(), z2.end(), 0.0F);
+    }
+
+    void Biquad::process(float* samples, std::uint32_t frames) noexcept
+    {
+        if (!frames) return;
+
+        // interpolate the coefficients linearly from the current ones to the target during the block
+        const auto step = 1.0F / static_cast<float>(frames);
+        const Coefficients delta{
+            (target.b0 - coefficients.b0) * step,
+            (target.b1 - coefficients.b1) * step,
+            (target.b2 - coefficients.b2) * step,
+            (target.a1 - coefficients.a1) * step,
+            (target.a2 - coefficients.a2) * step
+        };
+
+        std::uint32_t channel = 0;
+
+        if (core::isSimdAvailable)
+        {
+            // each group of four channels is filtered in blocks of four frames, the block is transposed, so that
+            // every vector holds one frame of the four channels, the recursion runs over the frames, so the remaining
+            // channels (e.g. both channels of a stereo bus) are filtered by the scalar code
+#if defined(__ARM_NEON__)
+            for (; channel + 4 <= channels; channel += 4)
+            {
+                float* channelSamples[4];
+                for (std::uint32_t lane = 0; lane < 4; ++lane)
+                    channelSamples[lane] = samples + (channel + lane) * frames;
+
+                auto s1 = vld1q_f32(&z1[channel]);
+                auto s2 = vld1q_f32(&z2[channel]);
+                Coefficients c = coefficients;
+
+                std::uint32_t frame = 0;
+                for (; frame + 4 <= frames; frame += 4)
+                {
+                    float32x4_t x[4];
+                    for (std::uint32_t lane = 0; lane < 4; ++lane)
+                        x[lane] = vld1q_f32(channelSamples[lane] + frame);
+
+                    transpose(x[0], x[1], x[2], x[3]);
+
+                    for (auto& value : x)
+                    {
+                        advance(c, delta);
+
+                        const auto y = vmlaq_n_f32(s1, value, c.b0);
+                        s1 = vmlsq_n_f32(vmlaq_n_f32(s2, value, c.b1), y, c.a1);
+                        s2 = vmlsq_n_f32(vmulq_n_f32(value, c.b2), y, c.a2);
+                        value = y;
+                    }
+
+                    transpose(x[0], x[1], x[2], x[3]);
+
+                    for (std::uint32_t lane = 0; lane < 4; ++lane)
+                        vst1q_f32(channelSamples[lane] + frame, x[lane]);
+                }
+
+                vst1q_f32(&z1[channel], s1);
+                vst1q_f32(&z2[channel], s2);
+
+                for (std::uint32_t lane = 0; lane < 4; ++lane)
+                    filter(channelSamples[lane] + frame, frames - frame, z1[channel + lane], z2[channel + lane], c, delta);
+            }
+#elif defined(__SSE__)
+            for (; channel + 4 <= channels; channel += 4)
+            {
+                float* channelSamples[4];
+                for (std::uint32_t lane = 0; lane < 4; ++lane)
+                    channelSamples[lane] = samples + (channel + lane) * frames;
+
+                auto s1 = _mm_loadu_ps(&z1[channel]);
+                auto s2 = _mm_loadu_ps(&z2[channel]);
+                Coefficients c = coefficients;
+
+                std::uint32_t frame = 0;
+                for (; frame + 4 <= frames; frame += 4)
+                {
+                    __m128 x[4];
+                    for (std::uint32_t lane = 0; lane < 4; ++lane)
+                        x[lane] = _mm_loadu_ps(channelSamples[lane] + frame);
+
+                    _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+
+                    for (auto& value : x)
+                    {
+                        advance(c, delta);
+
+                        const auto y = _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(c.b0)), s1);
+                        s1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(c.b1)), s2),
+                                        _mm_mul_ps(y, _mm_set1_ps(c.a1)));
+                        s2 = _mm_sub_ps(_mm_mul_ps(value, _mm_set1_ps(c.b2)),
+                                        _mm_mul_ps(y, _mm_set1_ps(c.a2)));
+                        value = y;
+                    }
+
+                    _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+
+                    for (std::uint32_t lane = 0; lane < 4; ++lane)
+                        _mm_storeu_ps(channelSamples[lane] + frame, x[lane]);
+                }
+
+                _mm_storeu_ps(&z1[channel], s1);
+                _mm_storeu_ps(&z2[channel], s2);
+
+                for (std::uint32_t lane = 0; lane < 4; ++lane)
+                    filter(channelSamples[lane] + frame, frames - frame, z1[channel + lane], z2[channel + lane], c, delta);
+            }
+#endif
+        }
+
+        for (; channel < channels; ++channel)
+            filter(samples + channel * frames, frames, z1[channel], z2[channel], coefficients, delta);
+
+        coefficients = target;
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_BIQUAD_HPP
+#define OUZEL_AUDIO_MIXER_BIQUAD_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::audio::mixer
+{
+    // second order IIR filter of all channels of a buffer (transposed direct form II)
+    class Biquad final
+    {
+    public:
+        enum class Type
+        {
+            lowPass,
+            highPass,
+            bandPass,
+            lowShelf,
+            highShelf,
+            peaking
+        };
+
+        // normalized so that a0 is 1
+        struct Coefficients final
+        {
+            float b0 = 1.0F;
+            float b1 = 0.0F;
+            float b2 = 0.0F;
+            float a1 = 0.0F;
+            float a2 = 0.0F;
+        };
+
+        // coefficients from the Audio EQ Cookbook, the gain (dB) is used only by the shelf and peaking filters
+        static Coefficients getCoefficients(Type type, std::uint32_t sampleRate,
+                                            float frequency, float q, float gain = 0.0F) noexcept;
+
+        // allocates the state, must not be called while mixing
+        void resize(std::uint32_t newChannels);
+        auto getChannels() const noexcept { return channels; }
+
+        void reset() noexcept;
+
+        // unless the change is immediate, the coefficients are interpolated during the next block to avoid zipper
+        // noise
+        void setCoefficients(const Coefficients& newCoefficients, bool immediate = false) noexcept
+        {
+            target = newCoefficients;
+            if (immediate) coefficients = newCoefficients;
+        }
+
+        // filters planar samples in place
+        void process(float* samples, std::uint32_t frames) noexcept;
+
+    private:
+        Coefficients coefficients;
+        Coefficients target;
+        std::uint32_t channels = 0;
+        std::vector<float> z1;
+        std::vector<float> z2;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_BIQUAD_HPP
@@ -3,12 +3,27 @@
 #include <algorithm>
 #include "Bus.hpp"
 #include "Data.hpp"
+#include "Kernels.hpp"
 #include "Processor.hpp"
 #include "Stream.hpp"
-#include "../../math/MathUtils.hpp"
 
 namespace ouzel::audio::mixer
 {
+    namespace
+    {
+        constexpr std::uint32_t maxSourceChannels = 6;
+    }
+
+    Bus::Bus(std::uint32_t initMaxFrames, std::uint32_t initChannels, std::uint32_t initSampleRate):
+        maxFrames(initMaxFrames),
+        channels(initChannels),
+        sampleRate(initSampleRate)
+    {
+        mixBuffer.reserve(maxFrames * std::max(channels, maxSourceChannels));
+        buffer.reserve(maxFrames * channels);
+        mixedSamples.reserve(maxFrames * channels);
+    }
+
     Bus::~Bus()
     {
         if (output) output->removeInput(this);
@@ -30,46 +45,23 @@ namespace ouzel::audio::mixer
         if (output) output->addInput(this);
     }
 
-    static void resample(std::uint32_t channels, std::uint32_t sourceFrames, const std::vector<float>& sourceSamples,
-                         std::uint32_t frames, std::vector<float>& samples)
+    void Bus::detach()
     {
-        if (sourceFrames != frames)
-        {
-            auto sourceIncrement = static_cast<float>(sourceFrames - 1) / static_cast<float>(frames - 1);
-            auto sourcePosition = 0.0F;
-
-            samples.resize(frames * channels);
+        setOutput(nullptr);
 
-            for (std::uint32_t frame = 0; frame < frames - 1; ++frame)
-            {
-                auto sourceCurrentFrame = static_cast<std::uint32_t>(sourcePosition);
-                auto fraction = sourcePosition - sourceCurrentFrame;
-
-                std::uint32_t sourceNextFrame = sourceCurrentFrame + 1;
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                {
-                    const auto sourceChannel = &sourceSamples[channel * sourceFrames];
-                    auto outputChannel = &samples[channel * frames];
+        for (Bus* inputBus : inputBuses)
+            inputBus->output = nullptr;
+        inputBuses.clear();
 
-                    outputChannel[frame] = ouzel::lerp(sourceChannel[sourceCurrentFrame],
-                                                       sourceChannel[sourceNextFrame],
-                                                       fraction);
-                }
+        for (Stream* stream : inputStreams)
+            stream->output = nullptr;
+        inputStreams.clear();
 
-                sourcePosition += sourceIncrement;
-            }
+        for (Processor* processor : processors)
+            processor->bus = nullptr;
+        processors.clear();
 
-            // fill the last frame of the destination with the last frame of the source
-            for (std::uint32_t channel = 0; channel < channels; ++channel)
-            {
-                const auto sourceChannel = &sourceSamples[channel * sourceFrames];
-                auto outputChannel = &samples[channel * frames];
-                outputChannel[frames - 1] = sourceChannel[sourceFrames - 1];
-            }
-        }
-        else
-            samples = sourceSamples;
+        Object::detach();
     }
 
     static void convert(std::uint32_t frames, std::uint32_t sourceChannels, const std::vector<float>& sourceSamples,
@@ -224,20 +216,36 @@ namespace ouzel::audio::mixer
             samples = sourceSamples;
     }
 
-    void Bus::getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                         const Vector3F& listenerPosition, const QuaternionF& listenerRotation,
-                         std::vector<float>& samples)
+    float Bus::getGain(const Vector3F& currentListenerPosition) const
     {
-        samples.resize(frames * channels);
-        std::fill(samples.begin(), samples.end(), 0.0F);
+        float gain = 1.0F;
+
+        for (const Processor* processor : processors)
+            if (processor->isEnabled())
+                gain *= processor->getGain(currentListenerPosition);
 
+        return gain;
+    }
+
+    void Bus::getSamples(std::uint32_t frames, std::uint32_t outputChannels, std::uint32_t outputSampleRate,
+                         std::vector<float>& samples)
+    {
         for (Bus* bus : inputBuses)
-        {
-            bus->getSamples(frames, channels, sampleRate, listenerPosition, listenerRotation, buffer);
+            bus->getSamples(frames, outputChannels, outputSampleRate, bus->mixedSamples);
 
-            for (std::size_t s = 0; s < samples.size(); ++s)
-                samples[s] += buffer[s];
-        }
+        mix(frames, outputChannels, outputSampleRate, samples);
+    }
+
+    void Bus::mix(std::uint32_t frames, std::uint32_t outputChannels, std::uint32_t outputSampleRate,
+                  std::vector<float>& samples)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        samples.resize(frames * outputChannels);
+        std::fill(samples.begin(), samples.end(), 0.0F);
+
+        for (const Bus* bus : inputBuses)
+            accumulate(samples.data(), bus->mixedSamples.data(), samples.size());
 
         for (Stream* stream : inputStreams)
         {
@@ -246,28 +254,49 @@ namespace ouzel::audio::mixer
                 const std::uint32_t sourceSampleRate = stream->getData().getSampleRate();
                 const std::uint32_t sourceChannels = stream->getData().getChannels();
 
-                if (sourceSampleRate != sampleRate)
+                if (stream->isVirtual())
                 {
-                    std::uint32_t sourceFrames = (frames * sourceSampleRate + sampleRate - 1) / sampleRate; // round up
+                    // virtual streams are not decoded, they only advance their position
+                    stream->skip((sourceSampleRate != outputSampleRate) ?
+                                 stream->resampler.skip(sourceChannels, sourceSampleRate, outputSampleRate, frames) :
+                                 frames);
+
+                    if (!stream->isPlaying()) stream->resampler.reset();
+                    continue;
+                }
+
+                if (sourceSampleRate != outputSampleRate)
+                {
+                    // the resampler of the stream requests exactly the source frames it needs
+                    const auto sourceFrames = stream->resampler.getSourceFrames(sourceChannels, sourceSampleRate, outputSampleRate, frames);
                     stream->getSamples(sourceFrames, resampleBuffer);
-                    resample(sourceChannels, sourceFrames, resampleBuffer, frames, mixBuffer);
+                    stream->resampler.resample(resampleBuffer, sourceFrames, frames, mixBuffer);
+
+                    // the tail of a finished stream is not played
+                    if (!stream->isPlaying()) stream->resampler.reset();
                 }
                 else
                     stream->getSamples(frames, mixBuffer);
 
-                if (sourceChannels != channels)
-                    convert(frames, sourceChannels, mixBuffer, channels, buffer);
+                if (sourceChannels != outputChannels)
+                {
+                    convert(frames, sourceChannels, mixBuffer, outputChannels, buffer);
+                    accumulate(samples.data(), buffer.data(), samples.size());
+                }
                 else
-                    buffer = mixBuffer;
-
-                for (std::size_t s = 0; s < samples.size(); ++s)
-                    samples[s] += buffer[s];
+                    accumulate(samples.data(), mixBuffer.data(), samples.size());
             }
         }
 
         for (Processor* processor : processors)
             if (processor->isEnabled())
-                processor->process(frames, channels, sampleRate, samples);
+            {
+                const auto processorStartTime = std::chrono::steady_clock::now();
+                processor->process(frames, outputChannels, outputSampleRate, samples);
+                processor->processingTime += std::chrono::steady_clock::now() - processorStartTime;
+            }
+
+        processingTime += std::chrono::steady_clock::now() - startTime;
     }
 
     void Bus::addProcessor(Processor* processor)
@@ -277,6 +306,7 @@ namespace ouzel::audio::mixer
         {
             if (processor->bus) processor->bus->removeProcessor(processor);
             processor->bus = this;
+            processor->prepare(maxFrames, channels, sampleRate);
             processors.push_back(processor);
         }
     }
@@ -306,7 +336,20 @@ namespace ouzel::audio::mixer
     void Bus::addInput(Stream* stream)
     {
         const auto i = std::find(inputStreams.begin(), inputStreams.end(), stream);
-        if (i == inputStreams.end()) inputStreams.push_back(stream);
+        if (i == inputStreams.end())
+        {
+            const auto& data = stream->getData();
+            if (data.getSampleRate() != sampleRate)
+            {
+                stream->resampler.prepare(data.getChannels(), data.getSampleRate(), sampleRate, maxFrames);
+
+                const auto resampleSize = stream->resampler.getMaxSourceFrames() * data.getChannels();
+                if (resampleBuffer.capacity() < resampleSize)
+                    resampleBuffer.reserve(resampleSize);
+            }
+
+            inputStreams.push_back(stream);
+        }
     }
 
     void Bus::removeInput(Stream* stream)
@@ -3,20 +3,27 @@
 #ifndef OUZEL_AUDIO_MIXER_BUS_HPP
 #define OUZEL_AUDIO_MIXER_BUS_HPP
 
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include "Object.hpp"
 
 namespace ouzel::audio::mixer
 {
+    class BusScheduler;
+    class Mixer;
     class Processor;
     class Stream;
 
     class Bus final: public Object
     {
+        friend BusScheduler;
+        friend Mixer;
         friend Processor;
         friend Stream;
     public:
-        Bus() noexcept {}
+        // the buffers are preallocated for blocks of up to maxFrames frames
+        Bus(std::uint32_t initMaxFrames, std::uint32_t initChannels, std::uint32_t initSampleRate);
         ~Bus() override;
         Bus(const Bus&) = delete;
         Bus& operator=(const Bus&) = delete;
@@ -24,11 +31,36 @@ namespace ouzel::audio::mixer
         Bus(Bus&&) = delete;
         Bus& operator=(Bus&&) = delete;
 
+        auto getOutput() const noexcept { return output; }
         void setOutput(Bus* newOutput);
 
-        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                        const Vector3F& listenerPosition, const QuaternionF& listenerRotation,
-                        std::vector<float>& samples);
+        // maximum number of streams of the bus that are mixed at once, zero for no limit
+        auto getMaxStreams() const noexcept { return maxStreams; }
+        void setMaxStreams(std::uint32_t newMaxStreams) { maxStreams = newMaxStreams; }
+
+        // the listener of the bus is used for the inputs of the bus instead of the listener of the output bus
+        auto hasListener() const noexcept { return listener; }
+        auto& getListenerPosition() const noexcept { return listenerPosition; }
+        auto& getListenerRotation() const noexcept { return listenerRotation; }
+        void setListener(bool newListener, const Vector3F& newPosition, const QuaternionF& newRotation)
+        {
+            listener = newListener;
+            listenerPosition = newPosition;
+            listenerRotation = newRotation;
+        }
+
+        // time spent mixing the streams of the bus and running its processors, excluding the input buses
+        auto getProcessingTime() const noexcept { return processingTime; }
+        void resetProcessingTime() noexcept { processingTime = {}; }
+
+        // estimated gain of the processors of the bus
+        float getGain(const Vector3F& currentListenerPosition) const;
+
+        void detach() override;
+
+        // mixes the bus and all of its inputs on the calling thread
+        void getSamples(std::uint32_t frames, std::uint32_t outputChannels, std::uint32_t outputSampleRate,
+                        std::vector<float>& samples) override;
 
         void addProcessor(Processor* processor);
         void removeProcessor(Processor* processor);
@@ -39,14 +71,34 @@ namespace ouzel::audio::mixer
         void addInput(Stream* stream);
         void removeInput(Stream* stream);
 
+        // mixes the streams and the mixed samples of the input buses and runs the processors
+        void mix(std::uint32_t frames, std::uint32_t outputChannels, std::uint32_t outputSampleRate,
+                 std::vector<float>& samples);
+
+        std::uint32_t maxFrames;
+        std::uint32_t channels;
+        std::uint32_t sampleRate;
+
         Bus* output = nullptr;
         std::vector<Bus*> inputBuses;
         std::vector<Stream*> inputStreams;
         std::vector<Processor*> processors;
 
+        std::uint32_t maxStreams = 0;
+        std::uint32_t activeStreamCount = 0; // number of streams that are not virtual, updated by the mixer
+
+        std::chrono::steady_clock::duration processingTime{};
+
+        bool listener = false;
+        Vector3F listenerPosition;
+        QuaternionF listenerRotation;
+
         std::vector<float> resampleBuffer;
         std::vector<float> mixBuffer;
         std::vector<float> buffer;
+        std::vector<float> mixedSamples; // output of the bus for the output bus
+
+        std::atomic<std::uint32_t> pendingInputCount{0}; // input buses that are not mixed yet, used by the scheduler
     };
 }
 
@@ -0,0 +1,187 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include "BusScheduler.hpp"
+#include "AllocationGuard.hpp"
+#include "Bus.hpp"
+#include "../../core/Engine.hpp"
+#include "../../utils/Log.hpp"
+#include "../../utils/Profiler.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        constexpr std::uint32_t maxWorkerCount = 8;
+
+        // handing the buses over to the workers costs more than mixing smaller graphs on one thread
+        constexpr std::size_t minParallelBusCount = 4;
+    }
+
+    BusScheduler::BusScheduler(std::uint32_t initWorkerCount)
+    {
+#if defined(__EMSCRIPTEN__)
+        static_cast<void>(initWorkerCount);
+#else
+        // the mixer thread mixes the buses too
+        const auto hardwareThreadCount = std::thread::hardware_concurrency();
+        const auto workerCount = std::min({initWorkerCount, maxWorkerCount,
+                                           hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0U});
+
+        workers.reserve(workerCount);
+        for (std::uint32_t i = 0; i < workerCount; ++i)
+            workers.emplace_back(&BusScheduler::workerMain, this);
+#endif
+    }
+
+    BusScheduler::~BusScheduler()
+    {
+        running.store(false, std::memory_order_release);
+        generation.increment();
+
+        for (auto& worker : workers)
+            if (worker.isJoinable()) worker.join();
+    }
+
+    void BusScheduler::reserve(std::size_t busCount)
+    {
+        if (readyBuses.size() < busCount)
+        {
+            buses.reserve(busCount);
+            stack.reserve(busCount);
+            readyBuses = std::vector<std::atomic<Bus*>>(busCount);
+        }
+    }
+
+    void BusScheduler::mix(Bus& master, std::uint32_t mixFrames, std::uint32_t mixChannels,
+                           std::uint32_t mixSampleRate, std::vector<float>& samples)
+    {
+        if (workers.empty())
+        {
+            master.getSamples(mixFrames, mixChannels, mixSampleRate, samples);
+            return;
+        }
+
+        // the buses are collected parents first, the storage is reserved for all of the buses of the mixer
+        buses.clear();
+        stack.clear();
+        stack.push_back(&master);
+        std::size_t leafCount = 0;
+
+        while (!stack.empty())
+        {
+            Bus* bus = stack.back();
+            stack.pop_back();
+            buses.push_back(bus);
+
+            bus->pendingInputCount.store(static_cast<std::uint32_t>(bus->inputBuses.size()), std::memory_order_relaxed);
+            if (bus->inputBuses.empty()) ++leafCount;
+
+            for (Bus* inputBus : bus->inputBuses)
+                stack.push_back(inputBus);
+        }
+
+        if (buses.size() < minParallelBusCount || leafCount < 2)
+        {
+            master.getSamples(mixFrames, mixChannels, mixSampleRate, samples);
+            return;
+        }
+
+        masterBus = &master;
+        masterSamples = &samples;
+        frames = mixFrames;
+        channels = mixChannels;
+        sampleRate = mixSampleRate;
+
+        for (std::size_t i = 0; i < buses.size(); ++i)
+            readyBuses[i].store(nullptr, std::memory_order_relaxed);
+        readIndex.store(0, std::memory_order_relaxed);
+        writeIndex.store(0, std::memory_order_relaxed);
+
+        for (Bus* bus : buses)
+            if (bus->inputBuses.empty()) push(bus);
+
+        // only as many workers as there are buses that can be mixed at once take part in the block
+        const auto workerCount = static_cast<std::uint32_t>(std::min(leafCount - 1, workers.size()));
+        activeWorkerCount.store(workerCount, std::memory_order_relaxed);
+        availableWorkerCount.store(workerCount, std::memory_order_release);
+
+        generation.increment();
+
+        run();
+
+        // the workers that have not woken up yet are not waited for
+        const auto lateWorkerCount = availableWorkerCount.exchange(0, std::memory_order_relaxed);
+        activeWorkerCount.fetch_sub(lateWorkerCount, std::memory_order_relaxed);
+
+        // the workers that joined the block hold on to its state until all of its buses are claimed
+        while (activeWorkerCount.load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+    }
+
+    void BusScheduler::workerMain()
+    {
+        thread::setCurrentThreadName("Mixer worker");
+        OUZEL_PROFILE_THREAD("Mixer worker");
+
+        auto currentGeneration = generation.load();
+
+        for (;;)
+        {
+            currentGeneration = generation.wait(currentGeneration);
+            if (!running.load(std::memory_order_acquire)) return;
+
+            // the workers that are not needed for the block go back to sleep
+            bool joined = false;
+            for (auto workerCount = availableWorkerCount.load(std::memory_order_relaxed); workerCount != 0 && !joined;)
+                joined = availableWorkerCount.compare_exchange_weak(workerCount, workerCount - 1, std::memory_order_acquire);
+
+            if (!joined) continue;
+
+            {
+                OUZEL_AUDIO_ALLOCATION_GUARD();
+                run();
+            }
+
+            activeWorkerCount.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void BusScheduler::run() noexcept
+    {
+        const auto busCount = buses.size();
+
+        for (;;)
+        {
+            const auto index = readIndex.fetch_add(1, std::memory_order_relaxed);
+            if (index >= busCount) break;
+
+            // every bus of the block becomes ready exactly once, so the claimed slot is filled eventually
+            Bus* bus;
+            while (!(bus = readyBuses[index].load(std::memory_order_acquire)))
+                std::this_thread::yield();
+
+            try
+            {
+                bus->mix(frames, channels, sampleRate, bus == masterBus ? *masterSamples : bus->mixedSamples);
+            }
+            catch (const std::exception& e)
+            {
+                logger.log(Log::Level::error) << e.what();
+            }
+
+            // the last mixed input makes the output bus ready
+            if (bus != masterBus &&
+                bus->output->pendingInputCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                push(bus->output);
+        }
+    }
+
+    void BusScheduler::push(Bus* bus) noexcept
+    {
+        const auto index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+        readyBuses[index].store(bus, std::memory_order_release);
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_BUSSCHEDULER_HPP
+#define OUZEL_AUDIO_MIXER_BUSSCHEDULER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "../../thread/Futex.hpp"
+#include "../../thread/Thread.hpp"
+
+namespace ouzel::audio::mixer
+{
+    class Bus;
+
+    // mixes the buses whose inputs are mixed in parallel on a pool of worker threads, a bus becomes ready when the
+    // last of its input buses is mixed, so the independent subtrees of the bus graph are mixed concurrently
+    class BusScheduler final
+    {
+    public:
+        // the worker count is limited by the number of hardware threads, zero mixes all of the buses on the calling
+        // thread
+        explicit BusScheduler(std::uint32_t initWorkerCount);
+        ~BusScheduler();
+
+        BusScheduler(const BusScheduler&) = delete;
+        BusScheduler& operator=(const BusScheduler&) = delete;
+
+        BusScheduler(BusScheduler&&) = delete;
+        BusScheduler& operator=(BusScheduler&&) = delete;
+
+        auto getWorkerCount() const noexcept { return static_cast<std::uint32_t>(workers.size()); }
+
+        // allocates the schedule for up to the given number of buses, must not be called while mixing
+        void reserve(std::size_t busCount);
+
+        // mixes the master bus and all of its inputs, graphs with too few independent buses are mixed serially on the
+        // calling thread
+        void mix(Bus& masterBus, std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                 std::vector<float>& samples);
+
+    private:
+        void workerMain();
+        void run() noexcept;
+        void push(Bus* bus) noexcept;
+
+        std::vector<thread::Thread> workers;
+
+        std::vector<Bus*> buses; // all of the buses of the current block
+        std::vector<Bus*> stack;
+        std::vector<std::atomic<Bus*>> readyBuses; // filled in the order the buses become ready
+
+        Bus* masterBus = nullptr;
+        std::vector<float>* masterSamples = nullptr;
+        std::uint32_t frames = 0;
+        std::uint32_t channels = 0;
+        std::uint32_t sampleRate = 0;
+
+        alignas(64) std::atomic<std::size_t> readIndex{0};
+        alignas(64) std::atomic<std::size_t> writeIndex{0};
+        alignas(64) std::atomic<std::uint32_t> availableWorkerCount{0}; // workers that can still join the block
+        alignas(64) std::atomic<std::uint32_t> activeWorkerCount{0}; // workers that have not finished the block
+
+        // incremented for every block that is mixed in parallel, the workers spin on it for a while before sleeping, so
+        // the mixer thread never takes a lock to wake them
+        thread::Futex generation;
+        std::atomic_bool running{true};
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_BUSSCHEDULER_HPP
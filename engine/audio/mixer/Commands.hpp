@@ -32,10 +32,13 @@ namespace ouzel::audio::mixer
             addProcessor,
             removeProcessor,
             setMasterBus,
+            setBusMaxStreams,
+            setBusListener,
             initStream,
             playStream,
             stopStream,
             setStreamOutput,
+            setStreamPriority,
             initData,
             initProcessor,
             updateProcessor
@@ -45,6 +48,9 @@ namespace ouzel::audio::mixer
         virtual ~Command() = default;
 
         const Type type;
+
+        // object removed from the mixer by this command, destroyed together with the command outside of the mixer thread
+        std::unique_ptr<Object> releasedObject;
     };
 
     class InitObjectCommand final: public Command
@@ -194,6 +200,40 @@ namespace ouzel::audio::mixer
         const ObjectId busId;
     };
 
+    class SetBusMaxStreamsCommand final: public Command
+    {
+    public:
+        constexpr SetBusMaxStreamsCommand(ObjectId initBusId,
+                                          std::uint32_t initMaxStreams) noexcept:
+            Command(Command::Type::setBusMaxStreams),
+            busId(initBusId),
+            maxStreams(initMaxStreams)
+        {}
+
+        const ObjectId busId;
+        const std::uint32_t maxStreams;
+    };
+
+    class SetBusListenerCommand final: public Command
+    {
+    public:
+        SetBusListenerCommand(ObjectId initBusId,
+                              bool initListener,
+                              const Vector3F& initPosition,
+                              const QuaternionF& initRotation) noexcept:
+            Command(Command::Type::setBusListener),
+            busId(initBusId),
+            listener(initListener),
+            position(initPosition),
+            rotation(initRotation)
+        {}
+
+        const ObjectId busId;
+        const bool listener;
+        const Vector3F position;
+        const QuaternionF rotation;
+    };
+
     class InitStreamCommand final: public Command
     {
     public:
@@ -247,6 +287,20 @@ namespace ouzel::audio::mixer
         const ObjectId busId;
     };
 
+    class SetStreamPriorityCommand final: public Command
+    {
+    public:
+        constexpr SetStreamPriorityCommand(ObjectId initStreamId,
+                                           std::int32_t initPriority) noexcept:
+            Command(Command::Type::setStreamPriority),
+            streamId(initStreamId),
+            priority(initPriority)
+        {}
+
+        const ObjectId streamId;
+        const std::int32_t priority;
+    };
+
     class InitDataCommand final: public Command
     {
     public:
@@ -0,0 +1,114 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "Convolver.hpp"
+#include "Kernels.hpp"
+
+namespace ouzel::audio::mixer
+{
+    ImpulseResponse::ImpulseResponse(std::uint32_t initBlockSize, std::uint32_t initChannels,
+                                     const std::vector<float>& samples):
+        blockSize(initBlockSize),
+        channels(initChannels)
+    {
+        const auto frames = channels ? static_cast<std::uint32_t>(samples.size() / channels) : 0;
+        partitionCount = std::max((frames + blockSize - 1) / blockSize, 1U);
+
+        real.resize(static_cast<std::size_t>(channels) * partitionCount * blockSize);
+        imaginary.resize(static_cast<std::size_t>(channels) * partitionCount * blockSize);
+
+        // each partition is padded with a block of silence
+        Fft fft(blockSize * 2);
+        std::vector<float> window(blockSize * 2);
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+            for (std::uint32_t partition = 0; partition < partitionCount; ++partition)
+            {
+                const auto start = partition * blockSize;
+                const auto count = std::min(blockSize, frames - start);
+                const auto source = samples.begin() + channel * frames + start;
+
+                std::fill(std::copy(source, source + count, window.begin()), window.end(), 0.0F);
+
+                const auto offset = (channel * partitionCount + partition) * blockSize;
+                fft.forward(window.data(), &real[offset], &imaginary[offset]);
+            }
+    }
+
+    void Convolver::prepare(std::shared_ptr<const ImpulseResponse> newImpulseResponse, std::uint32_t newChannels)
+    {
+        impulseResponse = std::move(newImpulseResponse);
+        channels = newChannels;
+        blockSize = impulseResponse->getBlockSize();
+        partitionCount = impulseResponse->getPartitionCount();
+
+        if (!fft || fft->getSize() != blockSize * 2)
+            fft = std::make_unique<Fft>(blockSize * 2);
+
+        const auto spectrumSize = static_cast<std::size_t>(channels) * partitionCount * blockSize;
+        inputWindow.resize(static_cast<std::size_t>(channels) * blockSize * 2);
+        inputReal.resize(spectrumSize);
+        inputImaginary.resize(spectrumSize);
+        accumulatorReal.resize(blockSize);
+        accumulatorImaginary.resize(blockSize);
+        outputWindow.resize(blockSize * 2);
+
+        reset();
+    }
+
+    void Convolver::reset() noexcept
+    {
+        std::fill(inputWindow.begin(), inputWindow.end(), 0.0F);
+        std::fill(inputReal.begin(), inputReal.end(), 0.0F);
+        std::fill(inputImaginary.begin(), inputImaginary.end(), 0.0F);
+        currentPartition = 0;
+    }
+
+    void Convolver::process(const float* input, float* output) noexcept
+    {
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            // slide the window by one block
+            float* window = &inputWindow[channel * blockSize * 2];
+            std::copy(window + blockSize, window + blockSize * 2, window);
+            std::copy(input + channel * blockSize, input + (channel + 1) * blockSize, window + blockSize);
+
+            const auto spectrumOffset = channel * partitionCount * blockSize;
+            fft->forward(window,
+                         &inputReal[spectrumOffset + currentPartition * blockSize],
+                         &inputImaginary[spectrumOffset + currentPartition * blockSize]);
+
+            // the impulse response channels are repeated if there are less of them than there are input channels
+            const auto impulseChannel = std::min(channel, impulseResponse->getChannels() - 1);
+
+            std::fill(accumulatorReal.begin(), accumulatorReal.end(), 0.0F);
+            std::fill(accumulatorImaginary.begin(), accumulatorImaginary.end(), 0.0F);
+
+            // multiply each input spectrum with the impulse response partition that matches its age
+            for (std::uint32_t partition = 0; partition < partitionCount; ++partition)
+            {
+                const auto inputPartition = (currentPartition + partitionCount - partition) % partitionCount;
+                const float* xr = &inputReal[spectrumOffset + inputPartition * blockSize];
+                const float* xi = &inputImaginary[spectrumOffset + inputPartition * blockSize];
+                const float* hr = impulseResponse->getReal(impulseChannel, partition);
+                const float* hi = impulseResponse->getImaginary(impulseChannel, partition);
+
+                // the first bin holds the real DC and Nyquist values, they are multiplied separately
+                const auto dc = accumulatorReal[0] + xr[0] * hr[0];
+                const auto nyquist = accumulatorImaginary[0] + xi[0] * hi[0];
+
+                complexMultiplyAccumulate(accumulatorReal.data(), accumulatorImaginary.data(),
+                                          xr, xi, hr, hi, blockSize);
+
+                accumulatorReal[0] = dc;
+                accumulatorImaginary[0] = nyquist;
+            }
+
+            // the second half of the circular convolution is the linear convolution of the last block
+            fft->inverse(accumulatorReal.data(), accumulatorImaginary.data(), outputWindow.data());
+            std::copy(outputWindow.begin() + blockSize, outputWindow.end(), output + channel * blockSize);
+        }
+
+        currentPartition = (currentPartition + 1) % partitionCount;
+    }
+}
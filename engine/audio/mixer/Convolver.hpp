@@ -0,0 +1,74 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_CONVOLVER_HPP
+#define OUZEL_AUDIO_MIXER_CONVOLVER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Fft.hpp"
+
+namespace ouzel::audio::mixer
+{
+    // impulse response split into partitions of the block size and transformed to the frequency domain
+    class ImpulseResponse final
+    {
+    public:
+        // the samples are planar, the block size must be a power of two
+        ImpulseResponse(std::uint32_t initBlockSize, std::uint32_t initChannels, const std::vector<float>& samples);
+
+        auto getBlockSize() const noexcept { return blockSize; }
+        auto getChannels() const noexcept { return channels; }
+        auto getPartitionCount() const noexcept { return partitionCount; }
+
+        const float* getReal(std::uint32_t channel, std::uint32_t partition) const noexcept
+        {
+            return &real[(channel * partitionCount + partition) * blockSize];
+        }
+
+        const float* getImaginary(std::uint32_t channel, std::uint32_t partition) const noexcept
+        {
+            return &imaginary[(channel * partitionCount + partition) * blockSize];
+        }
+
+    private:
+        std::uint32_t blockSize = 0;
+        std::uint32_t channels = 0;
+        std::uint32_t partitionCount = 0;
+        std::vector<float> real;
+        std::vector<float> imaginary;
+    };
+
+    // uniformly partitioned overlap-save convolution of blocks of the impulse response block size
+    class Convolver final
+    {
+    public:
+        // allocates the buffers, must not be called while mixing
+        void prepare(std::shared_ptr<const ImpulseResponse> newImpulseResponse, std::uint32_t newChannels);
+
+        auto getChannels() const noexcept { return channels; }
+        auto getBlockSize() const noexcept { return blockSize; }
+
+        void reset() noexcept;
+
+        // convolves one block of planar samples (channels are block size samples apart)
+        void process(const float* input, float* output) noexcept;
+
+    private:
+        std::shared_ptr<const ImpulseResponse> impulseResponse;
+        std::unique_ptr<Fft> fft;
+        std::uint32_t channels = 0;
+        std::uint32_t blockSize = 0;
+        std::uint32_t partitionCount = 0;
+        std::uint32_t currentPartition = 0;
+
+        std::vector<float> inputWindow; // last two input blocks of each channel
+        std::vector<float> inputReal; // spectra of the last partition count input windows of each channel
+        std::vector<float> inputImaginary;
+        std::vector<float> accumulatorReal;
+        std::vector<float> accumulatorImaginary;
+        std::vector<float> outputWindow;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_CONVOLVER_HPP
@@ -18,6 +18,10 @@ namespace ouzel::audio::mixer
         auto getChannels() const noexcept { return channels; }
         auto getSampleRate() const noexcept { return sampleRate; }
 
+        // the streams of streamed data depend on another thread to read the file, so they can output silence while
+        // waiting for it and must not be used to decode the whole data at once
+        auto isStreamed() const noexcept { return streamed; }
+
         /*virtual void getData(std::uint32_t frames,
                              std::uint32_t channels,
                              std::uint32_t sampleRate,
@@ -26,6 +30,7 @@ namespace ouzel::audio::mixer
     protected:
         std::uint32_t channels = 0;
         std::uint32_t sampleRate = 0;
+        bool streamed = false;
     };
 }
 
@@ -0,0 +1,68 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_DELAYLINE_HPP
+#define OUZEL_AUDIO_MIXER_DELAYLINE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Kernels.hpp"
+
+namespace ouzel::audio::mixer
+{
+    // circular buffer holding the last frames of one channel
+    class DelayLine final
+    {
+    public:
+        // allocates the buffer, must not be called while mixing
+        void resize(std::size_t frames)
+        {
+            buffer.assign(frames, 0.0F);
+            position = 0;
+        }
+
+        auto size() const noexcept { return buffer.size(); }
+
+        // replaces the samples with the samples written size() frames earlier
+        void delay(float* samples, std::size_t frames) noexcept
+        {
+            if (buffer.empty()) return;
+
+            for (std::size_t frame = 0; frame < frames;)
+            {
+                const auto count = std::min(frames - frame, buffer.size() - position);
+                std::swap_ranges(samples + frame, samples + frame + count, buffer.begin() + position);
+                advance(count);
+                frame += count;
+            }
+        }
+
+        // adds the output written size() frames earlier multiplied by the gain: y[n] = x[n] + gain * y[n - size()]
+        void feedback(float* samples, std::size_t frames, float gain) noexcept
+        {
+            if (buffer.empty()) return;
+
+            // a block can not be longer than the delay, so it never depends on itself
+            for (std::size_t frame = 0; frame < frames;)
+            {
+                const auto count = std::min(frames - frame, buffer.size() - position);
+                scaleAccumulate(samples + frame, &buffer[position], gain, count);
+                std::copy(samples + frame, samples + frame + count, buffer.begin() + position);
+                advance(count);
+                frame += count;
+            }
+        }
+
+    private:
+        void advance(std::size_t count) noexcept
+        {
+            position += count;
+            if (position == buffer.size()) position = 0;
+        }
+
+        std::vector<float> buffer;
+        std::size_t position = 0;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_DELAYLINE_HPP
@@ -0,0 +1,196 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cmath>
+#include <stdexcept>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include "Fft.hpp"
+#include "../../core/Engine.hpp"
+#include "../../math/Constants.hpp"
+
+namespace ouzel::audio::mixer
+{
+    Fft::Fft(std::size_t initSize):
+        size(initSize), halfSize(initSize / 2)
+    {
+        if (size < 4 || (size & (size - 1)) != 0)
+            throw std::runtime_error("FFT size must be a power of two");
+
+        std::uint32_t bits = 0;
+        while ((std::size_t{1} << bits) < halfSize) ++bits;
+
+        bitReversal.resize(halfSize);
+        for (std::uint32_t i = 0; i < halfSize; ++i)
+        {
+            std::uint32_t reversed = 0;
+            for (std::uint32_t bit = 0; bit < bits; ++bit)
+                if (i & (1U << bit)) reversed |= 1U << (bits - 1 - bit);
+            bitReversal[i] = reversed;
+        }
+
+        twiddleReal.reserve(halfSize);
+        twiddleImaginary.reserve(halfSize);
+
+        for (std::size_t half = 1; half < halfSize; half <<= 1)
+            for (std::size_t j = 0; j < half; ++j)
+            {
+                const auto angle = -pi<double> * static_cast<double>(j) / static_cast<double>(half);
+                twiddleReal.push_back(static_cast<float>(std::cos(angle)));
+                twiddleImaginary.push_back(static_cast<float>(std::sin(angle)));
+            }
+
+        splitReal.resize(halfSize);
+        splitImaginary.resize(halfSize);
+
+        for (std::size_t k = 0; k < halfSize; ++k)
+        {
+            const auto angle = -tau<double> * static_cast<double>(k) / static_cast<double>(size);
+            splitReal[k] = static_cast<float>(std::cos(angle));
+            splitImaginary[k] = static_cast<float>(std::sin(angle));
+        }
+
+        workReal.resize(halfSize);
+        workImaginary.resize(halfSize);
+    }
+
+    void Fft::forward(const float* input, float* real, float* imaginary) noexcept
+    {
+        // the even samples are the real and the odd samples the imaginary parts of a half size complex signal
+        for (std::size_t n = 0; n < halfSize; ++n)
+        {
+            workReal[bitReversal[n]] = input[n * 2];
+            workImaginary[bitReversal[n]] = input[n * 2 + 1];
+        }
+
+        transform(workReal.data(), workImaginary.data());
+
+        // DC and Nyquist bins
+        real[0] = workReal[0] + workImaginary[0];
+        imaginary[0] = workReal[0] - workImaginary[0];
+
+        for (std::size_t k = 1; k < halfSize; ++k)
+        {
+            // spectra of the even (e) and the odd (o) samples
+            const auto mirrorReal = workReal[halfSize - k];
+            const auto mirrorImaginary = -workImaginary[halfSize - k];
+            const auto er = (workReal[k] + mirrorReal) * 0.5F;
+            const auto ei = (workImaginary[k] + mirrorImaginary) * 0.5F;
+            const auto or_ = (workImaginary[k] - mirrorImaginary) * 0.5F;
+            const auto oi = (mirrorReal - workReal[k]) * 0.5F;
+
+            real[k] = er + splitReal[k] * or_ - splitImaginary[k] * oi;
+            imaginary[k] = ei + splitReal[k] * oi + splitImaginary[k] * or_;
+        }
+    }
+
+    void Fft::inverse(const float* real, const float* imaginary, float* output) noexcept
+    {
+        // combine the real spectrum back to the complex spectrum of the half size signal, it is conjugated, so that
+        // the forward transform can be used for the inverse one
+        workReal[0] = (real[0] + imaginary[0]) * 0.5F;
+        workImaginary[0] = -(real[0] - imaginary[0]) * 0.5F;
+
+        for (std::size_t k = 1; k < halfSize; ++k)
+        {
+            const auto mirrorReal = real[halfSize - k];
+            const auto mirrorImaginary = -imaginary[halfSize - k];
+            const auto er = (real[k] + mirrorReal) * 0.5F;
+            const auto ei = (imaginary[k] + mirrorImaginary) * 0.5F;
+            const auto dr = (real[k] - mirrorReal) * 0.5F;
+            const auto di = (imaginary[k] - mirrorImaginary) * 0.5F;
+
+            // multiply by the conjugated twiddle factor
+            const auto or_ = dr * splitReal[k] + di * splitImaginary[k];
+            const auto oi = di * splitReal[k] - dr * splitImaginary[k];
+
+            const auto index = bitReversal[k];
+            workReal[index] = er - oi;
+            workImaginary[index] = -(ei + or_);
+        }
+
+        transform(workReal.data(), workImaginary.data());
+
+        const auto factor = 1.0F / static_cast<float>(halfSize);
+        for (std::size_t n = 0; n < halfSize; ++n)
+        {
+            output[n * 2] = workReal[n] * factor;
+            output[n * 2 + 1] = -workImaginary[n] * factor;
+        }
+    }
+
+    void Fft::transform(float* real, float* imaginary) const noexcept
+    {
+        const float* stageTwiddleReal = twiddleReal.data();
+        const float* stageTwiddleImaginary = twiddleImaginary.data();
+
+        for (std::size_t half = 1; half < halfSize; half <<= 1)
+        {
+            for (std::size_t i = 0; i < halfSize; i += half * 2)
+            {
+                float* topReal = real + i;
+                float* topImaginary = imaginary + i;
+                float* bottomReal = real + i + half;
+                float* bottomImaginary = imaginary + i + half;
+
+                std::size_t j = 0;
+
+                if (core::isSimdAvailable)
+                {
+#if defined(__ARM_NEON__)
+                    for (; j + 4 <= half; j += 4)
+                    {
+                        const auto wr = vld1q_f32(stageTwiddleReal + j);
+                        const auto wi = vld1q_f32(stageTwiddleImaginary + j);
+                        const auto br = vld1q_f32(bottomReal + j);
+                        const auto bi = vld1q_f32(bottomImaginary + j);
+                        const auto vr = vmlsq_f32(vmulq_f32(br, wr), bi, wi);
+                        const auto vi = vmlaq_f32(vmulq_f32(br, wi), bi, wr);
+                        const auto tr = vld1q_f32(topReal + j);
+                        const auto ti = vld1q_f32(topImaginary + j);
+                        vst1q_f32(topReal + j, vaddq_f32(tr, vr));
+                        vst1q_f32(topImaginary + j, vaddq_f32(ti, vi));
+                        vst1q_f32(bottomReal + j, vsubq_f32(tr, vr));
+                        vst1q_f32(bottomImaginary + j, vsubq_f32(ti, vi));
+                    }
+#elif defined(__SSE__)
+                    for (; j + 4 <= half; j += 4)
+                    {
+                        const auto wr = _mm_loadu_ps(stageTwiddleReal + j);
+                        const auto wi = _mm_loadu_ps(stageTwiddleImaginary + j);
+                        const auto br = _mm_loadu_ps(bottomReal + j);
+                        const auto bi = _mm_loadu_ps(bottomImaginary + j);
+                        const auto vr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+                        const auto vi = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+                        const auto tr = _mm_loadu_ps(topReal + j);
+                        const auto ti = _mm_loadu_ps(topImaginary + j);
+                        _mm_storeu_ps(topReal + j, _mm_add_ps(tr, vr));
+                        _mm_storeu_ps(topImaginary + j, _mm_add_ps(ti, vi));
+                        _mm_storeu_ps(bottomReal + j, _mm_sub_ps(tr, vr));
+                        _mm_storeu_ps(bottomImaginary + j, _mm_sub_ps(ti, vi));
+                    }
+#endif
+                }
+
+                for (; j < half; ++j)
+                {
+                    const auto wr = stageTwiddleReal[j];
+                    const auto wi = stageTwiddleImaginary[j];
+                    const auto vr = bottomReal[j] * wr - bottomImaginary[j] * wi;
+                    const auto vi = bottomReal[j] * wi + bottomImaginary[j] * wr;
+                    const auto tr = topReal[j];
+                    const auto ti = topImaginary[j];
+                    topReal[j] = tr + vr;
+                    topImaginary[j] = ti + vi;
+                    bottomReal[j] = tr - vr;
+                    bottomImaginary[j] = ti - vi;
+                }
+            }
+
+            stageTwiddleReal += half;
+            stageTwiddleImaginary += half;
+        }
+    }
+}
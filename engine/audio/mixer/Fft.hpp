@@ -0,0 +1,44 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_FFT_HPP
+#define OUZEL_AUDIO_MIXER_FFT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::audio::mixer
+{
+    // fast Fourier transform of real signals with a power of two size, the spectrum of size / 2 bins is stored in
+    // split format (real and imaginary parts in separate arrays) with the real part of the Nyquist bin packed into
+    // the imaginary part of the DC bin
+    class Fft final
+    {
+    public:
+        // allocates the tables, must not be called while mixing
+        explicit Fft(std::size_t initSize);
+
+        auto getSize() const noexcept { return size; }
+
+        void forward(const float* input, float* real, float* imaginary) noexcept;
+
+        // the result is normalized, so that inverse(forward(x)) == x
+        void inverse(const float* real, const float* imaginary, float* output) noexcept;
+
+    private:
+        // in-place radix-2 complex transform of size / 2 points
+        void transform(float* real, float* imaginary) const noexcept;
+
+        std::size_t size = 0;
+        std::size_t halfSize = 0;
+        std::vector<std::uint32_t> bitReversal;
+        std::vector<float> twiddleReal; // twiddle factors of each stage one after another
+        std::vector<float> twiddleImaginary;
+        std::vector<float> splitReal; // twiddle factors that split the complex spectrum into the real one
+        std::vector<float> splitImaginary;
+        std::vector<float> workReal;
+        std::vector<float> workImaginary;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_FFT_HPP
@@ -0,0 +1,504 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include "Kernels.hpp"
+#include "../../core/Engine.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        constexpr float int16Scale = 32767.0F;
+        constexpr float randomScale = 1.0F / 16777216.0F; // 2^-24
+
+        inline std::uint32_t nextRandom(std::uint32_t& state) noexcept
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        inline std::int16_t toInt16(float sample, std::uint32_t& state) noexcept
+        {
+            // the difference of two uniform random numbers has a triangular distribution in the range (-1, 1)
+            const auto noise = static_cast<float>(nextRandom(state) >> 8) * randomScale -
+                static_cast<float>(nextRandom(state) >> 8) * randomScale;
+            const auto value = std::clamp(sample * int16Scale + noise, -32768.0F, 32767.0F);
+            return static_cast<std::int16_t>(std::lrint(value));
+        }
+
+#if defined(__ARM_NEON__)
+        inline float32x4_t nextNoise(uint32x4_t& state) noexcept
+        {
+            state = veorq_u32(state, vshlq_n_u32(state, 13));
+            state = veorq_u32(state, vshrq_n_u32(state, 17));
+            state = veorq_u32(state, vshlq_n_u32(state, 5));
+            const auto first = vcvtq_f32_u32(vshrq_n_u32(state, 8));
+
+            state = veorq_u32(state, vshlq_n_u32(state, 13));
+            state = veorq_u32(state, vshrq_n_u32(state, 17));
+            state = veorq_u32(state, vshlq_n_u32(state, 5));
+            const auto second = vcvtq_f32_u32(vshrq_n_u32(state, 8));
+
+            return vmulq_n_f32(vsubq_f32(first, second), randomScale);
+        }
+
+        inline int16x4_t toInt16(float32x4_t samples, uint32x4_t& state) noexcept
+        {
+            const auto value = vaddq_f32(vmulq_n_f32(samples, int16Scale), nextNoise(state));
+            // round half away from zero, vqmovn saturates to the 16-bit range
+            const auto half = vbslq_f32(vcltq_f32(value, vdupq_n_f32(0.0F)), vdupq_n_f32(-0.5F), vdupq_n_f32(0.5F));
+            return vqmovn_s32(vcvtq_s32_f32(vaddq_f32(value, half)));
+        }
+#elif defined(__SSE2__)
+        inline __m128 nextNoise(__m128i& state) noexcept
+        {
+            state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+            state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+            state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+            const auto first = _mm_cvtepi32_ps(_mm_srli_epi32(state, 8));
+
+            state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+            state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+            state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+            const auto second = _mm_cvtepi32_ps(_mm_srli_epi32(state, 8));
+
+            return _mm_mul_ps(_mm_sub_ps(first, second), _mm_set1_ps(randomScale));
+        }
+
+        // returns four 32-bit integers, _mm_packs_epi32 saturates them to the 16-bit range
+        inline __m128i toInt32(__m128 samples, __m128i& state) noexcept
+        {
+            const auto value = _mm_add_ps(_mm_mul_ps(samples, _mm_set1_ps(int16Scale)), nextNoise(state));
+            return _mm_cvtps_epi32(value);
+        }
+#endif
+    }
+
+    void accumulate(float* destination, const float* source, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(destination + i, vaddq_f32(vld1q_f32(destination + i), vld1q_f32(source + i)));
+#elif defined(__AVX__)
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_loadu_ps(destination + i), _mm256_loadu_ps(source + i)));
+#elif defined(__SSE__)
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_loadu_ps(source + i)));
+#endif
+        }
+
+        for (; i < count; ++i)
+            destination[i] += source[i];
+    }
+
+    void scaleAccumulate(float* destination, const float* source, float factor, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(destination + i, vmlaq_n_f32(vld1q_f32(destination + i), vld1q_f32(source + i), factor));
+#elif defined(__AVX__)
+            const auto f = _mm256_set1_ps(factor);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_loadu_ps(destination + i),
+                                                                _mm256_mul_ps(_mm256_loadu_ps(source + i), f)));
+#elif defined(__SSE__)
+            const auto f = _mm_set1_ps(factor);
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i),
+                                                          _mm_mul_ps(_mm_loadu_ps(source + i), f)));
+#endif
+        }
+
+        for (; i < count; ++i)
+            destination[i] += source[i] * factor;
+    }
+
+    void scale(float* samples, float factor, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), factor));
+#elif defined(__AVX__)
+            const auto f = _mm256_set1_ps(factor);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), f));
+#elif defined(__SSE__)
+            const auto f = _mm_set1_ps(factor);
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), f));
+#endif
+        }
+
+        for (; i < count; ++i)
+            samples[i] *= factor;
+    }
+
+    void scaleRamp(float* samples, float startFactor, float endFactor, std::size_t count) noexcept
+    {
+        if (!count) return;
+
+        const auto step = (endFactor - startFactor) / static_cast<float>(count);
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            const float offsets[4] = {1.0F, 2.0F, 3.0F, 4.0F};
+            auto f = vmlaq_n_f32(vdupq_n_f32(startFactor), vld1q_f32(offsets), step);
+            const auto increment = vdupq_n_f32(step * 4.0F);
+            for (; i + 4 <= count; i += 4)
+            {
+                vst1q_f32(samples + i, vmulq_f32(vld1q_f32(samples + i), f));
+                f = vaddq_f32(f, increment);
+            }
+#elif defined(__AVX__)
+            auto f = _mm256_add_ps(_mm256_set1_ps(startFactor),
+                                   _mm256_mul_ps(_mm256_setr_ps(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F),
+                                                 _mm256_set1_ps(step)));
+            const auto increment = _mm256_set1_ps(step * 8.0F);
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), f));
+                f = _mm256_add_ps(f, increment);
+            }
+#elif defined(__SSE__)
+            auto f = _mm_add_ps(_mm_set1_ps(startFactor),
+                                _mm_mul_ps(_mm_setr_ps(1.0F, 2.0F, 3.0F, 4.0F), _mm_set1_ps(step)));
+            const auto increment = _mm_set1_ps(step * 4.0F);
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), f));
+                f = _mm_add_ps(f, increment);
+            }
+#endif
+        }
+
+        for (; i < count; ++i)
+            samples[i] *= startFactor + step * static_cast<float>(i + 1);
+    }
+
+    float dot(const float* first, const float* second, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+        float result = 0.0F;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            auto sum = vdupq_n_f32(0.0F);
+            for (; i + 4 <= count; i += 4)
+                sum = vmlaq_f32(sum, vld1q_f32(first + i), vld1q_f32(second + i));
+
+            const auto pairs = vpadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+            result = vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+#elif defined(__AVX__)
+            auto sum = _mm256_setzero_ps();
+            for (; i + 8 <= count; i += 8)
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(first + i), _mm256_loadu_ps(second + i)));
+
+            auto halves = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+            halves = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+            result = _mm_cvtss_f32(_mm_add_ss(halves, _mm_shuffle_ps(halves, halves, _MM_SHUFFLE(1, 1, 1, 1))));
+#elif defined(__SSE__)
+            auto sum = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(first + i), _mm_loadu_ps(second + i)));
+
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            result = _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1))));
+#endif
+        }
+
+        for (; i < count; ++i)
+            result += first[i] * second[i];
+
+        return result;
+    }
+
+    void clamp(float* samples, float minimum, float maximum, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            const auto low = vdupq_n_f32(minimum);
+            const auto high = vdupq_n_f32(maximum);
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(samples + i, vminq_f32(vmaxq_f32(vld1q_f32(samples + i), low), high));
+#elif defined(__AVX__)
+            const auto low = _mm256_set1_ps(minimum);
+            const auto high = _mm256_set1_ps(maximum);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(samples + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(samples + i), low), high));
+#elif defined(__SSE__)
+            const auto low = _mm_set1_ps(minimum);
+            const auto high = _mm_set1_ps(maximum);
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i), low), high));
+#endif
+        }
+
+        for (; i < count; ++i)
+            samples[i] = std::clamp(samples[i], minimum, maximum);
+    }
+
+    void interleave(float* destination, const float* source,
+                    std::uint32_t channels, std::size_t frames, std::size_t stride) noexcept
+    {
+        std::size_t frame = 0;
+
+        if (core::isSimdAvailable && channels == 2)
+        {
+            const float* left = source;
+            const float* right = source + stride;
+#if defined(__ARM_NEON__)
+            for (; frame + 4 <= frames; frame += 4)
+                vst2q_f32(destination + frame * 2, float32x4x2_t{{vld1q_f32(left + frame), vld1q_f32(right + frame)}});
+#elif defined(__SSE__)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const auto l = _mm_loadu_ps(left + frame);
+                const auto r = _mm_loadu_ps(right + frame);
+                _mm_storeu_ps(destination + frame * 2, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(destination + frame * 2 + 4, _mm_unpackhi_ps(l, r));
+            }
+#else
+            static_cast<void>(left);
+            static_cast<void>(right);
+#endif
+        }
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const float* sourceChannel = source + channel * stride;
+
+            for (std::size_t f = frame; f < frames; ++f)
+                destination[f * channels + channel] = sourceChannel[f];
+        }
+    }
+
+    void deinterleave(float* destination, const float* source,
+                      std::uint32_t channels, std::size_t frames, std::size_t stride) noexcept
+    {
+        std::size_t frame = 0;
+
+        if (core::isSimdAvailable && channels == 2)
+        {
+            float* left = destination;
+            float* right = destination + stride;
+#if defined(__ARM_NEON__)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const auto samples = vld2q_f32(source + frame * 2);
+                vst1q_f32(left + frame, samples.val[0]);
+                vst1q_f32(right + frame, samples.val[1]);
+            }
+#elif defined(__SSE__)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const auto a = _mm_loadu_ps(source + frame * 2);
+                const auto b = _mm_loadu_ps(source + frame * 2 + 4);
+                _mm_storeu_ps(left + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(right + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+#else
+            static_cast<void>(left);
+            static_cast<void>(right);
+#endif
+        }
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            float* destinationChannel = destination + channel * stride;
+
+            for (std::size_t f = frame; f < frames; ++f)
+                destinationChannel[f] = source[f * channels + channel];
+        }
+    }
+
+    void interleaveInt16(std::int16_t* destination, const float* source,
+                         std::uint32_t channels, std::size_t frames, std::size_t stride,
+                         DitherState& ditherState) noexcept
+    {
+        std::size_t frame = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            auto state = vld1q_u32(ditherState.data());
+
+            if (channels == 2)
+            {
+                for (; frame + 4 <= frames; frame += 4)
+                {
+                    const auto left = toInt16(vld1q_f32(source + frame), state);
+                    const auto right = toInt16(vld1q_f32(source + stride + frame), state);
+                    vst2_s16(destination + frame * 2, int16x4x2_t{{left, right}});
+                }
+            }
+            else
+            {
+                for (; frame + 4 <= frames; frame += 4)
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        std::int16_t values[4];
+                        vst1_s16(values, toInt16(vld1q_f32(source + channel * stride + frame), state));
+
+                        for (std::size_t i = 0; i < 4; ++i)
+                            destination[(frame + i) * channels + channel] = values[i];
+                    }
+            }
+
+            vst1q_u32(ditherState.data(), state);
+#elif defined(__SSE2__)
+            auto state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ditherState.data()));
+
+            if (channels == 2)
+            {
+                for (; frame + 4 <= frames; frame += 4)
+                {
+                    const auto left = toInt32(_mm_loadu_ps(source + frame), state);
+                    const auto right = toInt32(_mm_loadu_ps(source + stride + frame), state);
+                    const auto packed = _mm_packs_epi32(left, right); // L0 L1 L2 L3 R0 R1 R2 R3
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + frame * 2),
+                                     _mm_unpacklo_epi16(packed, _mm_srli_si128(packed, 8)));
+                }
+            }
+            else
+            {
+                for (; frame + 4 <= frames; frame += 4)
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        alignas(16) std::int16_t values[8];
+                        const auto value = toInt32(_mm_loadu_ps(source + channel * stride + frame), state);
+                        _mm_store_si128(reinterpret_cast<__m128i*>(values), _mm_packs_epi32(value, value));
+
+                        for (std::size_t i = 0; i < 4; ++i)
+                            destination[(frame + i) * channels + channel] = values[i];
+                    }
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ditherState.data()), state);
+#endif
+        }
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const float* sourceChannel = source + channel * stride;
+
+            for (std::size_t f = frame; f < frames; ++f)
+                destination[f * channels + channel] = toInt16(sourceChannel[f], ditherState[0]);
+        }
+    }
+
+    void fromInt16(float* destination, const std::int16_t* source, std::size_t count) noexcept
+    {
+        constexpr float factor = 1.0F / int16Scale;
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            for (; i + 8 <= count; i += 8)
+            {
+                const auto values = vld1q_s16(source + i);
+                vst1q_f32(destination + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))), factor));
+                vst1q_f32(destination + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))), factor));
+            }
+#elif defined(__SSE2__)
+            const auto f = _mm_set1_ps(factor);
+            for (; i + 8 <= count; i += 8)
+            {
+                const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                // sign extend by moving each value to the upper half of a 32-bit integer
+                const auto low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+                const auto high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+                _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(low), f));
+                _mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), f));
+            }
+#endif
+        }
+
+        for (; i < count; ++i)
+            destination[i] = static_cast<float>(source[i]) * factor;
+    }
+
+    void complexMultiplyAccumulate(float* destinationReal, float* destinationImaginary,
+                                   const float* firstReal, const float* firstImaginary,
+                                   const float* secondReal, const float* secondImaginary,
+                                   std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            for (; i + 4 <= count; i += 4)
+            {
+                const auto ar = vld1q_f32(firstReal + i);
+                const auto ai = vld1q_f32(firstImaginary + i);
+                const auto br = vld1q_f32(secondReal + i);
+                const auto bi = vld1q_f32(secondImaginary + i);
+                vst1q_f32(destinationReal + i, vmlsq_f32(vmlaq_f32(vld1q_f32(destinationReal + i), ar, br), ai, bi));
+                vst1q_f32(destinationImaginary + i, vmlaq_f32(vmlaq_f32(vld1q_f32(destinationImaginary + i), ar, bi), ai, br));
+            }
+#elif defined(__AVX__)
+            for (; i + 8 <= count; i += 8)
+            {
+                const auto ar = _mm256_loadu_ps(firstReal + i);
+                const auto ai = _mm256_loadu_ps(firstImaginary + i);
+                const auto br = _mm256_loadu_ps(secondReal + i);
+                const auto bi = _mm256_loadu_ps(secondImaginary + i);
+                _mm256_storeu_ps(destinationReal + i, _mm256_add_ps(_mm256_loadu_ps(destinationReal + i),
+                                                                    _mm256_sub_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi))));
+                _mm256_storeu_ps(destinationImaginary + i, _mm256_add_ps(_mm256_loadu_ps(destinationImaginary + i),
+                                                                         _mm256_add_ps(_mm256_mul_ps(ar, bi), _mm256_mul_ps(ai, br))));
+            }
+#elif defined(__SSE__)
+            for (; i + 4 <= count; i += 4)
+            {
+                const auto ar = _mm_loadu_ps(firstReal + i);
+                const auto ai = _mm_loadu_ps(firstImaginary + i);
+                const auto br = _mm_loadu_ps(secondReal + i);
+                const auto bi = _mm_loadu_ps(secondImaginary + i);
+                _mm_storeu_ps(destinationReal + i, _mm_add_ps(_mm_loadu_ps(destinationReal + i),
+                                                              _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi))));
+                _mm_storeu_ps(destinationImaginary + i, _mm_add_ps(_mm_loadu_ps(destinationImaginary + i),
+                                                                   _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br))));
+            }
+#endif
+        }
+
+        for (; i < count; ++i)
+        {
+            destinationReal[i] += firstReal[i] * secondReal[i] - firstImaginary[i] * secondImaginary[i];
+            destinationImaginary[i] += firstReal[i] * secondImaginary[i] + firstImaginary[i] * secondReal[i];
+        }
+    }
+}
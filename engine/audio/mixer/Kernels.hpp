@@ -0,0 +1,58 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_KERNELS_HPP
+#define OUZEL_AUDIO_MIXER_KERNELS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ouzel::audio::mixer
+{
+    // destination[i] += source[i]
+    void accumulate(float* destination, const float* source, std::size_t count) noexcept;
+
+    // destination[i] += source[i] * factor
+    void scaleAccumulate(float* destination, const float* source, float factor, std::size_t count) noexcept;
+
+    // samples[i] *= factor
+    void scale(float* samples, float factor, std::size_t count) noexcept;
+
+    // samples[i] *= factor interpolated linearly from startFactor to endFactor, endFactor is reached at the last sample
+    void scaleRamp(float* samples, float startFactor, float endFactor, std::size_t count) noexcept;
+
+    // returns the sum of first[i] * second[i]
+    float dot(const float* first, const float* second, std::size_t count) noexcept;
+
+    // samples[i] = min(max(samples[i], minimum), maximum)
+    void clamp(float* samples, float minimum, float maximum, std::size_t count) noexcept;
+
+    // converts planar samples (channels are stride samples apart) to interleaved samples
+    void interleave(float* destination, const float* source,
+                    std::uint32_t channels, std::size_t frames, std::size_t stride) noexcept;
+
+    // converts interleaved samples to planar samples (channels are stride samples apart)
+    void deinterleave(float* destination, const float* source,
+                      std::uint32_t channels, std::size_t frames, std::size_t stride) noexcept;
+
+    // state of the xorshift generators used for dithering, one for each SIMD lane (must not be zero)
+    using DitherState = std::array<std::uint32_t, 4>;
+    constexpr DitherState initialDitherState{{0x9E3779B9U, 0x7F4A7C15U, 0x85EBCA6BU, 0xC2B2AE35U}};
+
+    // converts planar samples (channels are stride samples apart) to interleaved 16-bit samples
+    // with triangular dither and saturation
+    void interleaveInt16(std::int16_t* destination, const float* source,
+                         std::uint32_t channels, std::size_t frames, std::size_t stride,
+                         DitherState& ditherState) noexcept;
+
+    // converts 16-bit samples to floating point samples in the range [-1, 1]
+    void fromInt16(float* destination, const std::int16_t* source, std::size_t count) noexcept;
+
+    // destination[i] += first[i] * second[i] for complex numbers in split format
+    void complexMultiplyAccumulate(float* destinationReal, float* destinationImaginary,
+                                   const float* firstReal, const float* firstImaginary,
+                                   const float* secondReal, const float* secondImaginary,
+                                   std::size_t count) noexcept;
+}
+
+#endif // OUZEL_AUDIO_MIXER_KERNELS_HPP
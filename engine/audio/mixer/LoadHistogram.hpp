@@ -0,0 +1,56 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_LOADHISTOGRAM_HPP
+#define OUZEL_AUDIO_MIXER_LOADHISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ouzel::audio::mixer
+{
+    // wait-free histogram of the time spent processing a block relative to the duration of the block, written by one
+    // thread and read by any
+    class LoadHistogram final
+    {
+    public:
+        // 10% wide buckets up to 100%, one bucket up to 200% and one for everything above
+        static constexpr std::size_t bucketCount = 12;
+        using Buckets = std::array<std::uint64_t, bucketCount>;
+
+        void add(float load) noexcept
+        {
+            const auto bucket = load < 1.0F ? static_cast<std::size_t>(load * 10.0F) :
+                load < 2.0F ? bucketCount - 2 : bucketCount - 1;
+            buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+            if (load > maxLoad.load(std::memory_order_relaxed))
+                maxLoad.store(load, std::memory_order_relaxed);
+        }
+
+        Buckets getBuckets() const noexcept
+        {
+            Buckets result;
+            for (std::size_t i = 0; i < bucketCount; ++i)
+                result[i] = buckets[i].load(std::memory_order_relaxed);
+            return result;
+        }
+
+        auto getMaxLoad() const noexcept { return maxLoad.load(std::memory_order_relaxed); }
+
+        // may lose the samples that are added at the same time
+        void reset() noexcept
+        {
+            for (auto& bucket : buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            maxLoad.store(0.0F, std::memory_order_relaxed);
+        }
+
+    private:
+        std::array<std::atomic<std::uint64_t>, bucketCount> buckets{};
+        std::atomic<float> maxLoad{0.0F};
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_LOADHISTOGRAM_HPP
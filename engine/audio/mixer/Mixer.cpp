@@ -1,253 +1,669 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <chrono>
+#include <stdexcept>
 #include "Mixer.hpp"
+#include "AllocationGuard.hpp"
 #include "Bus.hpp"
 #include "Data.hpp"
 #include "Stream.hpp"
+#include "../../core/Engine.hpp"
 #include "../../math/MathUtils.hpp"
+#include "../../utils/Log.hpp"
+#include "../../utils/Profiler.hpp"
 
 namespace ouzel::audio::mixer
 {
+    namespace
+    {
+        constexpr std::uint32_t maxDeviceFrames = 4096;
+        constexpr std::size_t commandQueueSize = 4096;
+    }
+
     Mixer::Mixer(std::uint32_t initBufferSize,
                  std::uint32_t initChannels,
-                 const std::function<void(const Event&)>& initCallback):
+                 std::uint32_t initSampleRate,
+                 std::uint32_t initBufferCount,
+                 Resampler::Quality initResamplerQuality,
+                 std::uint32_t initMaxStreams,
+                 float initAudibilityThreshold,
+                 std::uint32_t initWorkerCount,
+                 const std::function<void(const Event&)>& initCallback,
+                 bool initOffline):
         bufferSize(initBufferSize),
         channels(initChannels),
+        sampleRate(initSampleRate),
+        bufferCount(initBufferCount),
+        resamplerQuality(initResamplerQuality),
+        maxStreams(initMaxStreams),
+        audibilityThreshold(initAudibilityThreshold),
         callback(initCallback),
-        mixerThread(&Mixer::mixerMain, this),
-        buffer(initBufferSize * 3, initChannels)
+        offline(initOffline),
+        busScheduler(initWorkerCount),
+        // some devices request more frames than their buffer size at once
+        buffer(std::max(initBufferSize, maxDeviceFrames) * initBufferCount, initChannels),
+        commandQueue(commandQueueSize),
+        processedCommandQueue(commandQueueSize),
+        timingPublishBlocks((initSampleRate + initBufferSize - 1) / initBufferSize)
     {
-        //mixerThread.setPriority(20.0F, true);
-
         rootObjectId = getObjectId();
         objects.resize(rootObjectId);
         auto object = std::make_unique<RootObject>();
         rootObject = object.get();
         objects[rootObjectId - 1] = std::move(object);
+
+        if (offline)
+            renderBuffer.resize(bufferSize * channels);
+#if !defined(__EMSCRIPTEN__)
+        else
+        {
+            running = true;
+            mixerThread = thread::Thread(&Mixer::mixerMain, this);
+            //mixerThread.setPriority(20.0F, true);
+        }
+#endif
     }
 
     Mixer::~Mixer()
     {
+#if !defined(__EMSCRIPTEN__)
+        running = false;
+        bufferCondition.notify_all();
+
         if (mixerThread.isJoinable())
             mixerThread.join();
+#endif
+    }
+
+    void Mixer::submitCommandBuffer(CommandBuffer& commandBuffer)
+    {
+        // the commands and the objects they released are destroyed on the game thread
+        while (Command* command = processedCommandQueue.pop())
+        {
+            delete command;
+            --pendingCommandCount;
+        }
+
+        // the number of pending commands is limited so that the processed command queue never overflows
+        while (!commandBuffer.isEmpty() && pendingCommandCount < commandQueueSize)
+        {
+            commandQueue.push(commandBuffer.popCommand().release());
+            ++pendingCommandCount;
+        }
     }
 
     void Mixer::process()
     {
-        CommandBuffer commandBuffer;
-        std::unique_ptr<Command> command;
+        while (Command* command = commandQueue.pop())
+        {
+            try
+            {
+                executeCommand(*command);
+            }
+            catch (...)
+            {
+                processedCommandQueue.push(command);
+                throw;
+            }
+
+            processedCommandQueue.push(command);
+        }
+
+        // the timings are published while mixing, so the snapshot is allocated here
+        if (timingSnapshot.capacity() < timedObjects.size())
+            timingSnapshot.reserve(timedObjects.size());
+    }
+
+    void Mixer::render(std::uint32_t frames, std::vector<float>& samples)
+    {
+        OUZEL_PROFILE_SCOPE("Mixer::render");
+
+        if (!offline)
+            throw std::runtime_error("Only offline mixers can render");
+
+        samples.resize(frames * channels);
+
+        // the buffers of the mixer graph are preallocated for blocks of the buffer size
+        for (std::uint32_t offset = 0; offset < frames;)
+        {
+            const auto blockFrames = std::min(frames - offset, bufferSize);
+
+            process();
+
+            const auto startTime = std::chrono::steady_clock::now();
+            mix(blockFrames, channels, sampleRate, renderBuffer);
+            const std::chrono::duration<float> mixTime = std::chrono::steady_clock::now() - startTime;
+            mixLoad.add(mixTime.count() * static_cast<float>(sampleRate) / static_cast<float>(blockFrames));
+            mixedBufferCount.fetch_add(1, std::memory_order_relaxed);
+            interleave(&samples[offset * channels], renderBuffer.data(), channels, blockFrames, blockFrames);
+
+            offset += blockFrames;
+        }
+    }
+
+    std::vector<Mixer::Timing> Mixer::getTimings() const
+    {
+        std::vector<Timing> result;
+
+        if (offline)
+            collectTimings(result);
+        else
+        {
+            std::lock_guard lock(timingMutex);
+            result = publishedTimings;
+        }
+
+        return result;
+    }
+
+    void Mixer::resetTimings()
+    {
+        if (offline)
+            resetObjectTimings();
+        else
+        {
+            // the timings are written by the mixer thread, so it resets them
+            timingResetRequested = true;
+
+            std::lock_guard lock(timingMutex);
+            publishedTimings.clear();
+        }
+    }
+
+    void Mixer::collectTimings(std::vector<Timing>& timings) const
+    {
+        timings.clear();
+
+        for (const auto& timedObject : timedObjects)
+            if (timedObject.bus)
+                timings.push_back(Timing{timedObject.objectId, true, timedObject.bus->getProcessingTime()});
+            else
+                timings.push_back(Timing{timedObject.objectId, false, timedObject.processor->getProcessingTime()});
+    }
+
+    void Mixer::resetObjectTimings()
+    {
+        for (const auto& timedObject : timedObjects)
+            if (timedObject.bus)
+                timedObject.bus->resetProcessingTime();
+            else
+                timedObject.processor->resetProcessingTime();
+    }
+
+    void Mixer::publishTimings()
+    {
+        if (timingResetRequested.exchange(false))
+            resetObjectTimings();
+
+        // collecting the timings must not allocate, a bus or a processor was added after the last process
+        if (timingSnapshot.capacity() < timedObjects.size()) return;
+
+        collectTimings(timingSnapshot);
 
-        for (;;)
+        // the mixer thread never waits for the game thread, the timings are published next time if it is reading them
+        std::unique_lock lock(timingMutex, std::try_to_lock);
+        if (lock.owns_lock())
         {
-            std::unique_lock lock(commandQueueMutex);
-            if (commandQueue.empty()) break;
-            commandBuffer = std::move(commandQueue.front());
-            commandQueue.pop();
-            lock.unlock();
+            publishedTimings.swap(timingSnapshot);
+            blocksSinceTimingPublish = 0;
+        }
+    }
 
-            while (!commandBuffer.isEmpty())
+    Mixer::Statistics Mixer::getStatistics() const
+    {
+        Statistics result;
+        result.mixLoad = mixLoad.getBuckets();
+        result.maxMixLoad = mixLoad.getMaxLoad();
+        result.callbackLoad = callbackLoad.getBuckets();
+        result.maxCallbackLoad = callbackLoad.getMaxLoad();
+        result.mixedBufferCount = mixedBufferCount.load(std::memory_order_relaxed);
+        result.starvationCount = starvationCount.load(std::memory_order_relaxed);
+        result.bufferedFrames = static_cast<std::uint32_t>(buffer.getReadableFrames());
+        const std::size_t deviceBufferSize = std::max(bufferSize, deviceFrames.load(std::memory_order_relaxed));
+        result.targetBufferedFrames = static_cast<std::uint32_t>(std::min(buffer.getCapacity(), deviceBufferSize * bufferCount));
+        return result;
+    }
+
+    void Mixer::resetStatistics()
+    {
+        mixLoad.reset();
+        callbackLoad.reset();
+        mixedBufferCount.store(0, std::memory_order_relaxed);
+        starvationCount.store(0, std::memory_order_relaxed);
+    }
+
+    void Mixer::executeCommand(Command& command)
+    {
+        switch (command.type)
+        {
+            case Command::Type::initObject:
+            {
+                auto initObjectCommand = static_cast<InitObjectCommand*>(&command);
+                releaseObject(initObjectCommand->objectId, command);
+                objects[initObjectCommand->objectId - 1] = std::make_unique<Object>(std::move(initObjectCommand->source));
+                break;
+            }
+            case Command::Type::deleteObject:
+            {
+                auto deleteObjectCommand = static_cast<const DeleteObjectCommand*>(&command);
+                releaseObject(deleteObjectCommand->objectId, command);
+                break;
+            }
+            case Command::Type::addChild:
+            {
+                auto addChildCommand = static_cast<const AddChildCommand*>(&command);
+                Object* object = objects[addChildCommand->objectId - 1].get();
+                Object* child = objects[addChildCommand->objectId - 1].get();
+                object->addChild(*child);
+                break;
+            }
+            case Command::Type::removeChild:
+            {
+                auto removeChildCommand = static_cast<const RemoveChildCommand*>(&command);
+                Object* object = objects[removeChildCommand->objectId - 1].get();
+                Object* child = objects[removeChildCommand->objectId - 1].get();
+                object->removeChild(*child);
+                break;
+            }
+            case Command::Type::play:
+            {
+                auto playCommand = static_cast<const PlayCommand*>(&command);
+                Object* object = objects[playCommand->objectId - 1].get();
+                object->play();
+                break;
+            }
+            case Command::Type::stop:
             {
-                command = commandBuffer.popCommand();
+                auto stopCommand = static_cast<const StopCommand*>(&command);
+                Object* object = objects[stopCommand->objectId - 1].get();
+                object->stop(stopCommand->reset);
+                break;
+            }
+            case Command::Type::initBus:
+            {
+                auto initBusCommand = static_cast<const InitBusCommand*>(&command);
 
-                switch (command->type)
-                {
-                    case Command::Type::initObject:
-                    {
-                        auto initObjectCommand = static_cast<InitObjectCommand*>(command.get());
-                        objects[initObjectCommand->objectId - 1] = std::make_unique<Object>(std::move(initObjectCommand->source));
-                        break;
-                    }
-                    case Command::Type::deleteObject:
-                    {
-                        auto deleteObjectCommand = static_cast<const DeleteObjectCommand*>(command.get());
-                        objects[deleteObjectCommand->objectId - 1].reset();
-                        break;
-                    }
-                    case Command::Type::addChild:
-                    {
-                        auto addChildCommand = static_cast<const AddChildCommand*>(command.get());
-                        Object* object = objects[addChildCommand->objectId - 1].get();
-                        Object* child = objects[addChildCommand->objectId - 1].get();
-                        object->addChild(*child);
-                        break;
-                    }
-                    case Command::Type::removeChild:
-                    {
-                        auto removeChildCommand = static_cast<const RemoveChildCommand*>(command.get());
-                        Object* object = objects[removeChildCommand->objectId - 1].get();
-                        Object* child = objects[removeChildCommand->objectId - 1].get();
-                        object->removeChild(*child);
-                        break;
-                    }
-                    case Command::Type::play:
-                    {
-                        auto playCommand = static_cast<const PlayCommand*>(command.get());
-                        Object* object = objects[playCommand->objectId - 1].get();
-                        object->play();
-                        break;
-                    }
-                    case Command::Type::stop:
-                    {
-                        auto stopCommand = static_cast<const StopCommand*>(command.get());
-                        Object* object = objects[stopCommand->objectId - 1].get();
-                        object->stop(stopCommand->reset);
-                        break;
-                    }
-                    case Command::Type::initBus:
-                    {
-                        auto initBusCommand = static_cast<const InitBusCommand*>(command.get());
-
-                        if (initBusCommand->busId > objects.size())
-                            objects.resize(initBusCommand->busId);
-
-                        objects[initBusCommand->busId - 1] = std::make_unique<Bus>();
-                        break;
-                    }
-                    case Command::Type::setBusOutput:
-                    {
-                        auto setBusOutputCommand = static_cast<const SetBusOutputCommand*>(command.get());
-
-                        auto bus = static_cast<Bus*>(objects[setBusOutputCommand->busId - 1].get());
-                        bus->setOutput(setBusOutputCommand->outputBusId ? static_cast<Bus*>(objects[setBusOutputCommand->outputBusId - 1].get()) : nullptr);
-                        break;
-                    }
-                    case Command::Type::addProcessor:
-                    {
-                        auto addProcessorCommand = static_cast<const AddProcessorCommand*>(command.get());
-
-                        auto bus = static_cast<Bus*>(objects[addProcessorCommand->busId - 1].get());
-                        auto processor = static_cast<Processor*>(objects[addProcessorCommand->processorId - 1].get());
-                        bus->addProcessor(processor);
-                        break;
-                    }
-                    case Command::Type::removeProcessor:
-                    {
-                        auto removeProcessorCommand = static_cast<const RemoveProcessorCommand*>(command.get());
-
-                        auto bus = static_cast<Bus*>(objects[removeProcessorCommand->busId - 1].get());
-                        auto processor = static_cast<Processor*>(objects[removeProcessorCommand->processorId - 1].get());
-                        bus->removeProcessor(processor);
-                        break;
-                    }
-                    case Command::Type::setMasterBus:
-                    {
-                        auto setMasterBusCommand = static_cast<const SetMasterBusCommand*>(command.get());
-
-                        masterBus = setMasterBusCommand->busId ? static_cast<Bus*>(objects[setMasterBusCommand->busId - 1].get()) : nullptr;
-                        break;
-                    }
-                    case Command::Type::initStream:
-                    {
-                        auto initStreamCommand = static_cast<const InitStreamCommand*>(command.get());
-
-                        if (initStreamCommand->streamId > objects.size())
-                            objects.resize(initStreamCommand->streamId);
-
-                        auto data = static_cast<Data*>(objects[initStreamCommand->dataId - 1].get());
-                        objects[initStreamCommand->streamId - 1] = data->createStream();
-                        break;
-                    }
-                    case Command::Type::playStream:
-                    {
-                        auto playStreamCommand = static_cast<const PlayStreamCommand*>(command.get());
-
-                        auto stream = static_cast<Stream*>(objects[playStreamCommand->streamId - 1].get());
-                        stream->play();
-                        break;
-                    }
-                    case Command::Type::stopStream:
-                    {
-                        auto stopStreamCommand = static_cast<const StopStreamCommand*>(command.get());
-
-                        auto stream = static_cast<Stream*>(objects[stopStreamCommand->streamId - 1].get());
-                        stream->stop(stopStreamCommand->reset);
-                        break;
-                    }
-                    case Command::Type::setStreamOutput:
-                    {
-                        auto setStreamOutputCommand = static_cast<const SetStreamOutputCommand*>(command.get());
-
-                        auto stream = static_cast<Stream*>(objects[setStreamOutputCommand->streamId - 1].get());
-                        stream->setOutput(setStreamOutputCommand->busId ? static_cast<Bus*>(objects[setStreamOutputCommand->busId - 1].get()) : nullptr);
-                        break;
-                    }
-                    case Command::Type::initData:
-                    {
-                        auto initDataCommand = static_cast<InitDataCommand*>(command.get());
-
-                        if (initDataCommand->dataId > objects.size())
-                            objects.resize(initDataCommand->dataId);
-
-                        objects[initDataCommand->dataId - 1] = std::move(initDataCommand->data);
-                        break;
-                    }
-                    case Command::Type::initProcessor:
-                    {
-                        auto initProcessorCommand = static_cast<InitProcessorCommand*>(command.get());
-
-                        if (initProcessorCommand->processorId > objects.size())
-                            objects.resize(initProcessorCommand->processorId);
-
-                        objects[initProcessorCommand->processorId - 1] = std::move(initProcessorCommand->processor);
-                        break;
-                    }
-                    case Command::Type::updateProcessor:
-                    {
-                        auto updateProcessorCommand = static_cast<const UpdateProcessorCommand*>(command.get());
-
-                        auto processor = static_cast<Processor*>(objects[updateProcessorCommand->processorId - 1].get());
-                        updateProcessorCommand->updateFunction(processor);
-                        break;
-                    }
-                    default:
-                        throw std::runtime_error("Invalid command");
-                }
+                if (initBusCommand->busId > objects.size())
+                    objects.resize(initBusCommand->busId);
+
+                releaseObject(initBusCommand->busId, command);
+
+                auto bus = std::make_unique<Bus>(bufferSize, channels, sampleRate);
+                timedObjects.push_back(TimedObject{initBusCommand->busId, bus.get(), nullptr});
+                objects[initBusCommand->busId - 1] = std::move(bus);
+                busScheduler.reserve(objects.size());
+                break;
+            }
+            case Command::Type::setBusOutput:
+            {
+                auto setBusOutputCommand = static_cast<const SetBusOutputCommand*>(&command);
+
+                auto bus = static_cast<Bus*>(objects[setBusOutputCommand->busId - 1].get());
+                bus->setOutput(setBusOutputCommand->outputBusId ? static_cast<Bus*>(objects[setBusOutputCommand->outputBusId - 1].get()) : nullptr);
+                break;
+            }
+            case Command::Type::addProcessor:
+            {
+                auto addProcessorCommand = static_cast<const AddProcessorCommand*>(&command);
+
+                auto bus = static_cast<Bus*>(objects[addProcessorCommand->busId - 1].get());
+                auto processor = static_cast<Processor*>(objects[addProcessorCommand->processorId - 1].get());
+                bus->addProcessor(processor);
+                break;
+            }
+            case Command::Type::removeProcessor:
+            {
+                auto removeProcessorCommand = static_cast<const RemoveProcessorCommand*>(&command);
+
+                auto bus = static_cast<Bus*>(objects[removeProcessorCommand->busId - 1].get());
+                auto processor = static_cast<Processor*>(objects[removeProcessorCommand->processorId - 1].get());
+                bus->removeProcessor(processor);
+                break;
             }
+            case Command::Type::setMasterBus:
+            {
+                auto setMasterBusCommand = static_cast<const SetMasterBusCommand*>(&command);
+
+                masterBus = setMasterBusCommand->busId ? static_cast<Bus*>(objects[setMasterBusCommand->busId - 1].get()) : nullptr;
+                break;
+            }
+            case Command::Type::setBusMaxStreams:
+            {
+                auto setBusMaxStreamsCommand = static_cast<const SetBusMaxStreamsCommand*>(&command);
+
+                auto bus = static_cast<Bus*>(objects[setBusMaxStreamsCommand->busId - 1].get());
+                bus->setMaxStreams(setBusMaxStreamsCommand->maxStreams);
+                break;
+            }
+            case Command::Type::setBusListener:
+            {
+                auto setBusListenerCommand = static_cast<const SetBusListenerCommand*>(&command);
+
+                auto bus = static_cast<Bus*>(objects[setBusListenerCommand->busId - 1].get());
+                bus->setListener(setBusListenerCommand->listener,
+                                 setBusListenerCommand->position,
+                                 setBusListenerCommand->rotation);
+                break;
+            }
+            case Command::Type::initStream:
+            {
+                auto initStreamCommand = static_cast<const InitStreamCommand*>(&command);
+
+                if (initStreamCommand->streamId > objects.size())
+                    objects.resize(initStreamCommand->streamId);
+
+                releaseObject(initStreamCommand->streamId, command);
+
+                auto data = static_cast<Data*>(objects[initStreamCommand->dataId - 1].get());
+                auto stream = data->createStream();
+                stream->getResampler().setQuality(resamplerQuality);
+
+                streams.push_back(stream.get());
+                audibleStreams.reserve(streams.capacity());
+
+                objects[initStreamCommand->streamId - 1] = std::move(stream);
+                break;
+            }
+            case Command::Type::playStream:
+            {
+                auto playStreamCommand = static_cast<const PlayStreamCommand*>(&command);
+
+                auto stream = static_cast<Stream*>(objects[playStreamCommand->streamId - 1].get());
+                stream->play();
+                break;
+            }
+            case Command::Type::stopStream:
+            {
+                auto stopStreamCommand = static_cast<const StopStreamCommand*>(&command);
+
+                auto stream = static_cast<Stream*>(objects[stopStreamCommand->streamId - 1].get());
+                stream->stop(stopStreamCommand->reset);
+                break;
+            }
+            case Command::Type::setStreamOutput:
+            {
+                auto setStreamOutputCommand = static_cast<const SetStreamOutputCommand*>(&command);
+
+                auto stream = static_cast<Stream*>(objects[setStreamOutputCommand->streamId - 1].get());
+                stream->setOutput(setStreamOutputCommand->busId ? static_cast<Bus*>(objects[setStreamOutputCommand->busId - 1].get()) : nullptr);
+                break;
+            }
+            case Command::Type::setStreamPriority:
+            {
+                auto setStreamPriorityCommand = static_cast<const SetStreamPriorityCommand*>(&command);
+
+                auto stream = static_cast<Stream*>(objects[setStreamPriorityCommand->streamId - 1].get());
+                stream->setPriority(setStreamPriorityCommand->priority);
+                break;
+            }
+            case Command::Type::initData:
+            {
+                auto initDataCommand = static_cast<InitDataCommand*>(&command);
+
+                if (initDataCommand->dataId > objects.size())
+                    objects.resize(initDataCommand->dataId);
+
+                releaseObject(initDataCommand->dataId, command);
+
+                objects[initDataCommand->dataId - 1] = std::move(initDataCommand->data);
+                break;
+            }
+            case Command::Type::initProcessor:
+            {
+                auto initProcessorCommand = static_cast<InitProcessorCommand*>(&command);
+
+                if (initProcessorCommand->processorId > objects.size())
+                    objects.resize(initProcessorCommand->processorId);
+
+                releaseObject(initProcessorCommand->processorId, command);
+
+                timedObjects.push_back(TimedObject{initProcessorCommand->processorId, nullptr,
+                                                   initProcessorCommand->processor.get()});
+                objects[initProcessorCommand->processorId - 1] = std::move(initProcessorCommand->processor);
+                break;
+            }
+            case Command::Type::updateProcessor:
+            {
+                auto updateProcessorCommand = static_cast<const UpdateProcessorCommand*>(&command);
+
+                auto processor = static_cast<Processor*>(objects[updateProcessorCommand->processorId - 1].get());
+                updateProcessorCommand->updateFunction(processor);
+                break;
+            }
+            default:
+                throw std::runtime_error("Invalid command");
+        }
+    }
+
+    void Mixer::releaseObject(ObjectId objectId, Command& command)
+    {
+        if (auto& object = objects[objectId - 1])
+        {
+            const auto i = std::find_if(streams.begin(), streams.end(),
+                                        [&object](const Stream* stream) noexcept { return stream == object.get(); });
+            if (i != streams.end()) streams.erase(i);
+
+            const auto timedObject = std::find_if(timedObjects.begin(), timedObjects.end(),
+                                                  [objectId](const TimedObject& timed) noexcept {
+                                                      return timed.objectId == objectId;
+                                                  });
+            if (timedObject != timedObjects.end()) timedObjects.erase(timedObject);
+
+            // disconnect the object on the mixer thread and let the game thread destroy it
+            object->detach();
+            command.releasedObject = std::move(object);
+        }
+    }
+
+    bool Mixer::getAudibility(const Bus& bus, Vector3F& listenerPosition, float& gain) const
+    {
+        // only the buses connected to the master bus are mixed
+        if (&bus != masterBus)
+        {
+            const Bus* output = bus.getOutput();
+            if (!output || !getAudibility(*output, listenerPosition, gain))
+                return false;
         }
+
+        if (bus.hasListener())
+            listenerPosition = bus.getListenerPosition();
+
+        gain *= bus.getGain(listenerPosition);
+        return true;
     }
 
-    void Mixer::getSamples(std::uint32_t frames, std::uint32_t channelCount, std::uint32_t sampleRate, std::vector<float>& samples)
+    void Mixer::updateVirtualStreams()
     {
+        OUZEL_PROFILE_SCOPE("Mixer::updateVirtualStreams");
+
+        audibleStreams.clear();
+
+        for (Stream* stream : streams)
+        {
+            Bus* output = stream->getOutput();
+            if (!stream->isPlaying() || !output) continue;
+
+            Vector3F listenerPosition;
+            float gain = 1.0F;
+
+            if (getAudibility(*output, listenerPosition, gain))
+            {
+                output->activeStreamCount = 0;
+                audibleStreams.push_back(StreamAudibility{stream, gain});
+            }
+        }
+
+        // streams with a higher priority are mixed first, then the louder ones, the streams that are already mixed
+        // win a tie so that they do not get virtualized and resumed repeatedly
+        std::sort(audibleStreams.begin(), audibleStreams.end(),
+                  [](const StreamAudibility& a, const StreamAudibility& b) noexcept {
+                      if (a.stream->getPriority() != b.stream->getPriority())
+                          return a.stream->getPriority() > b.stream->getPriority();
+                      if (a.gain != b.gain)
+                          return a.gain > b.gain;
+                      return !a.stream->isVirtual() && b.stream->isVirtual();
+                  });
+
+        std::uint32_t activeStreamCount = 0;
+
+        for (const auto& audibleStream : audibleStreams)
+        {
+            Bus* output = audibleStream.stream->getOutput();
+
+            const bool audible = audibleStream.gain >= audibilityThreshold &&
+                (!maxStreams || activeStreamCount < maxStreams) &&
+                (!output->maxStreams || output->activeStreamCount < output->maxStreams);
+
+            audibleStream.stream->setVirtual(!audible);
+
+            if (audible)
+            {
+                ++activeStreamCount;
+                ++output->activeStreamCount;
+            }
+        }
+    }
+
+    void Mixer::updateSpatializer()
+    {
+        OUZEL_PROFILE_SCOPE("Mixer::updateSpatializer");
+
+        for (std::uint32_t emitter = 0; emitter < spatializer.getEmitterCount(); ++emitter)
+        {
+            const Processor* processor = spatializer.getProcessor(emitter);
+            if (!processor) continue;
+
+            // the emitter is heard by the listener of the closest bus that has one
+            const Bus* bus = processor->getBus();
+            while (bus && !bus->hasListener())
+                bus = bus->getOutput();
+
+            if (bus)
+                spatializer.setListener(emitter, bus->getListenerPosition(), bus->getListenerRotation());
+            else
+                spatializer.setListener(emitter, Vector3F{}, QuaternionF::identity());
+        }
+
+        spatializer.update();
+    }
+
+    void Mixer::getSamples(std::uint32_t frames, std::uint32_t channelCount, std::uint32_t outputSampleRate, std::vector<float>& samples)
+    {
+        OUZEL_PROFILE_SCOPE("Mixer::getSamples");
+
+        const auto startTime = std::chrono::steady_clock::now();
+
+#if defined(__EMSCRIPTEN__)
         process();
+        mix(frames, channelCount, outputSampleRate, samples);
+#else
+        static_cast<void>(outputSampleRate); // the mixer thread mixes at the sample rate of the device
+
+        samples.resize(frames * channelCount);
+
+        if (frames > deviceFrames.load(std::memory_order_relaxed))
+            deviceFrames.store(frames, std::memory_order_relaxed);
+
+        const auto readFrames = static_cast<std::uint32_t>(buffer.read(frames, samples));
+
+        // wake up the mixer thread, it will not miss the notification for longer than its wait timeout
+        bufferCondition.notify_one();
+
+        if (readFrames < frames)
+        {
+            for (std::uint32_t channel = 0; channel < channelCount; ++channel)
+                std::fill(samples.begin() + channel * frames + readFrames,
+                          samples.begin() + (channel + 1) * frames, 0.0F);
+
+            starvationCount.fetch_add(1, std::memory_order_relaxed);
+            callback(Event(Event::Type::starvation));
+        }
+#endif
+
+        if (frames)
+        {
+            const std::chrono::duration<float> callbackTime = std::chrono::steady_clock::now() - startTime;
+            callbackLoad.add(callbackTime.count() * static_cast<float>(sampleRate) / static_cast<float>(frames));
+        }
+    }
+
+    bool Mixer::isBufferFilled() const noexcept
+    {
+        // mix ahead by the given number of the device's buffers
+        const std::size_t deviceBufferSize = std::max(bufferSize, deviceFrames.load(std::memory_order_relaxed));
+        const auto targetFrames = std::min(buffer.getCapacity(), deviceBufferSize * bufferCount);
+        const auto writableFrames = buffer.getWritableFrames();
+
+        return writableFrames < bufferSize ||
+            buffer.getCapacity() - writableFrames >= targetFrames;
+    }
+
+    void Mixer::mix(std::uint32_t frames, std::uint32_t channelCount, std::uint32_t outputSampleRate, std::vector<float>& samples)
+    {
+        OUZEL_PROFILE_SCOPE("Mixer::mix");
 
         samples.resize(frames * channelCount);
 
         if (masterBus)
         {
-            Vector3F listenerPosition;
-            QuaternionF listenerRotation;
+            updateVirtualStreams();
+            updateSpatializer();
 
-            masterBus->getSamples(frames, channelCount, sampleRate, listenerPosition, listenerRotation, samples);
+            busScheduler.mix(*masterBus, frames, channelCount, outputSampleRate, samples);
         }
+        else
+            std::fill(samples.begin(), samples.end(), 0.0F);
 
-        for (float& sample : samples)
-            sample = std::clamp(sample, -1.0F, 1.0F);
+        clamp(samples.data(), -1.0F, 1.0F, samples.size());
     }
 
     void Mixer::mixerMain()
     {
         thread::setCurrentThreadName("Mixer");
+        OUZEL_PROFILE_THREAD("Mixer");
 
-        for (;;)
-        {
-            break; // TODO: remove
-
-            /*process();
+#if !defined(__EMSCRIPTEN__)
+        const auto bufferDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(static_cast<double>(bufferSize) / sampleRate));
 
-            std::unique_lock lock(bufferMutex);
-            bufferCondition.wait(lock);
+        std::vector<float> samples(bufferSize * channels);
 
-            if (masterBus)
+        while (running)
+        {
+            try
             {
-                //Vector3F listenerPosition;
-                //QuaternionF listenerRotation;
+                if (!isBufferFilled())
+                {
+                    process();
+
+                    // mixing must not allocate, the buffers are allocated by the commands that create the objects
+                    OUZEL_AUDIO_ALLOCATION_GUARD();
+
+                    // about once a second
+                    if (++blocksSinceTimingPublish >= timingPublishBlocks)
+                        publishTimings();
 
-                //masterBus->getData(frames, channels, sampleRate, listenerPosition, listenerRotation, samples);
-            }*/
+                    const auto startTime = std::chrono::steady_clock::now();
+                    mix(bufferSize, channels, sampleRate, samples);
+                    const std::chrono::duration<float> mixTime = std::chrono::steady_clock::now() - startTime;
+                    mixLoad.add(mixTime.count() * static_cast<float>(sampleRate) / static_cast<float>(bufferSize));
+                    mixedBufferCount.fetch_add(1, std::memory_order_relaxed);
 
-            //for (float& f : samples)
-            //    f = std::clamp(f, -1.0F, 1.0F);
+                    buffer.write(bufferSize, samples);
+                }
+                else
+                {
+                    std::unique_lock lock(bufferMutex);
+                    bufferCondition.wait_for(lock, bufferDuration, [this]() {
+                        return !running || !isBufferFilled();
+                    });
+                }
+            }
+            catch (const std::exception& e)
+            {
+                logger.log(Log::Level::error) << e.what();
+            }
         }
+#endif
     }
 }
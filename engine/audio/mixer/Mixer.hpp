@@ -3,17 +3,24 @@
 #ifndef OUZEL_AUDIO_MIXER_MIXER_HPP
 #define OUZEL_AUDIO_MIXER_MIXER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <set>
 #include <thread>
 #include <vector>
+#include "BusScheduler.hpp"
 #include "Commands.hpp"
+#include "Kernels.hpp"
+#include "LoadHistogram.hpp"
 #include "Object.hpp"
 #include "Processor.hpp"
+#include "Resampler.hpp"
+#include "Spatializer.hpp"
 #include "../../thread/Thread.hpp"
 
 namespace ouzel::audio::mixer
@@ -29,10 +36,7 @@ namespace ouzel::audio::mixer
             for (Object* child : children)
             {
                 child->getSamples(frames, channels, sampleRate, buffer);
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                    for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        samples[channel * frames + frame] += buffer[channel * frames + frame];
+                accumulate(samples.data(), buffer.data(), samples.size());
             }
         }
 
@@ -63,7 +67,14 @@ namespace ouzel::audio::mixer
 
         Mixer(std::uint32_t initBufferSize,
               std::uint32_t initChannels,
-              const std::function<void(const Event&)>& initCallback);
+              std::uint32_t initSampleRate,
+              std::uint32_t initBufferCount, // number of buffers mixed ahead of the audio device
+              Resampler::Quality initResamplerQuality,
+              std::uint32_t initMaxStreams, // maximum number of streams mixed at once, zero for no limit
+              float initAudibilityThreshold, // streams with a lower estimated gain are not mixed
+              std::uint32_t initWorkerCount, // threads that mix the independent buses together with the mixer thread
+              const std::function<void(const Event&)>& initCallback,
+              bool initOffline = false); // the mixer thread is not started, the samples are mixed by render
 
         ~Mixer();
 
@@ -74,7 +85,7 @@ namespace ouzel::audio::mixer
         Mixer& operator=(Mixer&&) = delete;
 
         void process();
-        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples);
+        void getSamples(std::uint32_t frames, std::uint32_t channelCount, std::uint32_t outputSampleRate, std::vector<float>& samples);
 
         using ObjectId = std::size_t;
         ObjectId getObjectId()
@@ -96,24 +107,74 @@ namespace ouzel::audio::mixer
             deletedObjectIds.insert(objectId);
         }
 
-        void submitCommandBuffer(CommandBuffer&& commandBuffer)
+        // executes the submitted commands and mixes the interleaved samples on the calling thread as fast as possible,
+        // only for offline mixers
+        void render(std::uint32_t frames, std::vector<float>& samples);
+
+        struct Timing final
         {
-            std::unique_lock lock(commandQueueMutex);
-            commandQueue.push(std::move(commandBuffer));
-            lock.unlock();
-        }
+            ObjectId objectId;
+            bool bus; // otherwise a processor
+            std::chrono::steady_clock::duration processingTime;
+        };
+
+        // processing times of the buses and the processors since the last reset, the mixer thread publishes them about
+        // once a second
+        std::vector<Timing> getTimings() const;
+        void resetTimings();
+
+        struct Statistics final
+        {
+            LoadHistogram::Buckets mixLoad{}; // time spent mixing a buffer relative to its duration
+            float maxMixLoad = 0.0F;
+            LoadHistogram::Buckets callbackLoad{}; // time spent in getSamples relative to the duration of the frames
+            float maxCallbackLoad = 0.0F;
+            std::uint64_t mixedBufferCount = 0;
+            std::uint64_t starvationCount = 0; // device callbacks that were not fully filled
+            std::uint32_t bufferedFrames = 0; // frames mixed ahead of the device
+            std::uint32_t targetBufferedFrames = 0; // frames the mixer tries to stay ahead by
+        };
+
+        // can be called from any thread
+        Statistics getStatistics() const;
+        void resetStatistics();
+
+        auto isOffline() const noexcept { return offline; }
+
+        // wait-free, the commands that do not fit in the command queue are left in the command buffer
+        void submitCommandBuffer(CommandBuffer& commandBuffer);
 
         auto getRootObjectId() const noexcept
         {
             return rootObjectId;
         }
 
+        // must be accessed only from the mixer thread
+        auto& getSpatializer() noexcept { return spatializer; }
+
     private:
         void mixerMain();
+        void executeCommand(Command& command);
+        void releaseObject(ObjectId objectId, Command& command);
+        bool getAudibility(const Bus& bus, Vector3F& listenerPosition, float& gain) const;
+        void updateVirtualStreams();
+        void updateSpatializer();
+        bool isBufferFilled() const noexcept;
+        void mix(std::uint32_t frames, std::uint32_t channelCount, std::uint32_t outputSampleRate, std::vector<float>& samples);
+        void collectTimings(std::vector<Timing>& timings) const;
+        void resetObjectTimings();
+        void publishTimings();
 
         std::uint32_t bufferSize;
         std::uint32_t channels;
+        std::uint32_t sampleRate;
+        std::uint32_t bufferCount;
+        Resampler::Quality resamplerQuality;
+        std::uint32_t maxStreams;
+        float audibilityThreshold;
         std::function<void(const Event&)> callback;
+        bool offline;
+        std::vector<float> renderBuffer;
 
         ObjectId lastObjectId = 0;
         std::set<ObjectId> deletedObjectIds;
@@ -124,6 +185,29 @@ namespace ouzel::audio::mixer
 
         Bus* masterBus = nullptr;
 
+        struct StreamAudibility final
+        {
+            Stream* stream;
+            float gain;
+        };
+
+        std::vector<Stream*> streams;
+        std::vector<StreamAudibility> audibleStreams; // preallocated for all of the streams
+
+        // the buses and the processors, so that their timings are collected without going through all of the objects
+        struct TimedObject final
+        {
+            ObjectId objectId;
+            Bus* bus;
+            Processor* processor;
+        };
+
+        std::vector<TimedObject> timedObjects;
+
+        Spatializer spatializer;
+        BusScheduler busScheduler;
+
+        // single producer (the mixer thread), single consumer (the audio device) ring buffer of interleaved frames
         class Buffer final
         {
         public:
@@ -134,25 +218,132 @@ namespace ouzel::audio::mixer
             {
             }
 
-            bool canRead() const { return frames > 0; }
-            bool canWrite() const { return frames < maxFrames; }
+            auto getCapacity() const noexcept { return maxFrames; }
+
+            std::size_t getReadableFrames() const noexcept
+            {
+                return writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed);
+            }
+
+            std::size_t getWritableFrames() const noexcept
+            {
+                return maxFrames - (writePosition.load(std::memory_order_relaxed) - readPosition.load(std::memory_order_acquire));
+            }
+
+            // writes planar samples, the caller must check that there is enough space
+            void write(std::size_t frames, const std::vector<float>& samples) noexcept
+            {
+                const auto position = writePosition.load(std::memory_order_relaxed);
+                const auto offset = position % maxFrames;
+                const auto firstFrames = std::min(frames, maxFrames - offset);
+
+                // the written frames can wrap around the end of the buffer
+                interleave(&buffer[offset * channels], samples.data(), channels, firstFrames, frames);
+                interleave(buffer.data(), samples.data() + firstFrames, channels, frames - firstFrames, frames);
+
+                writePosition.store(position + frames, std::memory_order_release);
+            }
+
+            // reads up to the given number of frames to planar samples and returns the number of frames read
+            std::size_t read(std::size_t frames, std::vector<float>& samples) noexcept
+            {
+                const auto position = readPosition.load(std::memory_order_relaxed);
+                const auto readFrames = std::min(frames, writePosition.load(std::memory_order_acquire) - position);
+                const auto offset = position % maxFrames;
+                const auto firstFrames = std::min(readFrames, maxFrames - offset);
+
+                deinterleave(samples.data(), &buffer[offset * channels], channels, firstFrames, frames);
+                deinterleave(samples.data() + firstFrames, buffer.data(), channels, readFrames - firstFrames, frames);
+
+                readPosition.store(position + readFrames, std::memory_order_release);
+
+                return readFrames;
+            }
 
         private:
-            std::size_t frames = 0;
             std::size_t maxFrames;
             std::uint32_t channels;
-            std::size_t readPosition = 0;
-            std::size_t writePosition = 0;
             std::vector<float> buffer;
+            alignas(64) std::atomic<std::size_t> readPosition{0};
+            alignas(64) std::atomic<std::size_t> writePosition{0};
+        };
+
+        Buffer buffer;
+
+        // single producer, single consumer queue of command pointers with preallocated storage
+        class CommandQueue final
+        {
+        public:
+            explicit CommandQueue(std::size_t size):
+                commands(size)
+            {
+            }
+
+            ~CommandQueue()
+            {
+                while (Command* command = pop())
+                    delete command;
+            }
+
+            CommandQueue(const CommandQueue&) = delete;
+            CommandQueue& operator=(const CommandQueue&) = delete;
+            CommandQueue(CommandQueue&&) = delete;
+            CommandQueue& operator=(CommandQueue&&) = delete;
+
+            bool push(Command* command) noexcept
+            {
+                const auto position = writePosition.load(std::memory_order_relaxed);
+                if (position - readPosition.load(std::memory_order_acquire) == commands.size())
+                    return false;
+
+                commands[position % commands.size()] = command;
+                writePosition.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            // returns null if the queue is empty
+            Command* pop() noexcept
+            {
+                const auto position = readPosition.load(std::memory_order_relaxed);
+                if (position == writePosition.load(std::memory_order_acquire))
+                    return nullptr;
+
+                Command* command = commands[position % commands.size()];
+                readPosition.store(position + 1, std::memory_order_release);
+                return command;
+            }
+
+        private:
+            std::vector<Command*> commands;
+            alignas(64) std::atomic<std::size_t> readPosition{0};
+            alignas(64) std::atomic<std::size_t> writePosition{0};
         };
 
+        // commands submitted by the game thread
+        CommandQueue commandQueue;
+        // executed commands returned to the game thread to be deleted there together with the objects they released
+        CommandQueue processedCommandQueue;
+        std::size_t pendingCommandCount = 0; // accessed only by the game thread
+        std::atomic<std::uint32_t> deviceFrames{0}; // largest number of frames requested by the device
+
+        LoadHistogram mixLoad;
+        LoadHistogram callbackLoad;
+        std::atomic<std::uint64_t> mixedBufferCount{0};
+        std::atomic<std::uint64_t> starvationCount{0};
+
+        mutable std::mutex timingMutex;
+        std::vector<Timing> publishedTimings;
+        std::vector<Timing> timingSnapshot; // preallocated by process, swapped with the published timings
+        std::uint32_t timingPublishBlocks; // number of blocks in about a second
+        std::uint32_t blocksSinceTimingPublish = 0; // accessed only by the mixer thread
+        std::atomic_bool timingResetRequested{false};
+
+#if !defined(__EMSCRIPTEN__)
+        std::atomic_bool running{false};
         thread::Thread mixerThread;
         std::mutex bufferMutex;
         std::condition_variable bufferCondition;
-        Buffer buffer;
-
-        std::queue<CommandBuffer> commandQueue;
-        std::mutex commandQueueMutex;
+#endif
     };
 }
 
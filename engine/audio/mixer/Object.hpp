@@ -56,12 +56,24 @@ namespace ouzel::audio::mixer
                 const auto i = std::find(children.begin(), children.end(), &child);
                 if (i != children.end())
                 {
-                    child.parent = this;
+                    child.parent = nullptr;
                     children.erase(i);
                 }
             }
         }
 
+        // disconnects the object from the graph, so that it can be destroyed on another thread
+        virtual void detach()
+        {
+            if (parent)
+                parent->removeChild(*this);
+
+            for (auto child : children)
+                child->parent = nullptr;
+
+            children.clear();
+        }
+
         void play()
         {
             if (source)
@@ -0,0 +1,381 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include "PhaseVocoder.hpp"
+#include "../../core/Engine.hpp"
+#include "../../math/Constants.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        // polynomial approximation of atan on [0, 1], the error is below 1e-5 radians
+        constexpr float atanCoefficient1 = -0.0464964749F;
+        constexpr float atanCoefficient2 = 0.15931422F;
+        constexpr float atanCoefficient3 = -0.327622764F;
+
+        // Taylor series of sin on [-pi / 2, pi / 2], the error is below 1e-7
+        constexpr float sinCoefficient1 = -1.0F / 6.0F;
+        constexpr float sinCoefficient2 = 1.0F / 120.0F;
+        constexpr float sinCoefficient3 = -1.0F / 5040.0F;
+        constexpr float sinCoefficient4 = 1.0F / 362880.0F;
+        constexpr float sinCoefficient5 = -1.0F / 39916800.0F;
+
+        // adding and subtracting 1.5 * 2^23 rounds a float to the nearest integer
+        constexpr float roundingConstant = 12582912.0F;
+
+        constexpr float tiny = 1e-30F;
+
+        float wrapPhase(float phase) noexcept
+        {
+            return phase - tau<float> * std::round(phase / tau<float>);
+        }
+
+#if defined(__ARM_NEON__)
+        float32x4_t reciprocal(float32x4_t x) noexcept
+        {
+            auto estimate = vrecpeq_f32(x);
+            estimate = vmulq_f32(vrecpsq_f32(x, estimate), estimate);
+            return vmulq_f32(vrecpsq_f32(x, estimate), estimate);
+        }
+
+        float32x4_t reciprocalSqrt(float32x4_t x) noexcept
+        {
+            auto estimate = vrsqrteq_f32(x);
+            estimate = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, estimate), estimate), estimate);
+            return vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, estimate), estimate), estimate);
+        }
+
+        float32x4_t roundVector(float32x4_t x) noexcept
+        {
+            const auto rounding = vdupq_n_f32(roundingConstant);
+            return vsubq_f32(vaddq_f32(x, rounding), rounding);
+        }
+
+        float32x4_t wrapPhase(float32x4_t phase) noexcept
+        {
+            return vmlsq_n_f32(phase, roundVector(vmulq_n_f32(phase, 1.0F / tau<float>)), tau<float>);
+        }
+
+        float32x4_t atan2Vector(float32x4_t y, float32x4_t x) noexcept
+        {
+            const auto ax = vabsq_f32(x);
+            const auto ay = vabsq_f32(y);
+            const auto a = vmulq_f32(vminq_f32(ax, ay), reciprocal(vmaxq_f32(vmaxq_f32(ax, ay), vdupq_n_f32(tiny))));
+            const auto s = vmulq_f32(a, a);
+
+            auto r = vmlaq_f32(vdupq_n_f32(atanCoefficient2), s, vdupq_n_f32(atanCoefficient1));
+            r = vmlaq_f32(vdupq_n_f32(atanCoefficient3), s, r);
+            r = vmlaq_f32(a, vmulq_f32(s, a), r);
+
+            r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(vdupq_n_f32(pi<float> / 2.0F), r), r);
+            r = vbslq_f32(vcltq_f32(x, vdupq_n_f32(0.0F)), vsubq_f32(vdupq_n_f32(pi<float>), r), r);
+
+            // copy the sign of y
+            const auto signMask = vdupq_n_u32(0x80000000U);
+            return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(r),
+                                                   vandq_u32(vreinterpretq_u32_f32(y), signMask)));
+        }
+
+        // x must be in the range [-pi / 2, pi / 2]
+        float32x4_t sinPolynomial(float32x4_t x) noexcept
+        {
+            const auto x2 = vmulq_f32(x, x);
+            auto r = vmlaq_n_f32(vdupq_n_f32(sinCoefficient4), x2, sinCoefficient5);
+            r = vmlaq_f32(vdupq_n_f32(sinCoefficient3), x2, r);
+            r = vmlaq_f32(vdupq_n_f32(sinCoefficient2), x2, r);
+            r = vmlaq_f32(vdupq_n_f32(sinCoefficient1), x2, r);
+            return vmlaq_f32(x, vmulq_f32(x2, x), r);
+        }
+#elif defined(__SSE__)
+        __m128 roundVector(__m128 x) noexcept
+        {
+            const auto rounding = _mm_set1_ps(roundingConstant);
+            return _mm_sub_ps(_mm_add_ps(x, rounding), rounding);
+        }
+
+        __m128 wrapPhase(__m128 phase) noexcept
+        {
+            return _mm_sub_ps(phase, _mm_mul_ps(roundVector(_mm_mul_ps(phase, _mm_set1_ps(1.0F / tau<float>))),
+                                                _mm_set1_ps(tau<float>)));
+        }
+
+        __m128 select(__m128 mask, __m128 a, __m128 b) noexcept
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        __m128 atan2Vector(__m128 y, __m128 x) noexcept
+        {
+            const auto signMask = _mm_set1_ps(-0.0F);
+            const auto ax = _mm_andnot_ps(signMask, x);
+            const auto ay = _mm_andnot_ps(signMask, y);
+            const auto a = _mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(tiny)));
+            const auto s = _mm_mul_ps(a, a);
+
+            auto r = _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(atanCoefficient1)), _mm_set1_ps(atanCoefficient2));
+            r = _mm_add_ps(_mm_mul_ps(s, r), _mm_set1_ps(atanCoefficient3));
+            r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, a), r), a);
+
+            r = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(pi<float> / 2.0F), r), r);
+            r = select(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(pi<float>), r), r);
+
+            // copy the sign of y
+            return _mm_xor_ps(r, _mm_and_ps(y, signMask));
+        }
+
+        // x must be in the range [-pi / 2, pi / 2]
+        __m128 sinPolynomial(__m128 x) noexcept
+        {
+            const auto x2 = _mm_mul_ps(x, x);
+            auto r = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(sinCoefficient5)), _mm_set1_ps(sinCoefficient4));
+            r = _mm_add_ps(_mm_mul_ps(x2, r), _mm_set1_ps(sinCoefficient3));
+            r = _mm_add_ps(_mm_mul_ps(x2, r), _mm_set1_ps(sinCoefficient2));
+            r = _mm_add_ps(_mm_mul_ps(x2, r), _mm_set1_ps(sinCoefficient1));
+            return _mm_add_ps(_mm_mul_ps(_mm_mul_ps(x2, x), r), x);
+        }
+#endif
+    }
+
+    PhaseVocoder::PhaseVocoder(std::uint32_t initFrameSize, std::uint32_t initOversampling):
+        frameSize(initFrameSize),
+        oversampling(initOversampling),
+        hopSize(initOversampling ? initFrameSize / initOversampling : 0),
+        binCount(initFrameSize / 2 + 1),
+        expectedPhase(tau<float> / static_cast<float>(initOversampling)),
+        fft(initFrameSize)
+    {
+        if (oversampling < 2 || !hopSize)
+            throw std::runtime_error("Invalid phase vocoder oversampling");
+
+        // periodic Hann window
+        window.resize(frameSize);
+        for (std::uint32_t i = 0; i < frameSize; ++i)
+            window[i] = 0.5F - 0.5F * std::cos(tau<float> * static_cast<float>(i) / static_cast<float>(frameSize));
+
+        // the frames are windowed twice, the sum of the overlapping squared windows is normalized to one
+        float windowSum = 0.0F;
+        for (std::uint32_t i = 0; i < frameSize; i += hopSize)
+            windowSum += window[i] * window[i];
+        outputScale = 1.0F / windowSum;
+
+        inputFifo.resize(frameSize);
+        outputFifo.resize(hopSize);
+        outputAccumulator.resize(frameSize);
+        frame.resize(frameSize);
+        real.resize(frameSize / 2);
+        imaginary.resize(frameSize / 2);
+
+        const auto paddedBinCount = (binCount + 3) & ~3U;
+        for (auto values : {&binReal, &binImaginary, &magnitudes, &frequencies, &lastPhases, &phaseSums,
+                            &synthesisMagnitudes, &synthesisFrequencies})
+            values->resize(paddedBinCount);
+
+        reset();
+    }
+
+    void PhaseVocoder::reset() noexcept
+    {
+        for (auto values : {&inputFifo, &outputFifo, &outputAccumulator, &lastPhases, &phaseSums})
+            std::fill(values->begin(), values->end(), 0.0F);
+
+        fifoPosition = 0;
+    }
+
+    void PhaseVocoder::process(float ratio, const float* input, float* output, std::uint32_t frames) noexcept
+    {
+        const auto latency = frameSize - hopSize;
+
+        // the output of the previous hop is returned while the input of the next one is collected
+        while (frames)
+        {
+            const auto count = std::min(frames, hopSize - fifoPosition);
+
+            std::copy(input, input + count, &inputFifo[latency + fifoPosition]);
+            std::copy(&outputFifo[fifoPosition], &outputFifo[fifoPosition + count], output);
+
+            input += count;
+            output += count;
+            frames -= count;
+            fifoPosition += count;
+
+            if (fifoPosition == hopSize)
+            {
+                processFrame(ratio);
+                fifoPosition = 0;
+            }
+        }
+    }
+
+    void PhaseVocoder::processFrame(float ratio) noexcept
+    {
+        const auto halfSize = frameSize / 2;
+
+        for (std::uint32_t i = 0; i < frameSize; ++i)
+            frame[i] = inputFifo[i] * window[i];
+
+        fft.forward(frame.data(), real.data(), imaginary.data());
+
+        // unpack the DC and Nyquist bins
+        std::copy(real.begin(), real.end(), binReal.begin());
+        std::copy(imaginary.begin(), imaginary.end(), binImaginary.begin());
+        binImaginary[0] = 0.0F;
+        binReal[halfSize] = imaginary[0];
+        binImaginary[halfSize] = 0.0F;
+
+        // analysis, the true frequency of each bin is estimated from the difference of its phase to the expected one
+        const auto paddedBinCount = static_cast<std::uint32_t>(magnitudes.size());
+        std::uint32_t bin = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            const float firstBins[4] = {0.0F, 1.0F, 2.0F, 3.0F};
+            auto binIndices = vld1q_f32(firstBins);
+
+            for (; bin < paddedBinCount; bin += 4)
+            {
+                const auto re = vld1q_f32(&binReal[bin]);
+                const auto im = vld1q_f32(&binImaginary[bin]);
+                const auto magnitudeSquared = vmlaq_f32(vmulq_f32(re, re), im, im);
+                const auto magnitude = vmulq_f32(magnitudeSquared,
+                                                 reciprocalSqrt(vmaxq_f32(magnitudeSquared, vdupq_n_f32(tiny))));
+                const auto phase = atan2Vector(im, re);
+
+                const auto delta = wrapPhase(vmlsq_n_f32(vsubq_f32(phase, vld1q_f32(&lastPhases[bin])),
+                                                         binIndices, expectedPhase));
+
+                vst1q_f32(&lastPhases[bin], phase);
+                vst1q_f32(&magnitudes[bin], magnitude);
+                vst1q_f32(&frequencies[bin], vmlaq_n_f32(binIndices, delta, 1.0F / expectedPhase));
+
+                binIndices = vaddq_f32(binIndices, vdupq_n_f32(4.0F));
+            }
+#elif defined(__SSE__)
+            auto binIndices = _mm_setr_ps(0.0F, 1.0F, 2.0F, 3.0F);
+
+            for (; bin < paddedBinCount; bin += 4)
+            {
+                const auto re = _mm_loadu_ps(&binReal[bin]);
+                const auto im = _mm_loadu_ps(&binImaginary[bin]);
+                const auto magnitude = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+                const auto phase = atan2Vector(im, re);
+
+                const auto delta = wrapPhase(_mm_sub_ps(_mm_sub_ps(phase, _mm_loadu_ps(&lastPhases[bin])),
+                                                        _mm_mul_ps(binIndices, _mm_set1_ps(expectedPhase))));
+
+                _mm_storeu_ps(&lastPhases[bin], phase);
+                _mm_storeu_ps(&magnitudes[bin], magnitude);
+                _mm_storeu_ps(&frequencies[bin], _mm_add_ps(binIndices,
+                                                            _mm_mul_ps(delta, _mm_set1_ps(1.0F / expectedPhase))));
+
+                binIndices = _mm_add_ps(binIndices, _mm_set1_ps(4.0F));
+            }
+#endif
+        }
+
+        for (; bin < paddedBinCount; ++bin)
+        {
+            const auto phase = std::atan2(binImaginary[bin], binReal[bin]);
+            const auto binIndex = static_cast<float>(bin);
+            const auto delta = wrapPhase(phase - lastPhases[bin] - binIndex * expectedPhase);
+
+            lastPhases[bin] = phase;
+            magnitudes[bin] = std::sqrt(binReal[bin] * binReal[bin] + binImaginary[bin] * binImaginary[bin]);
+            frequencies[bin] = binIndex + delta / expectedPhase;
+        }
+
+        // move the partials to the scaled bins
+        std::fill(synthesisMagnitudes.begin(), synthesisMagnitudes.end(), 0.0F);
+        std::fill(synthesisFrequencies.begin(), synthesisFrequencies.end(), 0.0F);
+
+        for (bin = 0; bin < binCount; ++bin)
+        {
+            const auto index = static_cast<std::uint32_t>(static_cast<float>(bin) * ratio + 0.5F);
+            if (index >= binCount) break;
+
+            synthesisMagnitudes[index] += magnitudes[bin];
+            synthesisFrequencies[index] = frequencies[bin] * ratio;
+        }
+
+        // synthesis, the phase of each bin is advanced by its true frequency
+        bin = 0;
+
+        if (core::isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            const auto halfPi = vdupq_n_f32(pi<float> / 2.0F);
+            const auto minusHalfPi = vdupq_n_f32(-pi<float> / 2.0F);
+
+            for (; bin < paddedBinCount; bin += 4)
+            {
+                const auto phase = wrapPhase(vmlaq_n_f32(vld1q_f32(&phaseSums[bin]),
+                                                         vld1q_f32(&synthesisFrequencies[bin]), expectedPhase));
+                vst1q_f32(&phaseSums[bin], phase);
+
+                // reflect the phase to [-pi / 2, pi / 2] for the sine, cos(x) = sin(pi / 2 - |x|)
+                auto sinArgument = vbslq_f32(vcgtq_f32(phase, halfPi), vsubq_f32(vdupq_n_f32(pi<float>), phase), phase);
+                sinArgument = vbslq_f32(vcltq_f32(phase, minusHalfPi), vsubq_f32(vdupq_n_f32(-pi<float>), phase), sinArgument);
+                const auto cosArgument = vsubq_f32(halfPi, vabsq_f32(phase));
+
+                const auto magnitude = vld1q_f32(&synthesisMagnitudes[bin]);
+                vst1q_f32(&binReal[bin], vmulq_f32(magnitude, sinPolynomial(cosArgument)));
+                vst1q_f32(&binImaginary[bin], vmulq_f32(magnitude, sinPolynomial(sinArgument)));
+            }
+#elif defined(__SSE__)
+            const auto halfPi = _mm_set1_ps(pi<float> / 2.0F);
+            const auto minusHalfPi = _mm_set1_ps(-pi<float> / 2.0F);
+            const auto signMask = _mm_set1_ps(-0.0F);
+
+            for (; bin < paddedBinCount; bin += 4)
+            {
+                const auto phase = wrapPhase(_mm_add_ps(_mm_loadu_ps(&phaseSums[bin]),
+                                                        _mm_mul_ps(_mm_loadu_ps(&synthesisFrequencies[bin]),
+                                                                   _mm_set1_ps(expectedPhase))));
+                _mm_storeu_ps(&phaseSums[bin], phase);
+
+                // reflect the phase to [-pi / 2, pi / 2] for the sine, cos(x) = sin(pi / 2 - |x|)
+                auto sinArgument = select(_mm_cmpgt_ps(phase, halfPi), _mm_sub_ps(_mm_set1_ps(pi<float>), phase), phase);
+                sinArgument = select(_mm_cmplt_ps(phase, minusHalfPi), _mm_sub_ps(_mm_set1_ps(-pi<float>), phase), sinArgument);
+                const auto cosArgument = _mm_sub_ps(halfPi, _mm_andnot_ps(signMask, phase));
+
+                const auto magnitude = _mm_loadu_ps(&synthesisMagnitudes[bin]);
+                _mm_storeu_ps(&binReal[bin], _mm_mul_ps(magnitude, sinPolynomial(cosArgument)));
+                _mm_storeu_ps(&binImaginary[bin], _mm_mul_ps(magnitude, sinPolynomial(sinArgument)));
+            }
+#endif
+        }
+
+        for (; bin < paddedBinCount; ++bin)
+        {
+            const auto phase = wrapPhase(phaseSums[bin] + synthesisFrequencies[bin] * expectedPhase);
+            phaseSums[bin] = phase;
+            binReal[bin] = synthesisMagnitudes[bin] * std::cos(phase);
+            binImaginary[bin] = synthesisMagnitudes[bin] * std::sin(phase);
+        }
+
+        // pack the DC and Nyquist bins
+        std::copy(binReal.begin(), binReal.begin() + halfSize, real.begin());
+        std::copy(binImaginary.begin(), binImaginary.begin() + halfSize, imaginary.begin());
+        imaginary[0] = binReal[halfSize];
+
+        fft.inverse(real.data(), imaginary.data(), frame.data());
+
+        for (std::uint32_t i = 0; i < frameSize; ++i)
+            outputAccumulator[i] += frame[i] * window[i] * outputScale;
+
+        // the first hop is complete
+        std::copy(outputAccumulator.begin(), outputAccumulator.begin() + hopSize, outputFifo.begin());
+        std::copy(outputAccumulator.begin() + hopSize, outputAccumulator.end(), outputAccumulator.begin());
+        std::fill(outputAccumulator.end() - hopSize, outputAccumulator.end(), 0.0F);
+
+        std::copy(inputFifo.begin() + hopSize, inputFifo.end(), inputFifo.begin());
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_PHASEVOCODER_HPP
+#define OUZEL_AUDIO_MIXER_PHASEVOCODER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Fft.hpp"
+
+namespace ouzel::audio::mixer
+{
+    // shifts the pitch of a single channel without changing its duration, the frames are analysed with a short time
+    // Fourier transform and overlapped with a hop of frame size / oversampling samples, which is also the latency
+    // (frame size - hop) of the output
+    class PhaseVocoder final
+    {
+    public:
+        // allocates the buffers and the FFT tables, the frame size must be a power of two
+        explicit PhaseVocoder(std::uint32_t initFrameSize = 1024, std::uint32_t initOversampling = 4);
+
+        auto getFrameSize() const noexcept { return frameSize; }
+        auto getLatency() const noexcept { return frameSize - hopSize; }
+
+        void reset() noexcept;
+
+        // the input and the output can be the same buffer, ratio of 2 shifts by an octave up
+        void process(float ratio, const float* input, float* output, std::uint32_t frames) noexcept;
+
+    private:
+        void processFrame(float ratio) noexcept;
+
+        std::uint32_t frameSize;
+        std::uint32_t oversampling;
+        std::uint32_t hopSize;
+        std::uint32_t binCount; // frame size / 2 + 1
+        float expectedPhase; // phase advance of the first bin during one hop
+        float outputScale;
+
+        Fft fft;
+        std::vector<float> window;
+        std::vector<float> inputFifo;
+        std::vector<float> outputFifo;
+        std::vector<float> outputAccumulator;
+        std::uint32_t fifoPosition = 0;
+
+        std::vector<float> frame;
+        std::vector<float> real; // packed spectrum of the FFT
+        std::vector<float> imaginary;
+
+        // per bin state, padded to a multiple of four bins
+        std::vector<float> binReal;
+        std::vector<float> binImaginary;
+        std::vector<float> magnitudes;
+        std::vector<float> frequencies; // in bins
+        std::vector<float> lastPhases;
+        std::vector<float> phaseSums;
+        std::vector<float> synthesisMagnitudes;
+        std::vector<float> synthesisFrequencies;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_PHASEVOCODER_HPP
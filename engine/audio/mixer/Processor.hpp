@@ -3,8 +3,10 @@
 #ifndef OUZEL_AUDIO_MIXER_PROCESSOR_HPP
 #define OUZEL_AUDIO_MIXER_PROCESSOR_HPP
 
+#include <chrono>
 #include "Object.hpp"
 #include "Bus.hpp"
+#include "SampleView.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -24,8 +26,27 @@ namespace ouzel::audio::mixer
         Processor(Processor&&) = delete;
         Processor& operator=(Processor&&) = delete;
 
+        void detach() override
+        {
+            if (bus) bus->removeProcessor(this);
+            Object::detach();
+        }
+
+        // called when the processor is added to a bus, buffers needed by process must be allocated here
+        virtual void prepare(std::uint32_t, std::uint32_t, std::uint32_t) {}
+
+        // processes the samples in place without allocating memory
         virtual void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                             std::vector<float>& samples) = 0;
+                             SampleView samples) = 0;
+
+        // estimated gain applied to the samples, used to decide which streams are audible
+        virtual float getGain(const Vector3F&) const { return 1.0F; }
+
+        auto getBus() const noexcept { return bus; }
+
+        // time spent in process
+        auto getProcessingTime() const noexcept { return processingTime; }
+        void resetProcessingTime() noexcept { processingTime = {}; }
 
         auto isEnabled() const noexcept { return enabled; }
         void setEnabled(bool newEnabled) { enabled = newEnabled; }
@@ -33,6 +54,7 @@ namespace ouzel::audio::mixer
     private:
         Bus* bus = nullptr;
         bool enabled = true;
+        std::chrono::steady_clock::duration processingTime{};
     };
 }
 
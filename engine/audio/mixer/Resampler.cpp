@@ -0,0 +1,258 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "Resampler.hpp"
+#include "Kernels.hpp"
+#include "../../math/Constants.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        constexpr std::uint32_t sincHalfTaps = 16;
+        constexpr std::uint32_t sincTaps = sincHalfTaps * 2;
+        constexpr std::uint32_t sincPhases = 64;
+
+        // number of source frames needed on each side of the interpolated position
+        constexpr std::uint32_t getHalfTaps(Resampler::Quality quality)
+        {
+            switch (quality)
+            {
+                case Resampler::Quality::linear: return 1;
+                case Resampler::Quality::cubic: return 2;
+                case Resampler::Quality::sinc: return sincHalfTaps;
+                default: throw std::runtime_error("Invalid resampler quality");
+            }
+        }
+
+        inline float cubic(const float* source, float t) noexcept
+        {
+            // Catmull-Rom spline through source[-1], source[0], source[1] and source[2]
+            const float p0 = source[-1];
+            const float p1 = source[0];
+            const float p2 = source[1];
+            const float p3 = source[2];
+
+            return p1 + 0.5F * t * (p2 - p0 + t * (2.0F * p0 - 5.0F * p1 + 4.0F * p2 - p3 +
+                                                   t * (3.0F * (p1 - p2) + p3 - p0)));
+        }
+    }
+
+    void Resampler::setQuality(Quality newQuality)
+    {
+        quality = newQuality;
+        reset();
+        updateFilter();
+    }
+
+    void Resampler::reset()
+    {
+        const auto halfTaps = getHalfTaps(quality);
+
+        // the history starts with silence before the first source frame
+        historyFrames = halfTaps - 1;
+        position = halfTaps - 1;
+        fraction = 0;
+
+        history.resize(channels);
+        for (auto& channelHistory : history)
+            channelHistory.assign(historyFrames, 0.0F);
+    }
+
+    void Resampler::prepare(std::uint32_t channelCount,
+                            std::uint32_t sourceSampleRate,
+                            std::uint32_t targetSampleRate,
+                            std::uint32_t maxFrames)
+    {
+        channels = channelCount;
+        sourceRate = sourceSampleRate;
+        targetRate = targetSampleRate;
+        reset();
+        updateFilter();
+
+        // the fractional position and the frames skipped by the previous block can add a few more frames
+        const auto halfTaps = getHalfTaps(quality);
+        maxSourceFrames = static_cast<std::uint32_t>(static_cast<std::uint64_t>(maxFrames) * sourceRate / targetRate) + halfTaps * 2 + 2;
+
+        for (auto& channelHistory : history)
+            channelHistory.reserve(maxSourceFrames + halfTaps * 2);
+    }
+
+    void Resampler::setParameters(std::uint32_t channelCount,
+                                  std::uint32_t sourceSampleRate,
+                                  std::uint32_t targetSampleRate)
+    {
+        if (channelCount != channels ||
+            sourceSampleRate != sourceRate ||
+            targetSampleRate != targetRate)
+        {
+            channels = channelCount;
+            sourceRate = sourceSampleRate;
+            targetRate = targetSampleRate;
+            reset();
+            updateFilter();
+        }
+    }
+
+    std::uint32_t Resampler::getSourceFrames(std::uint32_t channelCount,
+                                             std::uint32_t sourceSampleRate,
+                                             std::uint32_t targetSampleRate,
+                                             std::uint32_t frames)
+    {
+        setParameters(channelCount, sourceSampleRate, targetSampleRate);
+
+        if (frames == 0) return 0;
+
+        // source frames up to the last one needed to interpolate the last frame
+        const auto lastPosition = position + (fraction + static_cast<std::uint64_t>(frames - 1) * sourceRate) / targetRate;
+        const auto neededFrames = lastPosition + getHalfTaps(quality) + 1;
+
+        return (neededFrames > historyFrames) ? static_cast<std::uint32_t>(neededFrames - historyFrames) : 0;
+    }
+
+    void Resampler::resample(const std::vector<float>& sourceSamples, std::uint32_t sourceFrames,
+                             std::uint32_t frames, std::vector<float>& samples)
+    {
+        samples.resize(frames * channels);
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const float* sourceChannel = &sourceSamples[channel * sourceFrames];
+            history[channel].insert(history[channel].end(), sourceChannel, sourceChannel + sourceFrames);
+        }
+
+        historyFrames += sourceFrames;
+
+        const auto halfTaps = getHalfTaps(quality);
+        const auto step = sourceRate / targetRate;
+        const auto stepFraction = sourceRate % targetRate;
+        const auto fractionScale = 1.0F / static_cast<float>(targetRate);
+
+        for (std::uint32_t frame = 0; frame < frames; ++frame)
+        {
+            const auto t = static_cast<float>(fraction) * fractionScale;
+
+            switch (quality)
+            {
+                case Quality::linear:
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        const float* source = &history[channel][position];
+                        samples[channel * frames + frame] = source[0] + (source[1] - source[0]) * t;
+                    }
+                    break;
+                case Quality::cubic:
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                        samples[channel * frames + frame] = cubic(&history[channel][position], t);
+                    break;
+                case Quality::sinc:
+                {
+                    // interpolate between the two nearest phases of the filter
+                    const auto phasePosition = t * sincPhases;
+                    const auto phase = std::min(static_cast<std::uint32_t>(phasePosition), sincPhases - 1);
+                    const auto phaseFraction = phasePosition - static_cast<float>(phase);
+
+                    std::copy(&filter[phase * sincTaps], &filter[(phase + 1) * sincTaps], coefficients.begin());
+                    scale(coefficients.data(), 1.0F - phaseFraction, sincTaps);
+                    scaleAccumulate(coefficients.data(), &filter[(phase + 1) * sincTaps], phaseFraction, sincTaps);
+
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                        samples[channel * frames + frame] = dot(&history[channel][position - (sincHalfTaps - 1)],
+                                                                coefficients.data(), sincTaps);
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Invalid resampler quality");
+            }
+
+            position += step;
+            fraction += stepFraction;
+            if (fraction >= targetRate)
+            {
+                fraction -= targetRate;
+                ++position;
+            }
+        }
+
+        // keep only the frames needed for the next block
+        const auto removeFrames = std::min(position - (halfTaps - 1), historyFrames);
+        for (auto& channelHistory : history)
+            channelHistory.erase(channelHistory.begin(), channelHistory.begin() + removeFrames);
+
+        historyFrames -= removeFrames;
+        position -= removeFrames;
+    }
+
+    std::uint32_t Resampler::skip(std::uint32_t channelCount,
+                                  std::uint32_t sourceSampleRate,
+                                  std::uint32_t targetSampleRate,
+                                  std::uint32_t frames)
+    {
+        setParameters(channelCount, sourceSampleRate, targetSampleRate);
+
+        const auto halfTaps = getHalfTaps(quality);
+        const auto advance = fraction + static_cast<std::uint64_t>(frames) * sourceRate;
+        const auto newPosition = position + advance / targetRate;
+        fraction = static_cast<std::uint32_t>(advance % targetRate);
+
+        if (newPosition < historyFrames)
+        {
+            // the new position is still in the history, keep the frames that are needed for the next block
+            const auto removeFrames = static_cast<std::uint32_t>(newPosition) - (halfTaps - 1);
+            for (auto& channelHistory : history)
+                channelHistory.erase(channelHistory.begin(), channelHistory.begin() + removeFrames);
+
+            historyFrames -= removeFrames;
+            position = halfTaps - 1;
+            return 0;
+        }
+
+        const auto sourceFrames = static_cast<std::uint32_t>(newPosition - historyFrames);
+
+        historyFrames = halfTaps - 1;
+        position = halfTaps - 1;
+        for (auto& channelHistory : history)
+            channelHistory.assign(historyFrames, 0.0F);
+
+        return sourceFrames;
+    }
+
+    void Resampler::updateFilter()
+    {
+        if (quality != Quality::sinc || !sourceRate || !targetRate) return;
+
+        // lower the cutoff frequency below the target Nyquist frequency when downsampling
+        const auto cutoff = std::min(1.0F, static_cast<float>(targetRate) / static_cast<float>(sourceRate));
+
+        filter.resize((sincPhases + 1) * sincTaps);
+        coefficients.resize(sincTaps);
+
+        for (std::uint32_t phase = 0; phase <= sincPhases; ++phase)
+        {
+            const auto offset = static_cast<float>(phase) / sincPhases;
+            float* row = &filter[phase * sincTaps];
+            float sum = 0.0F;
+
+            for (std::uint32_t tap = 0; tap < sincTaps; ++tap)
+            {
+                // distance from the interpolated position to the source frame of this tap
+                const auto x = static_cast<float>(tap) - static_cast<float>(sincHalfTaps - 1) - offset;
+                const auto sinc = (x == 0.0F) ? 1.0F : std::sin(pi<float> * cutoff * x) / (pi<float> * cutoff * x);
+
+                // Blackman window
+                const auto w = x / sincHalfTaps;
+                const auto window = (std::fabs(w) < 1.0F) ?
+                    0.42F + 0.5F * std::cos(pi<float> * w) + 0.08F * std::cos(2.0F * pi<float> * w) : 0.0F;
+
+                row[tap] = sinc * window;
+                sum += row[tap];
+            }
+
+            // normalize to unity gain
+            for (std::uint32_t tap = 0; tap < sincTaps; ++tap)
+                row[tap] /= sum;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_RESAMPLER_HPP
+#define OUZEL_AUDIO_MIXER_RESAMPLER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::audio::mixer
+{
+    // streaming sample rate converter, keeps the fractional position and the source history between blocks
+    class Resampler final
+    {
+    public:
+        enum class Quality
+        {
+            linear,
+            cubic,
+            sinc // polyphase windowed sinc
+        };
+
+        explicit Resampler(Quality initQuality = Quality::linear) noexcept:
+            quality(initQuality)
+        {
+        }
+
+        auto getQuality() const noexcept { return quality; }
+        void setQuality(Quality newQuality);
+
+        void reset();
+
+        // sets the conversion parameters and preallocates the history for blocks of up to the given number of frames
+        void prepare(std::uint32_t channelCount,
+                     std::uint32_t sourceSampleRate,
+                     std::uint32_t targetSampleRate,
+                     std::uint32_t maxFrames);
+
+        // maximum number of source frames needed for a block of the size passed to prepare
+        auto getMaxSourceFrames() const noexcept { return maxSourceFrames; }
+
+        // returns the number of source frames that must be passed to the next resample call to produce the given
+        // number of frames, resets the resampler if the channel count or the sample rates have changed
+        std::uint32_t getSourceFrames(std::uint32_t channels,
+                                      std::uint32_t sourceSampleRate,
+                                      std::uint32_t targetSampleRate,
+                                      std::uint32_t frames);
+
+        // converts planar source samples to planar samples with the parameters of the last getSourceFrames call
+        void resample(const std::vector<float>& sourceSamples, std::uint32_t sourceFrames,
+                      std::uint32_t frames, std::vector<float>& samples);
+
+        // advances the position by the given number of frames without interpolating and returns the number of source
+        // frames that must be skipped, the history is replaced with silence if the position moves past it
+        std::uint32_t skip(std::uint32_t channels,
+                           std::uint32_t sourceSampleRate,
+                           std::uint32_t targetSampleRate,
+                           std::uint32_t frames);
+
+    private:
+        void setParameters(std::uint32_t channelCount,
+                           std::uint32_t sourceSampleRate,
+                           std::uint32_t targetSampleRate);
+        void updateFilter();
+
+        Quality quality;
+        std::uint32_t channels = 0;
+        std::uint32_t sourceRate = 0;
+        std::uint32_t targetRate = 0;
+
+        std::uint32_t position = 0; // index of the current source frame in the history
+        std::uint32_t fraction = 0; // fractional part of the position in units of 1 / targetRate
+        std::uint32_t historyFrames = 0;
+        std::uint32_t maxSourceFrames = 0;
+        std::vector<std::vector<float>> history;
+
+        std::vector<float> filter; // coefficients for each of the sinc phases
+        std::vector<float> coefficients;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_RESAMPLER_HPP
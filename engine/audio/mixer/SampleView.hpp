@@ -0,0 +1,40 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_SAMPLEVIEW_HPP
+#define OUZEL_AUDIO_MIXER_SAMPLEVIEW_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace ouzel::audio::mixer
+{
+    // non-owning view of planar samples that can be modified but not resized
+    class SampleView final
+    {
+    public:
+        constexpr SampleView(float* initData, std::size_t initSize) noexcept:
+            samples(initData), sampleCount(initSize)
+        {
+        }
+
+        SampleView(std::vector<float>& vector) noexcept:
+            samples(vector.data()), sampleCount(vector.size())
+        {
+        }
+
+        constexpr float* data() const noexcept { return samples; }
+        constexpr std::size_t size() const noexcept { return sampleCount; }
+        constexpr bool empty() const noexcept { return sampleCount == 0; }
+
+        constexpr float* begin() const noexcept { return samples; }
+        constexpr float* end() const noexcept { return samples + sampleCount; }
+
+        constexpr float& operator[](std::size_t index) const noexcept { return samples[index]; }
+
+    private:
+        float* samples;
+        std::size_t sampleCount;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_SAMPLEVIEW_HPP
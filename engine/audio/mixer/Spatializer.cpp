@@ -0,0 +1,217 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include "Spatializer.hpp"
+#include "../../core/Engine.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        // squared distances below this are treated as zero
+        constexpr float minDistanceSquared = 1e-12F;
+
+#if defined(__ARM_NEON__)
+        // ARMv7 NEON has no division and square root, the estimates are refined with two Newton-Raphson steps
+        float32x4_t reciprocal(float32x4_t x) noexcept
+        {
+            auto estimate = vrecpeq_f32(x);
+            estimate = vmulq_f32(vrecpsq_f32(x, estimate), estimate);
+            return vmulq_f32(vrecpsq_f32(x, estimate), estimate);
+        }
+
+        float32x4_t reciprocalSqrt(float32x4_t x) noexcept
+        {
+            auto estimate = vrsqrteq_f32(x);
+            estimate = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, estimate), estimate), estimate);
+            return vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, estimate), estimate), estimate);
+        }
+#endif
+    }
+
+    std::uint32_t Spatializer::addEmitter(const Processor* processor)
+    {
+        std::uint32_t emitter;
+
+        if (!freeEmitters.empty())
+        {
+            emitter = freeEmitters.back();
+            freeEmitters.pop_back();
+            processors[emitter] = processor;
+        }
+        else
+        {
+            emitter = static_cast<std::uint32_t>(processors.size());
+            processors.push_back(processor);
+
+            const auto paddedSize = (processors.size() + 3) & ~std::size_t{3};
+            if (positionsX.size() < paddedSize)
+            {
+                for (auto values : {&positionsX, &positionsY, &positionsZ,
+                                    &listenerPositionsX, &listenerPositionsY, &listenerPositionsZ,
+                                    &listenerRightsY, &listenerRightsZ,
+                                    &attenuations, &leftGains, &rightGains})
+                    values->resize(paddedSize, 0.0F);
+
+                listenerRightsX.resize(paddedSize, 1.0F);
+                rolloffFactors.resize(paddedSize, 1.0F);
+                minDistances.resize(paddedSize, 1.0F);
+                maxDistances.resize(paddedSize, FLT_MAX);
+            }
+        }
+
+        setPosition(emitter, Vector3F{});
+        setAttenuation(emitter, 1.0F, 1.0F, FLT_MAX);
+        setListener(emitter, Vector3F{}, QuaternionF::identity());
+
+        return emitter;
+    }
+
+    void Spatializer::removeEmitter(std::uint32_t emitter)
+    {
+        processors[emitter] = nullptr;
+        freeEmitters.push_back(emitter);
+    }
+
+    void Spatializer::setPosition(std::uint32_t emitter, const Vector3F& position) noexcept
+    {
+        positionsX[emitter] = position.v[0];
+        positionsY[emitter] = position.v[1];
+        positionsZ[emitter] = position.v[2];
+    }
+
+    void Spatializer::setAttenuation(std::uint32_t emitter, float rolloffFactor,
+                                     float minDistance, float maxDistance) noexcept
+    {
+        rolloffFactors[emitter] = rolloffFactor;
+        minDistances[emitter] = minDistance;
+        maxDistances[emitter] = maxDistance;
+    }
+
+    void Spatializer::setListener(std::uint32_t emitter, const Vector3F& position,
+                                  const QuaternionF& rotation) noexcept
+    {
+        const auto right = rotation.getRightVector();
+
+        listenerPositionsX[emitter] = position.v[0];
+        listenerPositionsY[emitter] = position.v[1];
+        listenerPositionsZ[emitter] = position.v[2];
+        listenerRightsX[emitter] = right.v[0];
+        listenerRightsY[emitter] = right.v[1];
+        listenerRightsZ[emitter] = right.v[2];
+    }
+
+    void Spatializer::update() noexcept
+    {
+        const auto count = static_cast<std::uint32_t>(processors.size());
+        std::uint32_t i = 0;
+
+        if (core::isSimdAvailable)
+        {
+            // the arrays are padded, so that the last group of four is always complete
+#if defined(__ARM_NEON__)
+            const auto zero = vdupq_n_f32(0.0F);
+            const auto half = vdupq_n_f32(0.5F);
+            const auto one = vdupq_n_f32(1.0F);
+            const auto minusOne = vdupq_n_f32(-1.0F);
+            const auto minSquared = vdupq_n_f32(minDistanceSquared);
+
+            for (; i < count; i += 4)
+            {
+                const auto dx = vsubq_f32(vld1q_f32(&positionsX[i]), vld1q_f32(&listenerPositionsX[i]));
+                const auto dy = vsubq_f32(vld1q_f32(&positionsY[i]), vld1q_f32(&listenerPositionsY[i]));
+                const auto dz = vsubq_f32(vld1q_f32(&positionsZ[i]), vld1q_f32(&listenerPositionsZ[i]));
+                const auto distanceSquared = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+                const auto inverseDistance = reciprocalSqrt(vmaxq_f32(distanceSquared, minSquared));
+                const auto distance = vmulq_f32(distanceSquared, inverseDistance);
+
+                // inverse distance attenuation clamped to the minimum and maximum distance
+                const auto minDistance = vld1q_f32(&minDistances[i]);
+                const auto clampedDistance = vmaxq_f32(vminq_f32(distance, vld1q_f32(&maxDistances[i])), minDistance);
+                const auto denominator = vmlaq_f32(minDistance, vld1q_f32(&rolloffFactors[i]),
+                                                   vsubq_f32(clampedDistance, minDistance));
+                const auto attenuation = vbslq_f32(vcgtq_f32(denominator, zero),
+                                                   vmulq_f32(minDistance, reciprocal(vmaxq_f32(denominator, minSquared))),
+                                                   one);
+
+                // cosine of the angle between the right vector of the listener and the direction to the emitter
+                const auto dot = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, vld1q_f32(&listenerRightsX[i])),
+                                                     dy, vld1q_f32(&listenerRightsY[i])),
+                                           dz, vld1q_f32(&listenerRightsZ[i]));
+                const auto pan = vminq_f32(vmaxq_f32(vmulq_f32(dot, inverseDistance), minusOne), one);
+
+                const auto left = vmlsq_f32(half, pan, half);
+                const auto right = vmlaq_f32(half, pan, half);
+
+                vst1q_f32(&attenuations[i], attenuation);
+                vst1q_f32(&leftGains[i], vmulq_f32(left, reciprocalSqrt(vmaxq_f32(left, minSquared))));
+                vst1q_f32(&rightGains[i], vmulq_f32(right, reciprocalSqrt(vmaxq_f32(right, minSquared))));
+            }
+#elif defined(__SSE__)
+            const auto zero = _mm_setzero_ps();
+            const auto half = _mm_set1_ps(0.5F);
+            const auto one = _mm_set1_ps(1.0F);
+            const auto minusOne = _mm_set1_ps(-1.0F);
+            const auto minSquared = _mm_set1_ps(minDistanceSquared);
+
+            for (; i < count; i += 4)
+            {
+                const auto dx = _mm_sub_ps(_mm_loadu_ps(&positionsX[i]), _mm_loadu_ps(&listenerPositionsX[i]));
+                const auto dy = _mm_sub_ps(_mm_loadu_ps(&positionsY[i]), _mm_loadu_ps(&listenerPositionsY[i]));
+                const auto dz = _mm_sub_ps(_mm_loadu_ps(&positionsZ[i]), _mm_loadu_ps(&listenerPositionsZ[i]));
+                const auto distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                                        _mm_mul_ps(dz, dz));
+                const auto distance = _mm_sqrt_ps(distanceSquared);
+                const auto inverseDistance = _mm_div_ps(one, _mm_max_ps(distance, _mm_sqrt_ps(minSquared)));
+
+                // inverse distance attenuation clamped to the minimum and maximum distance
+                const auto minDistance = _mm_loadu_ps(&minDistances[i]);
+                const auto clampedDistance = _mm_max_ps(_mm_min_ps(distance, _mm_loadu_ps(&maxDistances[i])), minDistance);
+                const auto denominator = _mm_add_ps(minDistance, _mm_mul_ps(_mm_loadu_ps(&rolloffFactors[i]),
+                                                                            _mm_sub_ps(clampedDistance, minDistance)));
+                const auto positive = _mm_cmpgt_ps(denominator, zero);
+                const auto attenuation = _mm_or_ps(_mm_and_ps(positive, _mm_div_ps(minDistance, _mm_max_ps(denominator, minSquared))),
+                                                   _mm_andnot_ps(positive, one));
+
+                // cosine of the angle between the right vector of the listener and the direction to the emitter
+                const auto dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&listenerRightsX[i])),
+                                                       _mm_mul_ps(dy, _mm_loadu_ps(&listenerRightsY[i]))),
+                                            _mm_mul_ps(dz, _mm_loadu_ps(&listenerRightsZ[i])));
+                const auto pan = _mm_min_ps(_mm_max_ps(_mm_mul_ps(dot, inverseDistance), minusOne), one);
+
+                _mm_storeu_ps(&attenuations[i], attenuation);
+                _mm_storeu_ps(&leftGains[i], _mm_sqrt_ps(_mm_sub_ps(half, _mm_mul_ps(pan, half))));
+                _mm_storeu_ps(&rightGains[i], _mm_sqrt_ps(_mm_add_ps(half, _mm_mul_ps(pan, half))));
+            }
+#endif
+        }
+
+        for (; i < count; ++i)
+        {
+            const auto dx = positionsX[i] - listenerPositionsX[i];
+            const auto dy = positionsY[i] - listenerPositionsY[i];
+            const auto dz = positionsZ[i] - listenerPositionsZ[i];
+            const auto distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+            const auto inverseDistance = 1.0F / std::max(distance, std::sqrt(minDistanceSquared));
+
+            const auto minDistance = minDistances[i];
+            const auto clampedDistance = std::max(std::min(distance, maxDistances[i]), minDistance);
+            const auto denominator = minDistance + rolloffFactors[i] * (clampedDistance - minDistance);
+            attenuations[i] = denominator > 0.0F ? minDistance / std::max(denominator, minDistanceSquared) : 1.0F;
+
+            const auto dot = dx * listenerRightsX[i] + dy * listenerRightsY[i] + dz * listenerRightsZ[i];
+            const auto pan = std::clamp(dot * inverseDistance, -1.0F, 1.0F);
+
+            // equal-power pan law, the sum of the squared gains is one
+            leftGains[i] = std::sqrt(0.5F - pan * 0.5F);
+            rightGains[i] = std::sqrt(0.5F + pan * 0.5F);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
+#define OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../../math/Quaternion.hpp"
+#include "../../math/Vector.hpp"
+
+namespace ouzel::audio::mixer
+{
+    class Processor;
+
+    // distance attenuation and equal-power pan gains of all of the positional emitters, the emitters are stored as a
+    // structure of arrays so that the gains of four emitters are calculated at once
+    class Spatializer final
+    {
+    public:
+        // allocates the emitter, must not be called while mixing
+        std::uint32_t addEmitter(const Processor* processor);
+        void removeEmitter(std::uint32_t emitter);
+
+        auto getEmitterCount() const noexcept { return static_cast<std::uint32_t>(processors.size()); }
+        auto getProcessor(std::uint32_t emitter) const noexcept { return processors[emitter]; }
+
+        void setPosition(std::uint32_t emitter, const Vector3F& position) noexcept;
+        void setAttenuation(std::uint32_t emitter, float rolloffFactor, float minDistance, float maxDistance) noexcept;
+        void setListener(std::uint32_t emitter, const Vector3F& position, const QuaternionF& rotation) noexcept;
+
+        // calculates the gains of all of the emitters
+        void update() noexcept;
+
+        auto getAttenuation(std::uint32_t emitter) const noexcept { return attenuations[emitter]; }
+        auto getLeftGain(std::uint32_t emitter) const noexcept { return leftGains[emitter]; }
+        auto getRightGain(std::uint32_t emitter) const noexcept { return rightGains[emitter]; }
+
+    private:
+        std::vector<const Processor*> processors; // null for the free emitters
+        std::vector<std::uint32_t> freeEmitters;
+
+        // padded to a multiple of four emitters
+        std::vector<float> positionsX;
+        std::vector<float> positionsY;
+        std::vector<float> positionsZ;
+        std::vector<float> listenerPositionsX;
+        std::vector<float> listenerPositionsY;
+        std::vector<float> listenerPositionsZ;
+        std::vector<float> listenerRightsX; // right vectors of the listeners
+        std::vector<float> listenerRightsY;
+        std::vector<float> listenerRightsZ;
+        std::vector<float> rolloffFactors;
+        std::vector<float> minDistances;
+        std::vector<float> maxDistances;
+
+        std::vector<float> attenuations;
+        std::vector<float> leftGains;
+        std::vector<float> rightGains;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
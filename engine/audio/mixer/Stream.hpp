@@ -6,6 +6,7 @@
 #include "Object.hpp"
 #include "Bus.hpp"
 #include "Data.hpp"
+#include "Resampler.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -34,6 +35,9 @@ namespace ouzel::audio::mixer
 
         auto& getData() const noexcept { return data; }
 
+        auto& getResampler() noexcept { return resampler; }
+
+        auto getOutput() const noexcept { return output; }
         void setOutput(Bus* newOutput)
         {
             if (output) output->removeInput(this);
@@ -41,23 +45,47 @@ namespace ouzel::audio::mixer
             if (output) output->addInput(this);
         }
 
+        void detach() override
+        {
+            setOutput(nullptr);
+            Object::detach();
+        }
+
+        // a stream stops playing and rewinds itself when it reaches the end of its data, no event is sent for it
         auto isPlaying() const noexcept { return playing; }
         void play() { playing = true; }
 
+        auto getPriority() const noexcept { return priority; }
+        void setPriority(std::int32_t newPriority) { priority = newPriority; }
+
+        // virtual streams are not mixed, they only advance their position
+        auto isVirtual() const noexcept { return virtualized; }
+        void setVirtual(bool newVirtual) { virtualized = newVirtual; }
+
         void stop(bool shouldReset)
         {
             playing = false;
-            if (shouldReset) reset();
+            if (shouldReset)
+            {
+                reset();
+                resampler.reset();
+            }
         }
 
         virtual void reset() = 0;
 
         virtual void getSamples(std::uint32_t frames, std::vector<float>& samples) = 0;
 
+        // advances the position by the given number of frames without producing samples
+        virtual void skip(std::uint32_t frames) = 0;
+
     protected:
         Data& data;
         Bus* output = nullptr;
         bool playing = false;
+        bool virtualized = false;
+        std::int32_t priority = 0;
+        Resampler resampler;
     };
 }
 
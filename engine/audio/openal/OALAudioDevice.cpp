@@ -18,6 +18,7 @@ extern "C" id const AVAudioSessionCategoryAmbient;
 #include "ALCErrorCategory.hpp"
 #include "../../core/Engine.hpp"
 #include "../../utils/Log.hpp"
+#include "../../utils/Profiler.hpp"
 
 #ifndef AL_FORMAT_MONO_FLOAT32
 #  define AL_FORMAT_MONO_FLOAT32 0x10010
@@ -345,6 +346,7 @@ namespace ouzel::audio::openal
     void AudioDevice::run()
     {
         thread::setCurrentThreadName("Audio");
+        OUZEL_PROFILE_THREAD("Audio");
 
 #if !defined(__EMSCRIPTEN__)
         while (running)
@@ -7,6 +7,7 @@
 #include "WASAPIAudioDevice.hpp"
 #include "WASAPIErrorCategory.hpp"
 #include "../../core/Engine.hpp"
+#include "../../utils/Profiler.hpp"
 
 const CLSID CLSID_MMDeviceEnumerator = __uuidof(MMDeviceEnumerator);
 const IID IID_IMMDeviceEnumerator = __uuidof(IMMDeviceEnumerator);
@@ -263,6 +264,7 @@ namespace ouzel::audio::wasapi
     void AudioDevice::run()
     {
         thread::setCurrentThreadName("Audio");
+        OUZEL_PROFILE_THREAD("Audio");
 
         while (running)
         {
@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include "Setup.h"
 #include "Engine.hpp"
+#include "../utils/Profiler.hpp"
 #include "../utils/Utils.hpp"
 #include "../graphics/Graphics.hpp"
 #include "../audio/Audio.hpp"
@@ -103,6 +104,9 @@ namespace ouzel::core
             bool highDpi = true; // should high DPI resolution be used
             audio::Driver audioDriver;
             audio::Settings audioSettings;
+            float fixedUpdateRate = 0.0F;
+            std::uint32_t maxFixedUpdates = 5;
+            float headlessFrameRate = 0.0F;
         };
 
         Settings parseSettings(const ini::Data& defaultSettings,
@@ -175,6 +179,52 @@ namespace ouzel::core
 
             settings.audioSettings.audioDevice = userEngineSection.getValue("audioDevice", defaultEngineSection.getValue("audioDevice"));
 
+            const auto& audioBufferCountValue = userEngineSection.getValue("audioBufferCount", defaultEngineSection.getValue("audioBufferCount"));
+            if (!audioBufferCountValue.empty()) settings.audioSettings.bufferCount = static_cast<std::uint32_t>(std::stoul(audioBufferCountValue));
+
+            const auto& audioResamplerQualityValue = userEngineSection.getValue("audioResamplerQuality", defaultEngineSection.getValue("audioResamplerQuality"));
+            if (audioResamplerQualityValue == "linear")
+                settings.audioSettings.resamplerQuality = audio::mixer::Resampler::Quality::linear;
+            else if (audioResamplerQualityValue == "cubic")
+                settings.audioSettings.resamplerQuality = audio::mixer::Resampler::Quality::cubic;
+            else if (audioResamplerQualityValue == "sinc")
+                settings.audioSettings.resamplerQuality = audio::mixer::Resampler::Quality::sinc;
+            else if (!audioResamplerQualityValue.empty())
+                throw std::runtime_error("Invalid resampler quality");
+
+            const auto& audioPreresampleValue = userEngineSection.getValue("audioPreresample", defaultEngineSection.getValue("audioPreresample"));
+            if (!audioPreresampleValue.empty()) settings.audioSettings.preresample = (audioPreresampleValue == "true" || audioPreresampleValue == "1" || audioPreresampleValue == "yes");
+
+            const auto& audioMaxVoicesValue = userEngineSection.getValue("audioMaxVoices", defaultEngineSection.getValue("audioMaxVoices"));
+            if (!audioMaxVoicesValue.empty()) settings.audioSettings.maxVoices = static_cast<std::uint32_t>(std::stoul(audioMaxVoicesValue));
+
+            const auto& audioAudibilityThresholdValue = userEngineSection.getValue("audioAudibilityThreshold", defaultEngineSection.getValue("audioAudibilityThreshold"));
+            if (!audioAudibilityThresholdValue.empty()) settings.audioSettings.audibilityThreshold = std::stof(audioAudibilityThresholdValue);
+
+            const auto& audioPcmCacheSizeValue = userEngineSection.getValue("audioPcmCacheSize", defaultEngineSection.getValue("audioPcmCacheSize"));
+            if (!audioPcmCacheSizeValue.empty()) settings.audioSettings.pcmCacheSize = static_cast<std::size_t>(std::stoull(audioPcmCacheSizeValue));
+
+            const auto& audioPcmCacheMaxSoundSizeValue = userEngineSection.getValue("audioPcmCacheMaxSoundSize", defaultEngineSection.getValue("audioPcmCacheMaxSoundSize"));
+            if (!audioPcmCacheMaxSoundSizeValue.empty()) settings.audioSettings.pcmCacheMaxSoundSize = static_cast<std::size_t>(std::stoull(audioPcmCacheMaxSoundSizeValue));
+
+            const auto& audioPcmCacheInt16Value = userEngineSection.getValue("audioPcmCacheInt16", defaultEngineSection.getValue("audioPcmCacheInt16"));
+            if (!audioPcmCacheInt16Value.empty()) settings.audioSettings.pcmCacheInt16 = (audioPcmCacheInt16Value == "true" || audioPcmCacheInt16Value == "1" || audioPcmCacheInt16Value == "yes");
+
+            const auto& audioMixerThreadsValue = userEngineSection.getValue("audioMixerThreads", defaultEngineSection.getValue("audioMixerThreads"));
+            if (!audioMixerThreadsValue.empty()) settings.audioSettings.mixerThreads = static_cast<std::uint32_t>(std::stoul(audioMixerThreadsValue));
+
+            const auto& audioOfflineValue = userEngineSection.getValue("audioOffline", defaultEngineSection.getValue("audioOffline"));
+            if (!audioOfflineValue.empty()) settings.audioSettings.offline = (audioOfflineValue == "true" || audioOfflineValue == "1" || audioOfflineValue == "yes");
+
+            const auto& fixedUpdateRateValue = userEngineSection.getValue("fixedUpdateRate", defaultEngineSection.getValue("fixedUpdateRate"));
+            if (!fixedUpdateRateValue.empty()) settings.fixedUpdateRate = std::stof(fixedUpdateRateValue);
+
+            const auto& maxFixedUpdatesValue = userEngineSection.getValue("maxFixedUpdates", defaultEngineSection.getValue("maxFixedUpdates"));
+            if (!maxFixedUpdatesValue.empty()) settings.maxFixedUpdates = static_cast<std::uint32_t>(std::stoul(maxFixedUpdatesValue));
+
+            const auto& headlessFrameRateValue = userEngineSection.getValue("headlessFrameRate", defaultEngineSection.getValue("headlessFrameRate"));
+            if (!headlessFrameRateValue.empty()) settings.headlessFrameRate = std::stof(headlessFrameRateValue);
+
             return settings;
         }
     }
@@ -213,10 +263,21 @@ namespace ouzel::core
     void Engine::init()
     {
         thread::setCurrentThreadName("Main");
+        OUZEL_PROFILE_THREAD("Main");
 
         const auto settingsPath = fileSystem.getStorageDirectory() / "settings.ini";
-        const auto settings = parseSettings(fileSystem.resourceFileExists("settings.ini") ? ini::parse(fileSystem.readFile("settings.ini")) : ini::Data{},
-                                            fileSystem.fileExists(settingsPath) ? ini::parse(fileSystem.readFile(settingsPath)) : ini::Data{});
+        auto settings = parseSettings(fileSystem.resourceFileExists("settings.ini") ? ini::parse(fileSystem.readFile("settings.ini")) : ini::Data{},
+                                      fileSystem.fileExists(settingsPath) ? ini::parse(fileSystem.readFile(settingsPath)) : ini::Data{});
+
+        if (headless)
+        {
+            settings.graphicsDriver = graphics::Driver::empty;
+            settings.audioDriver = audio::Driver::empty;
+
+            // there is no screen to take the default size from
+            if (settings.size.v[0] == 0) settings.size.v[0] = 1280;
+            if (settings.size.v[1] == 0) settings.size.v[1] = 720;
+        }
 
         const Window::Flags windowFlags =
             (settings.resizable ? Window::Flags::resizable : Window::Flags::none) |
@@ -238,6 +299,14 @@ namespace ouzel::core
 
         inputManager = std::make_unique<input::InputManager>();
 
+        setFixedUpdateRate(settings.fixedUpdateRate);
+        maxFixedUpdates = settings.maxFixedUpdates;
+        setHeadlessFrameRate(settings.headlessFrameRate);
+
+        // tick the update thread at the headless frame rate instead of spinning
+        if (headless && settings.headlessFrameRate > 0.0F)
+            oneUpdatePerFrame = true;
+
         // default assets
         switch (settings.graphicsDriver)
         {
@@ -710,6 +779,9 @@ namespace ouzel::core
 
     void Engine::update()
     {
+        OUZEL_PROFILE_FRAME();
+        OUZEL_PROFILE_SCOPE("Engine::update");
+
         eventDispatcher.dispatchEvents();
 
         const auto currentTime = std::chrono::steady_clock::now();
@@ -717,14 +789,43 @@ namespace ouzel::core
 
         if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
         {
-            if (diff > std::chrono::seconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
+            if (diff > std::chrono::milliseconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
 
             previousUpdateTime = currentTime;
             const float delta = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1000000.0F;
 
+            if (fixedUpdateInterval.count() != 0)
+            {
+                const float fixedDelta = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(fixedUpdateInterval).count()) / 1000000.0F;
+
+                fixedUpdateTime += diff;
+
+                for (std::uint32_t i = 0; fixedUpdateTime >= fixedUpdateInterval; ++i)
+                {
+                    if (i >= maxFixedUpdates)
+                    {
+                        // over budget, skip the ticks that could not be caught up with
+                        fixedUpdateTime %= fixedUpdateInterval;
+                        break;
+                    }
+
+                    fixedUpdateTime -= fixedUpdateInterval;
+
+                    auto fixedUpdateEvent = std::make_unique<UpdateEvent>();
+                    fixedUpdateEvent->type = Event::Type::fixedUpdate;
+                    fixedUpdateEvent->delta = fixedDelta;
+                    eventDispatcher.dispatchEvent(std::move(fixedUpdateEvent));
+                }
+
+                fixedUpdateAlpha = static_cast<float>(fixedUpdateTime.count()) / static_cast<float>(fixedUpdateInterval.count());
+            }
+            else
+                fixedUpdateAlpha = 1.0F;
+
             auto updateEvent = std::make_unique<UpdateEvent>();
             updateEvent->type = Event::Type::update;
             updateEvent->delta = delta;
+            updateEvent->alpha = fixedUpdateAlpha;
             eventDispatcher.dispatchEvent(std::move(updateEvent));
         }
 
@@ -738,14 +839,42 @@ namespace ouzel::core
         if (oneUpdatePerFrame) graphics->waitForNextFrame();
     }
 
-    void Engine::executeOnMainThread(const std::function<void()>& func)
+    float Engine::getFixedUpdateRate() const noexcept
+    {
+        return (fixedUpdateInterval.count() != 0) ?
+            1.0F / std::chrono::duration<float>(fixedUpdateInterval).count() :
+            0.0F;
+    }
+
+    void Engine::setFixedUpdateRate(float rate)
+    {
+        if (rate < 0.0F)
+            throw std::runtime_error("Invalid fixed update rate");
+
+        fixedUpdateInterval = (rate > 0.0F) ?
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0F / rate)) :
+            std::chrono::steady_clock::duration{0};
+        fixedUpdateTime = std::chrono::steady_clock::duration{0};
+        fixedUpdateAlpha = 1.0F;
+    }
+
+    void Engine::setHeadlessFrameRate(float rate)
+    {
+        if (rate < 0.0F)
+            throw std::runtime_error("Invalid headless frame rate");
+
+        headlessFrameRate = rate;
+    }
+
+    void Engine::executeOnMainThread(thread::Task task)
     {
-        if (active) runOnMainThread(func);
+        if (active) runOnMainThread(std::move(task));
     }
 
     void Engine::engineMain()
     {
         thread::setCurrentThreadName("Application");
+        OUZEL_PROFILE_THREAD("Application");
 
         try
         {
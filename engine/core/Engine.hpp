@@ -6,6 +6,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <thread>
@@ -27,6 +28,8 @@
 #include "../network/Network.hpp"
 #include "../formats/Ini.hpp"
 #include "../utils/Log.hpp"
+#include "../thread/Task.hpp"
+#include "../thread/TaskQueue.hpp"
 #include "../thread/Thread.hpp"
 
 namespace ouzel::core
@@ -93,7 +96,7 @@ namespace ouzel::core
 
         void update();
 
-        void executeOnMainThread(const std::function<void()>& func);
+        void executeOnMainThread(thread::Task task);
 
         virtual void openUrl(const std::string& url);
 
@@ -103,6 +106,25 @@ namespace ouzel::core
         bool isOneUpdatePerFrame() const noexcept { return oneUpdatePerFrame; }
         void setOneUpdatePerFrame(bool value) { oneUpdatePerFrame = value; }
 
+        // fixed update rate in ticks per second, 0 disables fixed updates
+        bool isFixedUpdateEnabled() const noexcept { return fixedUpdateInterval.count() != 0; }
+        float getFixedUpdateRate() const noexcept;
+        void setFixedUpdateRate(float rate);
+
+        // maximum number of fixed updates to catch up on in one frame, the rest are skipped
+        auto getMaxFixedUpdates() const noexcept { return maxFixedUpdates; }
+        void setMaxFixedUpdates(std::uint32_t value) { maxFixedUpdates = value; }
+
+        // fraction of the fixed update interval elapsed since the last fixed update
+        auto getFixedUpdateAlpha() const noexcept { return fixedUpdateAlpha; }
+
+        // runs without a window and with the empty render and audio devices (only supported on Linux)
+        bool isHeadless() const noexcept { return headless; }
+
+        // frame rate of the headless mode, 0 for unthrottled
+        float getHeadlessFrameRate() const noexcept { return headlessFrameRate; }
+        void setHeadlessFrameRate(float rate);
+
     protected:
         class Command final
         {
@@ -120,7 +142,7 @@ namespace ouzel::core
         };
 
         virtual void engineMain();
-        virtual void runOnMainThread(const std::function<void()>& func) = 0;
+        virtual void runOnMainThread(thread::Task task) = 0;
 
         storage::FileSystem fileSystem;
         EventDispatcher eventDispatcher;
@@ -140,6 +162,10 @@ namespace ouzel::core
         std::condition_variable updateCondition;
 #endif
         std::chrono::steady_clock::time_point previousUpdateTime;
+        std::chrono::steady_clock::duration fixedUpdateInterval{0};
+        std::chrono::steady_clock::duration fixedUpdateTime{0};
+        std::uint32_t maxFixedUpdates = 5;
+        float fixedUpdateAlpha = 1.0F;
 
         std::atomic_bool active{false};
         std::atomic_bool paused{false};
@@ -147,6 +173,9 @@ namespace ouzel::core
 
         std::atomic_bool screenSaverEnabled{true};
 
+        bool headless = false;
+        std::atomic<float> headlessFrameRate{0.0F};
+
     private:
         std::vector<std::string> args;
     };
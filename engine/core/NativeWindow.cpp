@@ -13,6 +13,7 @@ namespace ouzel::core
                                const std::string& newTitle,
                                bool newHighDpi):
         size(newSize),
+        resolution(newSize),
         resizable(newResizable),
         fullscreen(newFullscreen),
         exclusiveFullscreen(newExclusiveFullscreen),
@@ -94,4 +94,14 @@
 #  define OUZEL_COMPILE_WASAPI 1
 #endif
 
+// Profiler
+#ifndef OUZEL_ENABLE_PROFILER
+#  define OUZEL_ENABLE_PROFILER 0
+#endif
+
+// Assert on heap allocations while mixing audio
+#ifndef OUZEL_CHECK_AUDIO_ALLOCATIONS
+#  define OUZEL_CHECK_AUDIO_ALLOCATIONS 0
+#endif
+
 #endif // OUZEL_SETUP_H
@@ -55,12 +55,20 @@ namespace ouzel::core
 #elif defined(__ANDROID__)
         nativeWindow(std::make_unique<android::NativeWindow>(std::bind(&Window::eventCallback, this, std::placeholders::_1), newTitle)),
 #elif defined(__linux__)
-        nativeWindow(std::make_unique<linux::NativeWindow>(std::bind(&Window::eventCallback, this, std::placeholders::_1),
-                                                           newSize,
-                                                           (flags & Flags::resizable) == Flags::resizable,
-                                                           (flags & Flags::fullscreen) == Flags::fullscreen,
-                                                           (flags & Flags::exclusiveFullscreen) == Flags::exclusiveFullscreen,
-                                                           newTitle)),
+        nativeWindow(initEngine.isHeadless() ?
+                     std::make_unique<NativeWindow>(std::bind(&Window::eventCallback, this, std::placeholders::_1),
+                                                    newSize,
+                                                    (flags & Flags::resizable) == Flags::resizable,
+                                                    (flags & Flags::fullscreen) == Flags::fullscreen,
+                                                    (flags & Flags::exclusiveFullscreen) == Flags::exclusiveFullscreen,
+                                                    newTitle,
+                                                    (flags & Flags::highDpi) == Flags::highDpi) :
+                     std::unique_ptr<NativeWindow>(std::make_unique<linux::NativeWindow>(std::bind(&Window::eventCallback, this, std::placeholders::_1),
+                                                                                         newSize,
+                                                                                         (flags & Flags::resizable) == Flags::resizable,
+                                                                                         (flags & Flags::fullscreen) == Flags::fullscreen,
+                                                                                         (flags & Flags::exclusiveFullscreen) == Flags::exclusiveFullscreen,
+                                                                                         newTitle))),
 #elif defined(_WIN32)
         nativeWindow(std::make_unique<windows::NativeWindow>(std::bind(&Window::eventCallback, this, std::placeholders::_1),
                                                              newSize,
@@ -267,11 +267,9 @@ namespace ouzel::core::android
         start();
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
-        std::unique_lock lock(executeMutex);
-        executeQueue.push(func);
-        lock.unlock();
+        executeQueue.push(std::move(task));
 
         const std::uint8_t command = 1;
         if (write(looperPipe[1], &command, sizeof(command)) == -1)
@@ -331,19 +329,7 @@ namespace ouzel::core::android
 
     void Engine::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-            if (executeQueue.empty()) break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 
     void Engine::engineMain()
@@ -43,7 +43,7 @@ namespace ouzel::core::android
 
     private:
         void engineMain() final;
-        void runOnMainThread(const std::function<void()>& func) final;
+        void runOnMainThread(thread::Task task) final;
 
         JavaVM* javaVm = nullptr;
         jclass uriClass = nullptr;
@@ -65,8 +65,7 @@ namespace ouzel::core::android
         std::string filesDirectory;
         std::string cacheDirectory;
 
-        std::queue<std::function<void()>> executeQueue;
-        std::mutex executeMutex;
+        thread::TaskQueue executeQueue;
     };
 }
 
@@ -100,9 +100,9 @@ namespace ouzel::core::emscripten
             emscripten_cancel_main_loop();
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
-        if (func) func();
+        if (task) task();
     }
 
     void Engine::openUrl(const std::string& url)
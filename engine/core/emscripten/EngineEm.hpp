@@ -19,7 +19,7 @@ namespace ouzel::core::emscripten
         void openUrl(const std::string& url) final;
 
     private:
-        void runOnMainThread(const std::function<void()>& func) final;
+        void runOnMainThread(thread::Task task) final;
     };
 }
 
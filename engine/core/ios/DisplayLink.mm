@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include "DisplayLink.hpp"
 #include "../cocoa/AutoreleasePool.hpp"
+#include "../../utils/Profiler.hpp"
 
 @interface DisplayLinkHandler: NSObject
 @end
@@ -78,6 +79,7 @@ namespace ouzel::core::ios
     void DisplayLink::renderMain()
     {
         thread::setCurrentThreadName("Render");
+        OUZEL_PROFILE_THREAD("Render");
 
         if (verticalSync)
         {
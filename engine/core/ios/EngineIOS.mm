@@ -150,11 +150,9 @@ namespace ouzel::core::ios
         UIApplicationMain(argc, argv, nil, NSStringFromClass([AppDelegate class]));
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
-        std::unique_lock lock(executeMutex);
-        executeQueue.push(func);
-        lock.unlock();
+        executeQueue.push(std::move(task));
 
         [executeHanlder performSelectorOnMainThread:@selector(executeAll) withObject:nil waitUntilDone:NO];
     }
@@ -180,19 +178,6 @@ namespace ouzel::core::ios
 
     void Engine::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-
-            if (executeQueue.empty()) break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 }
@@ -1,7 +1,11 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <stdexcept>
 #include <cstdlib>
+#include <thread>
 #include <unistd.h>
 #include "../Setup.h"
 #if OUZEL_SUPPORTS_X11
@@ -18,6 +22,7 @@
 #include "X11ErrorCategory.hpp"
 #include "../../events/Event.hpp"
 #include "../../graphics/RenderDevice.hpp"
+#include "../../graphics/empty/EmptyRenderDevice.hpp"
 #include "../../input/linux/InputSystemLinux.hpp"
 #include "../../utils/Log.hpp"
 
@@ -287,6 +292,12 @@ namespace ouzel::core::linux
     Engine::Engine(int argc, char* argv[]):
         core::Engine(parseArgs(argc, argv))
     {
+        headless = std::find_if(argv, argv + argc, [](const char* arg) {
+            return std::string(arg) == "--headless";
+        }) != argv + argc;
+
+        if (headless) return;
+
 #if OUZEL_SUPPORTS_X11
         XSetErrorHandler(errorHandler);
 
@@ -315,7 +326,7 @@ namespace ouzel::core::linux
         if (display != DISPMANX_NO_HANDLE)
             vc_dispmanx_display_close(display);
 
-        bcm_host_deinit();
+        if (!headless) bcm_host_deinit();
 #endif
     }
 
@@ -324,6 +335,12 @@ namespace ouzel::core::linux
         init();
         start();
 
+        if (headless)
+        {
+            runHeadless();
+            return;
+        }
+
         auto inputLinux = static_cast<input::linux::InputSystem*>(inputManager->getInputSystem());
 
 #if OUZEL_SUPPORTS_X11
@@ -508,9 +525,15 @@ namespace ouzel::core::linux
         exit();
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
 #if OUZEL_SUPPORTS_X11
+        if (!display)
+        {
+            executeQueue.push(std::move(task));
+            return;
+        }
+
         auto windowLinux = static_cast<NativeWindow*>(window->getNativeWindow());
 
         XEvent event;
@@ -524,20 +547,89 @@ namespace ouzel::core::linux
         event.xclient.data.l[3] = 0; // unused
         event.xclient.data.l[4] = 0; // unused
 
-        std::unique_lock lock(executeMutex);
-        executeQueue.push(func);
-        lock.unlock();
+        executeQueue.push(std::move(task));
 
         if (!XSendEvent(display, windowLinux->getNativeWindow(), False, NoEventMask, &event))
             throw std::system_error(getLastError(), errorCategory, "Failed to send X11 delete message");
 
         XFlush(display);
 #else
-        std::lock_guard lock(executeMutex);
-        executeQueue.push(func);
+        executeQueue.push(std::move(task));
 #endif
     }
 
+    void Engine::runHeadless()
+    {
+        auto inputLinux = static_cast<input::linux::InputSystem*>(inputManager->getInputSystem());
+        auto renderDevice = static_cast<graphics::empty::RenderDevice*>(graphics->getDevice());
+
+        std::uint32_t frameCount = 0;
+        std::chrono::steady_clock::duration statsTime{0};
+        std::chrono::steady_clock::duration maxFrameTime{0};
+        auto previousFrameTime = std::chrono::steady_clock::now();
+        auto nextFrameTime = previousFrameTime;
+
+        while (active)
+        {
+            executeAll();
+
+            if (const float frameRate = headlessFrameRate; frameRate > 0.0F)
+            {
+                const auto frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0F / frameRate));
+                nextFrameTime = std::max(nextFrameTime + frameInterval, std::chrono::steady_clock::now());
+                std::this_thread::sleep_until(nextFrameTime);
+            }
+
+            if (paused)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                previousFrameTime = nextFrameTime = std::chrono::steady_clock::now();
+            }
+            else if (renderDevice->waitForCommands(std::chrono::milliseconds(10))) // the update thread has finished a frame
+            {
+                renderDevice->process();
+
+                const auto currentTime = std::chrono::steady_clock::now();
+                const auto frameTime = currentTime - previousFrameTime;
+                previousFrameTime = currentTime;
+
+                ++frameCount;
+                statsTime += frameTime;
+                maxFrameTime = std::max(maxFrameTime, frameTime);
+            }
+
+            inputLinux->update();
+
+            if (statsTime >= std::chrono::seconds(1))
+            {
+                const auto seconds = std::chrono::duration<float>(statsTime).count();
+
+                logger.log(Log::Level::info) << "FPS: " << static_cast<float>(frameCount) / seconds <<
+                    ", average frame time: " << seconds * 1000.0F / static_cast<float>(frameCount) << " ms" <<
+                    ", maximum frame time: " << std::chrono::duration<float, std::milli>(maxFrameTime).count() << " ms";
+
+                frameCount = 0;
+                statsTime = std::chrono::steady_clock::duration{0};
+                maxFrameTime = std::chrono::steady_clock::duration{0};
+            }
+        }
+
+        // keep sending frames while the update thread finishes, it might be waiting for the next one
+        std::atomic_bool stopped{false};
+        thread::Thread frameThread([renderDevice, &stopped]() {
+            while (!stopped)
+            {
+                renderDevice->process();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+
+        exit();
+
+        stopped = true;
+        frameThread.join();
+    }
+
     void Engine::openUrl(const std::string& url)
     {
 #if OUZEL_SUPPORTS_X11
@@ -550,27 +642,15 @@ namespace ouzel::core::linux
         core::Engine::setScreenSaverEnabled(newScreenSaverEnabled);
 
 #if OUZEL_SUPPORTS_X11
-        executeOnMainThread([this, newScreenSaverEnabled]() {
-            XScreenSaverSuspend(display, !newScreenSaverEnabled);
-        });
+        if (display)
+            executeOnMainThread([this, newScreenSaverEnabled]() {
+                XScreenSaverSuspend(display, !newScreenSaverEnabled);
+            });
 #endif
     }
 
     void Engine::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-
-            if (executeQueue.empty()) break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 }
@@ -33,11 +33,11 @@ namespace ouzel::core::linux
         auto getDisplay() const noexcept { return display; }
 
     private:
-        void runOnMainThread(const std::function<void()>& func) final;
+        void runOnMainThread(thread::Task task) final;
+        void runHeadless();
         void executeAll();
 
-        std::queue<std::function<void()>> executeQueue;
-        std::mutex executeMutex;
+        thread::TaskQueue executeQueue;
 
 #if OUZEL_SUPPORTS_X11
         Display* display = nullptr;
@@ -30,12 +30,11 @@ namespace ouzel::core::macos
 
     private:
         void engineMain() final;
-        void runOnMainThread(const std::function<void()>& func) final;
+        void runOnMainThread(thread::Task task) final;
 
         NSApplicationPtr application = nil;
 
-        std::queue<std::function<void()>> executeQueue;
-        std::mutex executeMutex;
+        thread::TaskQueue executeQueue;
 
         std::uint32_t noSleepAssertionID = 0;
         id executeHanlder = nil;
@@ -128,11 +128,9 @@ namespace ouzel::core::macos
         [application run];
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
-        std::unique_lock lock(executeMutex);
-        executeQueue.push(func);
-        lock.unlock();
+        executeQueue.push(std::move(task));
 
         [executeHanlder performSelectorOnMainThread:@selector(executeAll) withObject:nil waitUntilDone:NO];
     }
@@ -188,19 +186,6 @@ namespace ouzel::core::macos
 
     void Engine::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-
-            if (executeQueue.empty()) break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 }
@@ -109,11 +109,9 @@ namespace ouzel::core::tvos
         UIApplicationMain(argc, argv, nil, NSStringFromClass([AppDelegate class]));
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
-        std::unique_lock lock(executeMutex);
-        executeQueue.push(func);
-        lock.unlock();
+        executeQueue.push(std::move(task));
 
         [executeHanlder performSelectorOnMainThread:@selector(executeAll) withObject:nil waitUntilDone:NO];
     }
@@ -139,19 +137,6 @@ namespace ouzel::core::tvos
 
     void Engine::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-
-            if (executeQueue.empty()) break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 }
@@ -137,13 +137,11 @@ namespace ouzel::core::windows
         exit();
     }
 
-    void Engine::runOnMainThread(const std::function<void()>& func)
+    void Engine::runOnMainThread(thread::Task task)
     {
         auto windowWin = static_cast<NativeWindow*>(window->getNativeWindow());
 
-        std::unique_lock lock(executeMutex);
-        executeQueue.push(func);
-        lock.unlock();
+        executeQueue.push(std::move(task));
 
         if (!PostMessage(windowWin->getNativeWindow(), WM_USER, 0, 0))
             throw std::system_error(GetLastError(), std::system_category(), "Failed to post message");
@@ -152,21 +150,7 @@ namespace ouzel::core::windows
 
     void Engine::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-
-            if (executeQueue.empty())
-                break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 
     void Engine::openUrl(const std::string& url)
@@ -32,10 +32,9 @@ namespace ouzel::core::windows
         void executeAll();
 
     private:
-        void runOnMainThread(const std::function<void()>& func) final;
+        void runOnMainThread(thread::Task task) final;
 
-        std::queue<std::function<void()>> executeQueue;
-        std::mutex executeMutex;
+        thread::TaskQueue executeQueue;
     };
 }
 
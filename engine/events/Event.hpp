@@ -84,7 +84,8 @@ namespace ouzel
             soundReset,
             soundFinish,
 
-            update,
+            update, // sent once per frame
+            fixedUpdate, // sent at the fixed update rate (if enabled)
 
             user // user defined event
         };
@@ -181,6 +182,7 @@ namespace ouzel
     struct UpdateEvent final: Event
     {
         float delta;
+        float alpha = 1.0F; // interpolation factor between the last two fixed updates
     };
 
     struct UserEvent final: Event
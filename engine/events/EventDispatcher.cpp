@@ -3,6 +3,7 @@
 #include <algorithm>
 #include "EventDispatcher.hpp"
 #include "EventHandler.hpp"
+#include "../utils/Profiler.hpp"
 #include "../utils/Utils.hpp"
 
 namespace ouzel
@@ -23,6 +24,8 @@ namespace ouzel
 
     void EventDispatcher::dispatchEvents()
     {
+        OUZEL_PROFILE_SCOPE("EventDispatcher::dispatchEvents");
+
         for (EventHandler* eventHandler : eventHandlerDeleteSet)
         {
             const auto i = std::find(eventHandlers.begin(),
@@ -161,6 +164,10 @@ namespace ouzel
                         if (eventHandler->updateHandler)
                             handled = eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get()));
                         break;
+                    case Event::Type::fixedUpdate:
+                        if (eventHandler->fixedUpdateHandler)
+                            handled = eventHandler->fixedUpdateHandler(*static_cast<UpdateEvent*>(event.get()));
+                        break;
                     case Event::Type::user:
                         if (eventHandler->userHandler)
                             handled = eventHandler->userHandler(*static_cast<UserEvent*>(event.get()));
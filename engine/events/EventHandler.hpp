@@ -47,6 +47,7 @@ namespace ouzel
         std::function<bool(const AnimationEvent&)> animationHandler;
         std::function<bool(const SoundEvent&)> soundHandler;
         std::function<bool(const UpdateEvent&)> updateHandler;
+        std::function<bool(const UpdateEvent&)> fixedUpdateHandler;
         std::function<bool(const UserEvent&)> userHandler;
 
     private:
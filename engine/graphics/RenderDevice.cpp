@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include "RenderDevice.hpp"
+#include "../utils/Profiler.hpp"
 
 namespace ouzel::graphics
 {
@@ -38,6 +39,8 @@ namespace ouzel::graphics
 
     void RenderDevice::process()
     {
+        OUZEL_PROFILE_SCOPE("RenderDevice::process");
+
         Event event;
         event.type = Event::Type::frame;
         callback(event);
@@ -71,26 +74,13 @@ namespace ouzel::graphics
     {
     }
 
-    void RenderDevice::executeOnRenderThread(const std::function<void()>& func)
+    void RenderDevice::executeOnRenderThread(thread::Task task)
     {
-        std::lock_guard lock(executeMutex);
-        executeQueue.push(func);
+        executeQueue.push(std::move(task));
     }
 
     void RenderDevice::executeAll()
     {
-        std::function<void()> func;
-
-        for (;;)
-        {
-            std::unique_lock lock(executeMutex);
-            if (executeQueue.empty()) break;
-
-            func = std::move(executeQueue.front());
-            executeQueue.pop();
-            lock.unlock();
-
-            if (func) func();
-        }
+        executeQueue.executeAll();
     }
 }
@@ -17,6 +17,8 @@
 #include "Vertex.hpp"
 #include "../math/Matrix.hpp"
 #include "../math/Size.hpp"
+#include "../thread/Task.hpp"
+#include "../thread/TaskQueue.hpp"
 
 namespace ouzel::core
 {
@@ -112,7 +114,7 @@ namespace ouzel::graphics
         float getFPS() const noexcept { return currentFPS; }
         float getAccumulatedFPS() const noexcept { return accumulatedFPS; }
 
-        void executeOnRenderThread(const std::function<void()>& func);
+        void executeOnRenderThread(thread::Task task);
 
         using ResourceId = std::size_t;
         class Resource final
@@ -202,8 +204,7 @@ namespace ouzel::graphics
         float currentAccumulatedFPS = 0.0F;
         std::atomic<float> accumulatedFPS{0.0F};
 
-        std::queue<std::function<void()>> executeQueue;
-        std::mutex executeMutex;
+        thread::TaskQueue executeQueue;
 
     private:
         ResourceId createResourceId()
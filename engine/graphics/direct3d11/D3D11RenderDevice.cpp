@@ -17,6 +17,7 @@
 #include "../../core/Window.hpp"
 #include "../../core/windows/NativeWindowWin.hpp"
 #include "../../utils/Log.hpp"
+#include "../../utils/Profiler.hpp"
 #include "stb_image_write.h"
 
 namespace ouzel::graphics::d3d11
@@ -1106,6 +1107,7 @@ namespace ouzel::graphics::d3d11
     void RenderDevice::renderMain()
     {
         thread::setCurrentThreadName("Render");
+        OUZEL_PROFILE_THREAD("Render");
 
         while (running)
         {
@@ -3,6 +3,7 @@
 #ifndef OUZEL_GRAPHICS_EMPTYRENDERDEVICE_HPP
 #define OUZEL_GRAPHICS_EMPTYRENDERDEVICE_HPP
 
+#include <chrono>
 #include "../RenderDevice.hpp"
 
 namespace ouzel::graphics::empty
@@ -17,8 +18,22 @@ namespace ouzel::graphics::empty
         {
         }
 
-    private:
-        void process() final {}
+        // blocks until a command buffer is submitted or the timeout expires
+        bool waitForCommands(std::chrono::steady_clock::duration timeout)
+        {
+            std::unique_lock lock(commandQueueMutex);
+            return commandQueueCondition.wait_for(lock, timeout, [this]() { return !commandQueue.empty(); });
+        }
+
+        // sends the frame event and discards the submitted commands without blocking
+        void process() final
+        {
+            graphics::RenderDevice::process();
+            executeAll();
+
+            std::unique_lock lock(commandQueueMutex);
+            while (!commandQueue.empty()) commandQueue.pop();
+        }
     };
 }
 
@@ -10,6 +10,7 @@
 #include "../../../core/Window.hpp"
 #include "../../../core/android/NativeWindowAndroid.hpp"
 #include "../../../utils/Log.hpp"
+#include "../../../utils/Profiler.hpp"
 
 namespace ouzel::graphics::opengl::android
 {
@@ -273,6 +274,7 @@ namespace ouzel::graphics::opengl::android
     void RenderDevice::renderMain()
     {
         thread::setCurrentThreadName("Render");
+        OUZEL_PROFILE_THREAD("Render");
 
         if (!eglMakeCurrent(display, surface, surface, context))
             throw std::system_error(eglGetError(), eglErrorCategory, "Failed to set current EGL context");
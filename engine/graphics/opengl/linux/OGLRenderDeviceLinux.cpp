@@ -13,6 +13,7 @@
 #include "../../../core/linux/EngineLinux.hpp"
 #include "../../../core/linux/NativeWindowLinux.hpp"
 #include "../../../utils/Log.hpp"
+#include "../../../utils/Profiler.hpp"
 #include "../../../utils/Utils.hpp"
 
 namespace ouzel::graphics::opengl::linux
@@ -189,6 +190,7 @@ namespace ouzel::graphics::opengl::linux
     void RenderDevice::renderMain()
     {
         thread::setCurrentThreadName("Render");
+        OUZEL_PROFILE_THREAD("Render");
 
         if (!eglMakeCurrent(display, surface, surface, context))
             throw std::system_error(eglGetError(), eglErrorCategory, "Failed to set current EGL context");
@@ -13,6 +13,7 @@
 #include "../../../core/Window.hpp"
 #include "../../../core/windows/NativeWindowWin.hpp"
 #include "../../../utils/Log.hpp"
+#include "../../../utils/Profiler.hpp"
 
 namespace ouzel::graphics::opengl::windows
 {
@@ -343,6 +344,7 @@ namespace ouzel::graphics::opengl::windows
     void RenderDevice::renderMain()
     {
         thread::setCurrentThreadName("Render");
+        OUZEL_PROFILE_THREAD("Render");
 
         if (!wglMakeCurrent(deviceContext, renderContext))
             throw std::system_error(GetLastError(), std::system_category(), "Failed to set OpenGL rendering context");
@@ -29,8 +29,8 @@ namespace ouzel::gui
             return static_cast<std::uint8_t>(c) <= 0x1F;
         }
 
-        void skipWhitespaces(const std::vector<std::byte>& str,
-                             std::vector<std::byte>::const_iterator& iterator)
+        void skipWhitespaces(const storage::FileData& str,
+                             const std::byte*& iterator)
         {
             while (iterator != str.end())
                 if (isWhitespace(*iterator))
@@ -39,8 +39,8 @@ namespace ouzel::gui
                     break;
         }
 
-        void skipLine(const std::vector<std::byte>& str,
-                      std::vector<std::byte>::const_iterator& iterator)
+        void skipLine(const storage::FileData& str,
+                      const std::byte*& iterator)
         {
             while (iterator != str.end())
             {
@@ -54,8 +54,8 @@ namespace ouzel::gui
             }
         }
 
-        std::string parseString(const std::vector<std::byte>& str,
-                                std::vector<std::byte>::const_iterator& iterator)
+        std::string parseString(const storage::FileData& str,
+                                const std::byte*& iterator)
         {
             if (iterator == str.end())
                 throw std::runtime_error("Invalid string");
@@ -103,8 +103,8 @@ namespace ouzel::gui
             return result;
         }
 
-        std::string parseInt(const std::vector<std::byte>& str,
-                             std::vector<std::byte>::const_iterator& iterator)
+        std::string parseInt(const storage::FileData& str,
+                             const std::byte*& iterator)
         {
             std::string result;
             std::uint32_t length = 1;
@@ -132,8 +132,8 @@ namespace ouzel::gui
             return result;
         }
 
-        void expectToken(const std::vector<std::byte>& str,
-                         std::vector<std::byte>::const_iterator& iterator,
+        void expectToken(const storage::FileData& str,
+                         const std::byte*& iterator,
                          char token)
         {
             if (iterator == str.end() ||
@@ -144,7 +144,7 @@ namespace ouzel::gui
         }
     }
 
-    BMFont::BMFont(const std::vector<std::byte>& data)
+    BMFont::BMFont(const storage::FileData& data)
     {
         auto iterator = data.cbegin();
 
@@ -4,6 +4,7 @@
 #define OUZEL_GUI_BMFONT_HPP
 
 #include "Font.hpp"
+#include "../storage/FileData.hpp"
 
 namespace ouzel::gui
 {
@@ -11,7 +12,7 @@ namespace ouzel::gui
     {
     public:
         BMFont() = default;
-        explicit BMFont(const std::vector<std::byte>& data);
+        explicit BMFont(const storage::FileData& data);
 
         RenderData getRenderData(const std::string& text,
                                  Color color,
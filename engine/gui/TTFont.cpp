@@ -26,7 +26,7 @@
 
 namespace ouzel::gui
 {
-    TTFont::TTFont(const std::vector<std::byte>& initData, bool initMipmaps):
+    TTFont::TTFont(const storage::FileData& initData, bool initMipmaps):
         data(initData),
         mipmaps(initMipmaps)
     {
@@ -4,6 +4,7 @@
 #define OUZEL_GUI_TTFONT_HPP
 
 #include "../gui/Font.hpp"
+#include "../storage/FileData.hpp"
 
 struct stbtt_fontinfo;
 
@@ -13,7 +14,7 @@ namespace ouzel::gui
     {
     public:
         TTFont() = default;
-        TTFont(const std::vector<std::byte>& newData, bool newMipmaps = true);
+        TTFont(const storage::FileData& newData, bool newMipmaps = true);
 
         RenderData getRenderData(const std::string& text,
                                  Color color,
@@ -24,7 +25,7 @@ namespace ouzel::gui
 
     private:
         std::unique_ptr<stbtt_fontinfo> font;
-        std::vector<std::byte> data;
+        storage::FileData data;
         bool mipmaps = true;
     };
 }
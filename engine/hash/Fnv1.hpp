@@ -4,6 +4,7 @@
 #define OUZEL_HASH_FNV1_HPP
 
 #include <cstdint>
+#include <string_view>
 
 namespace ouzel::hash::fnv1
 {
@@ -24,6 +25,16 @@ namespace ouzel::hash::fnv1
     {
         return (i < sizeof(Value)) ? hash<Result>(value, i + 1, (result * prime<Result>()) ^ ((value >> (i * 8)) & 0xFF)) : result;
     }
+
+    // hashes the bytes of the string, string literals can be hashed at compile time
+    template <typename Result>
+    constexpr Result hashString(const std::string_view str) noexcept
+    {
+        Result result = offsetBasis<Result>();
+        for (const char c : str)
+            result = (result * prime<Result>()) ^ static_cast<std::uint8_t>(c);
+        return result;
+    }
 }
 
 #endif // OUZEL_HASH_FNV1_HPP
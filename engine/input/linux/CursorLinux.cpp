@@ -16,6 +16,7 @@ namespace ouzel::input::linux
 #if OUZEL_SUPPORTS_X11
         auto engineLinux = static_cast<core::linux::Engine*>(engine);
         auto display = engineLinux->getDisplay();
+        if (!display) return;
 
         switch (systemCursor)
         {
@@ -50,7 +51,7 @@ namespace ouzel::input::linux
         auto engineLinux = static_cast<core::linux::Engine*>(engine);
         auto display = engineLinux->getDisplay();
 
-        if (!data.empty())
+        if (display && !data.empty())
         {
             auto width = static_cast<int>(size.v[0]);
             auto height = static_cast<int>(size.v[1]);
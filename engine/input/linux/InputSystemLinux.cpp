@@ -31,18 +31,20 @@ namespace ouzel::input::linux
     {
 #if OUZEL_SUPPORTS_X11
         auto engineLinux = static_cast<core::linux::Engine*>(engine);
-        auto display = engineLinux->getDisplay();
-
-        char data[1] = {0};
 
-        Pixmap pixmap = XCreateBitmapFromData(display, DefaultRootWindow(display), data, 1, 1);
-        if (pixmap)
+        if (auto display = engineLinux->getDisplay())
         {
-            XColor color;
-            color.red = color.green = color.blue = 0;
+            char data[1] = {0};
+
+            Pixmap pixmap = XCreateBitmapFromData(display, DefaultRootWindow(display), data, 1, 1);
+            if (pixmap)
+            {
+                XColor color;
+                color.red = color.green = color.blue = 0;
 
-            emptyCursor = XCreatePixmapCursor(display, pixmap, pixmap, &color, &color, 0, 0);
-            XFreePixmap(display, pixmap);
+                emptyCursor = XCreatePixmapCursor(display, pixmap, pixmap, &color, &color, 0, 0);
+                XFreePixmap(display, pixmap);
+            }
         }
 #endif
 
@@ -246,8 +248,10 @@ namespace ouzel::input::linux
     void InputSystem::updateCursor() const
     {
         auto engineLinux = static_cast<core::linux::Engine*>(engine);
-        auto windowLinux = static_cast<core::linux::NativeWindow*>(engine->getWindow()->getNativeWindow());
         auto display = engineLinux->getDisplay();
+        if (!display) return;
+
+        auto windowLinux = static_cast<core::linux::NativeWindow*>(engine->getWindow()->getNativeWindow());
         auto window = windowLinux->getNativeWindow();
 
         if (mouseDevice->isCursorVisible())
@@ -19,8 +19,10 @@ namespace ouzel::input::linux
     {
 #if OUZEL_SUPPORTS_X11
         auto engineLinux = static_cast<core::linux::Engine*>(engine);
-        auto windowLinux = static_cast<core::linux::NativeWindow*>(engine->getWindow()->getNativeWindow());
         auto display = engineLinux->getDisplay();
+        if (!display) return;
+
+        auto windowLinux = static_cast<core::linux::NativeWindow*>(engine->getWindow()->getNativeWindow());
         auto window = windowLinux->getNativeWindow();
 
         XWindowAttributes attributes;
@@ -44,8 +46,10 @@ namespace ouzel::input::linux
     {
 #if OUZEL_SUPPORTS_X11
         auto engineLinux = static_cast<core::linux::Engine*>(engine);
-        auto windowLinux = static_cast<core::linux::NativeWindow*>(engine->getWindow()->getNativeWindow());
         auto display = engineLinux->getDisplay();
+        if (!display) return;
+
+        auto windowLinux = static_cast<core::linux::NativeWindow*>(engine->getWindow()->getNativeWindow());
         auto window = windowLinux->getNativeWindow();
 
         if (locked)
@@ -15,7 +15,6 @@ LOCAL_PCH := ../Prefix.pch
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/.. \
     $(LOCAL_PATH)/../../shaders \
     $(LOCAL_PATH)/../../external/khronos \
-    $(LOCAL_PATH)/../../external/smbPitchShift \
     $(LOCAL_PATH)/../../external/stb
 
 LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
@@ -25,6 +24,7 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../assets/CueLoader.cpp \
     ../assets/GltfLoader.cpp \
     ../assets/ImageLoader.cpp \
+    ../assets/LoaderPool.cpp \
     ../assets/MtlLoader.cpp \
     ../assets/ObjLoader.cpp \
     ../assets/ParticleSystemLoader.cpp \
@@ -32,8 +32,18 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../assets/TtfLoader.cpp \
     ../assets/VorbisLoader.cpp \
     ../assets/WaveLoader.cpp \
+    ../audio/empty/EmptyAudioDevice.cpp \
+    ../audio/mixer/AllocationGuard.cpp \
+    ../audio/mixer/Biquad.cpp \
     ../audio/mixer/Bus.cpp \
+    ../audio/mixer/BusScheduler.cpp \
+    ../audio/mixer/Convolver.cpp \
+    ../audio/mixer/Fft.cpp \
+    ../audio/mixer/Kernels.cpp \
     ../audio/mixer/Mixer.cpp \
+    ../audio/mixer/PhaseVocoder.cpp \
+    ../audio/mixer/Resampler.cpp \
+    ../audio/mixer/Spatializer.cpp \
     ../audio/opensl/OSLAudioDevice.cpp \
     ../audio/Audio.cpp \
     ../audio/AudioDevice.cpp \
@@ -45,9 +55,11 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../audio/Mix.cpp \
     ../audio/Node.cpp \
     ../audio/Oscillator.cpp \
+    ../audio/PcmCache.cpp \
     ../audio/PcmClip.cpp \
     ../audio/SilenceSound.cpp \
     ../audio/Sound.cpp \
+    ../audio/Streamer.cpp \
     ../audio/Submix.cpp \
     ../audio/Voice.cpp \
     ../audio/VorbisClip.cpp \
@@ -116,6 +128,7 @@ LOCAL_SRC_FILES := ../assets/BmfLoader.cpp \
     ../scene/TextRenderer.cpp \
     ../storage/FileSystem.cpp \
     ../utils/Log.cpp \
+    ../utils/Profiler.cpp \
     ../utils/Utils.cpp
 
 include $(BUILD_STATIC_LIBRARY)
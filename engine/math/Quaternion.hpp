@@ -192,7 +192,7 @@ namespace ouzel
 
         void normalize() noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (squared == T(1)) // already normalized
                 return;
 
@@ -311,7 +311,7 @@ namespace ouzel
 
         Vector<3, T> rotateVector(const Vector<3, T>& vector) const noexcept
         {
-            constexpr Vector<3, T> q(v[0], v[1], v[2]);
+            const Vector<3, T> q(v[0], v[1], v[2]);
             const Vector<3, T> t = T(2) * q.cross(vector);
             return vector + (v[3] * t) + q.cross(t);
         }
@@ -336,6 +336,15 @@ namespace ouzel
             *this = (q1 * (T(1) - t)) + (q2 * t);
             return *this;
         }
+
+        // normalized linear interpolation along the shorter arc
+        Quaternion& nlerp(const Quaternion& q1, const Quaternion& q2, T t) noexcept
+        {
+            const auto dot = q1.v[0] * q2.v[0] + q1.v[1] * q2.v[1] + q1.v[2] * q2.v[2] + q1.v[3] * q2.v[3];
+            lerp(q1, (dot < T(0)) ? -q2 : q2, t);
+            normalize();
+            return *this;
+        }
     };
 
     using QuaternionF = Quaternion<float>;
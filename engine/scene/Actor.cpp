@@ -7,10 +7,39 @@
 #include "Layer.hpp"
 #include "Camera.hpp"
 #include "Component.hpp"
+#include "../core/Engine.hpp"
 #include "../math/MathUtils.hpp"
 
 namespace ouzel::scene
 {
+    namespace
+    {
+        Matrix4F composeTransform(const Vector3F& position,
+                                  const QuaternionF& rotation,
+                                  const Vector3F& scale,
+                                  bool flipX, bool flipY)
+        {
+            Matrix4F result;
+            result.setTranslation(position);
+
+            Matrix4F rotationMatrix;
+            rotationMatrix.setRotation(rotation);
+
+            result *= rotationMatrix;
+
+            const auto finalScale = Vector3F{scale.v[0] * (flipX ? -1.0F : 1.0F),
+                                             scale.v[1] * (flipY ? -1.0F : 1.0F),
+                                             scale.v[2]};
+
+            Matrix4F scaleMatrix;
+            scaleMatrix.setScale(finalScale);
+
+            result *= scaleMatrix;
+
+            return result;
+        }
+    }
+
     ActorContainer::~ActorContainer()
     {
         for (const auto actor : children)
@@ -237,6 +266,15 @@ namespace ouzel::scene
         return actors;
     }
 
+    Actor::Actor()
+    {
+        fixedUpdateHandler.fixedUpdateHandler = [this](const UpdateEvent&) {
+            // store the state before the fixed update changes it
+            resetInterpolation();
+            return false;
+        };
+    }
+
     Actor::~Actor()
     {
         if (parent) parent->removeChild(this);
@@ -284,9 +322,19 @@ namespace ouzel::scene
         if (transformDirty)
             calculateTransform();
 
+        // the children of interpolated actors must follow the interpolated transform of the parent
+        bool interpolate = false;
+        if (engine->isFixedUpdateEnabled())
+            for (const Actor* actor = this; actor && !interpolate; actor = actor->getParentActor())
+                interpolate = actor->interpolated;
+
+        const auto drawTransform = interpolate ?
+            getInterpolatedTransform(engine->getFixedUpdateAlpha()) :
+            transform;
+
         for (const auto component : components)
             if (!component->isHidden())
-                component->draw(transform,
+                component->draw(drawTransform,
                                 opacity,
                                 camera->getRenderViewProjection(),
                                 wireframe);
@@ -296,6 +344,7 @@ namespace ouzel::scene
     {
         ActorContainer::addChild(actor);
 
+        actor->parentActor = this;
         actor->updateTransform(getTransform());
     }
 
@@ -463,31 +512,89 @@ namespace ouzel::scene
 
     void Actor::calculateLocalTransform() const
     {
-        localTransform.setTranslation(position);
+        localTransform = composeTransform(position, rotation, scale, flipX, flipY);
+        localTransformDirty = false;
+    }
+
+    void Actor::calculateTransform() const
+    {
+        transform = parentTransform * getLocalTransform();
+        transformDirty = false;
+
+        updateChildrenTransform = true;
+    }
+
+    const Actor* Actor::getParentActor() const noexcept
+    {
+        return (parentActor && parentActor == parent) ? parentActor : nullptr;
+    }
 
-        Matrix4F rotationMatrix;
-        rotationMatrix.setRotation(rotation);
+    Matrix4F Actor::getInterpolatedTransform(float alpha) const
+    {
+        Matrix4F interpolatedLocalTransform;
 
-        localTransform *= rotationMatrix;
+        if (interpolated)
+        {
+            const auto interpolatedPosition = previousPosition * (1.0F - alpha) + position * alpha;
+            QuaternionF interpolatedRotation;
+            interpolatedRotation.nlerp(previousRotation, rotation, alpha);
+            const auto interpolatedScale = previousScale * (1.0F - alpha) + scale * alpha;
+
+            interpolatedLocalTransform = composeTransform(interpolatedPosition,
+                                                          interpolatedRotation,
+                                                          interpolatedScale,
+                                                          flipX, flipY);
+        }
+        else
+            interpolatedLocalTransform = getLocalTransform();
 
-        const auto finalScale = Vector3F{scale.v[0] * (flipX ? -1.0F : 1.0F),
-                                         scale.v[1] * (flipY ? -1.0F : 1.0F),
-                                         scale.v[2]};
+        if (const auto parentOfActor = getParentActor())
+            return parentOfActor->getInterpolatedTransform(alpha) * interpolatedLocalTransform;
+        else
+            return parentTransform * interpolatedLocalTransform;
+    }
 
-        Matrix4F scaleMatrix;
-        scaleMatrix.setScale(finalScale);
+    void Actor::setInterpolated(bool newInterpolated)
+    {
+        if (interpolated != newInterpolated)
+        {
+            interpolated = newInterpolated;
 
-        localTransform *= scaleMatrix;
+            if (entered)
+            {
+                if (interpolated)
+                    engine->getEventDispatcher().addEventHandler(fixedUpdateHandler);
+                else
+                    fixedUpdateHandler.remove();
+            }
 
-        localTransformDirty = false;
+            resetInterpolation();
+        }
     }
 
-    void Actor::calculateTransform() const
+    void Actor::resetInterpolation()
     {
-        transform = parentTransform * getLocalTransform();
-        transformDirty = false;
+        previousPosition = position;
+        previousRotation = rotation;
+        previousScale = scale;
+    }
 
-        updateChildrenTransform = true;
+    void Actor::enter()
+    {
+        ActorContainer::enter();
+
+        if (interpolated)
+        {
+            engine->getEventDispatcher().addEventHandler(fixedUpdateHandler);
+            resetInterpolation();
+        }
+    }
+
+    void Actor::leave()
+    {
+        ActorContainer::leave();
+
+        fixedUpdateHandler.remove();
     }
 
     void Actor::calculateInverseTransform() const
@@ -67,7 +67,7 @@ namespace ouzel::scene
     public:
         using Order = std::int32_t;
 
-        Actor() = default;
+        Actor();
         ~Actor() override;
 
         virtual void visit(std::vector<Actor*>& drawQueue,
@@ -109,6 +109,11 @@ namespace ouzel::scene
         virtual bool isCullDisabled() const noexcept { return cullDisabled; }
         virtual void setCullDisabled(bool newCullDisabled) { cullDisabled = newCullDisabled; }
 
+        // interpolate the drawn transform between the last two fixed updates
+        auto isInterpolated() const noexcept { return interpolated; }
+        void setInterpolated(bool newInterpolated);
+        void resetInterpolation();
+
         virtual bool isHidden() const noexcept { return hidden; }
         virtual void setHidden(bool newHidden);
         auto isWorldHidden() const noexcept { return worldHidden; }
@@ -157,9 +162,17 @@ namespace ouzel::scene
 
         Box3F getBoundingBox() const;
 
+        // composed with the interpolated transforms of the parent actors
+        Matrix4F getInterpolatedTransform(float alpha) const;
+
     protected:
         void setLayer(Layer* newLayer) override;
 
+        void enter() override;
+        void leave() override;
+
+        const Actor* getParentActor() const noexcept;
+
         void updateLocalTransform();
         void updateTransform(const Matrix4F& newParentTransform);
 
@@ -185,6 +198,7 @@ namespace ouzel::scene
         bool cullDisabled = false;
         bool hidden = false;
         bool worldHidden = false;
+        bool interpolated = false;
 
         Vector3F position;
         QuaternionF rotation = QuaternionF::identity();
@@ -193,12 +207,18 @@ namespace ouzel::scene
         Order order = 0;
         Order worldOrder = 0;
 
+        Vector3F previousPosition;
+        QuaternionF previousRotation = QuaternionF::identity();
+        Vector3F previousScale = Vector3F{1.0F, 1.0F, 1.0F};
+
         ActorContainer* parent = nullptr;
+        Actor* parentActor = nullptr; // the parent if it is an actor, only valid while it is equal to parent
 
         std::vector<Component*> components;
         std::vector<std::unique_ptr<Component>> ownedComponents;
 
         EventHandler animationUpdateHandler;
+        EventHandler fixedUpdateHandler{EventHandler::priorityMax};
     };
 }
 
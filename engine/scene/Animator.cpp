@@ -11,7 +11,13 @@ namespace ouzel::scene
     Animator::Animator(float initLength):
         length(initLength)
     {
+        // step on fixed updates if they are enabled, otherwise once per frame
         updateHandler.updateHandler = [this](const UpdateEvent& event) {
+            if (!engine->isFixedUpdateEnabled()) update(event.delta);
+            return false;
+        };
+
+        updateHandler.fixedUpdateHandler = [this](const UpdateEvent& event) {
             update(event.delta);
             return false;
         };
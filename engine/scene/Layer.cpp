@@ -10,6 +10,7 @@
 #include "../core/Engine.hpp"
 #include "../graphics/Graphics.hpp"
 #include "../math/Matrix.hpp"
+#include "../utils/Profiler.hpp"
 
 namespace ouzel::scene
 {
@@ -25,6 +26,8 @@ namespace ouzel::scene
 
     void Layer::draw()
     {
+        OUZEL_PROFILE_SCOPE("Layer::draw");
+
         for (const auto camera : cameras)
         {
             std::vector<Actor*> drawQueue;
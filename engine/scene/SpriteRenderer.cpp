@@ -21,8 +21,8 @@ namespace ouzel::scene
                              const Vector2F& pivot):
         name(frameName)
     {
-        const std::vector<std::uint16_t> indices = {0, 1, 2, 1, 3, 2};
-        indexCount = static_cast<std::uint32_t>(indices.size());
+        indexData = {0, 1, 2, 1, 3, 2};
+        indexCount = static_cast<std::uint32_t>(indexData.size());
 
         Vector2F textCoords[4];
         const Vector2F finalOffset(-sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
@@ -55,7 +55,7 @@ namespace ouzel::scene
             textCoords[3] = Vector2F(rightBottom.v[0], rightBottom.v[1]);
         }
 
-        const std::vector<graphics::Vertex> vertices{
+        vertexData = {
             graphics::Vertex(Vector3F{finalOffset.v[0], finalOffset.v[1], 0.0F}, Color::white(),
                              textCoords[0], Vector3F{0.0F, 0.0F, -1.0F}),
             graphics::Vertex(Vector3F{finalOffset.v[0] + frameRectangle.size.v[0], finalOffset.v[1], 0.0F}, Color::white(),
@@ -68,41 +68,19 @@ namespace ouzel::scene
 
         boundingBox.min = finalOffset;
         boundingBox.max = finalOffset + Vector2F(frameRectangle.size.v[0], frameRectangle.size.v[1]);
-
-        indexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                         graphics::BufferType::index,
-                                                         graphics::Flags::none,
-                                                         indices.data(),
-                                                         static_cast<std::uint32_t>(getVectorSize(indices)));
-
-        vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                          graphics::BufferType::vertex,
-                                                          graphics::Flags::none,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
                              const std::vector<std::uint16_t>& indices,
                              const std::vector<graphics::Vertex>& vertices):
-        name(frameName)
+        name(frameName),
+        indexData(indices),
+        vertexData(vertices)
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
         for (const graphics::Vertex& vertex : vertices)
             boundingBox.insertPoint(Vector2F(vertex.position));
-
-        indexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                         graphics::BufferType::index,
-                                                         graphics::Flags::none,
-                                                         indices.data(),
-                                                         static_cast<std::uint32_t>(getVectorSize(indices)));
-
-        vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getGraphics(),
-                                                          graphics::BufferType::vertex,
-                                                          graphics::Flags::none,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
@@ -112,7 +90,9 @@ namespace ouzel::scene
                              const Size2F& sourceSize,
                              const Vector2F& sourceOffset,
                              const Vector2F& pivot):
-        name(frameName)
+        name(frameName),
+        indexData(indices),
+        vertexData(vertices)
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -122,18 +102,66 @@ namespace ouzel::scene
         // TODO: fix
         const Vector2F finalOffset(-sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
                                    -sourceSize.v[1] * pivot.v[1] + (sourceSize.v[1] - frameRectangle.size.v[1] - sourceOffset.v[1]));
+    }
+
+    void SpriteData::createBuffers(std::map<std::string, Animation>& animations)
+    {
+        constexpr std::size_t maxVertexCount = 65536; // addressable by 16-bit indices
+
+        std::vector<Frame*> frames;
+        std::vector<std::uint16_t> indices;
+        std::vector<graphics::Vertex> vertices;
+
+        const auto flush = [&frames, &indices, &vertices]() {
+            if (!frames.empty())
+            {
+                auto indexBuffer = std::make_shared<graphics::Buffer>(*engine->getGraphics(),
+                                                                      graphics::BufferType::index,
+                                                                      graphics::Flags::none,
+                                                                      indices.data(),
+                                                                      static_cast<std::uint32_t>(getVectorSize(indices)));
+
+                auto vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getGraphics(),
+                                                                       graphics::BufferType::vertex,
+                                                                       graphics::Flags::none,
+                                                                       vertices.data(),
+                                                                       static_cast<std::uint32_t>(getVectorSize(vertices)));
+
+                for (Frame* frame : frames)
+                {
+                    frame->indexBuffer = indexBuffer;
+                    frame->vertexBuffer = vertexBuffer;
+                }
+
+                frames.clear();
+                indices.clear();
+                vertices.clear();
+            }
+        };
+
+        for (auto& animation : animations)
+            for (Frame& frame : animation.second.frames)
+            {
+                if (frame.indexBuffer || frame.vertexData.empty()) continue;
+
+                if (vertices.size() + frame.vertexData.size() > maxVertexCount)
+                    flush();
+
+                // the indices are offset by the position of the vertices of the frame in the shared vertex buffer
+                const auto baseVertex = static_cast<std::uint16_t>(vertices.size());
+                frame.startIndex = static_cast<std::uint32_t>(indices.size());
+
+                for (const std::uint16_t index : frame.indexData)
+                    indices.push_back(static_cast<std::uint16_t>(baseVertex + index));
+
+                vertices.insert(vertices.end(), frame.vertexData.begin(), frame.vertexData.end());
+                frames.push_back(&frame);
+
+                frame.indexData = std::vector<std::uint16_t>();
+                frame.vertexData = std::vector<graphics::Vertex>();
+            }
 
-        indexBuffer = std::make_shared<graphics::Buffer>(*engine->getGraphics(),
-                                                         graphics::BufferType::index,
-                                                         graphics::Flags::none,
-                                                         indices.data(),
-                                                         static_cast<std::uint32_t>(getVectorSize(indices)));
-
-        vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getGraphics(),
-                                                          graphics::BufferType::vertex,
-                                                          graphics::Flags::none,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
+        flush();
     }
 
     SpriteRenderer::SpriteRenderer()
@@ -175,6 +203,7 @@ namespace ouzel::scene
         material->textures[0] = spriteData.texture;
 
         animations = spriteData.animations;
+        SpriteData::createBuffers(animations);
 
         animationQueue.clear();
         animationQueue.push_back({&animations[""], false});
@@ -209,6 +238,7 @@ namespace ouzel::scene
             animation.frames.emplace_back("", size, rectangle, false, size, Vector2F(), Vector2F{0.5F, 0.5F});
 
             animations[""] = std::move(animation);
+            SpriteData::createBuffers(animations);
         }
 
         animationQueue.clear();
@@ -251,6 +281,7 @@ namespace ouzel::scene
         }
 
         animations[""] = std::move(animation);
+        SpriteData::createBuffers(animations);
 
         animationQueue.clear();
         animationQueue.push_back({&animations[""], false});
@@ -371,12 +402,14 @@ namespace ouzel::scene
 
             const auto& frame = currentAnimation->animation->frames[currentFrame];
 
-            engine->getGraphics()->draw(frame.getIndexBuffer()->getResource(),
-                                        frame.getIndexCount(),
-                                        sizeof(std::uint16_t),
-                                        frame.getVertexBuffer()->getResource(),
-                                        graphics::DrawMode::triangleList,
-                                        0);
+            // frames without geometry have no buffers
+            if (frame.getIndexBuffer())
+                engine->getGraphics()->draw(frame.getIndexBuffer()->getResource(),
+                                            frame.getIndexCount(),
+                                            sizeof(std::uint16_t),
+                                            frame.getVertexBuffer()->getResource(),
+                                            graphics::DrawMode::triangleList,
+                                            frame.getStartIndex());
         }
     }
 
@@ -27,6 +27,7 @@ namespace ouzel::scene
     public:
         class Frame final
         {
+            friend SpriteData;
         public:
             Frame(const std::string& frameName,
                   const Size2F& textureSize,
@@ -52,6 +53,9 @@ namespace ouzel::scene
 
             auto& getBoundingBox() const noexcept { return boundingBox; }
             auto getIndexCount() const noexcept { return indexCount; }
+            auto getStartIndex() const noexcept { return startIndex; }
+
+            // shared by the frames that were packed together, null until createBuffers is called
             auto& getIndexBuffer() const noexcept { return indexBuffer; }
             auto& getVertexBuffer() const noexcept { return vertexBuffer; }
 
@@ -59,8 +63,13 @@ namespace ouzel::scene
             std::string name;
             Box2F boundingBox;
             std::uint32_t indexCount = 0;
+            std::uint32_t startIndex = 0;
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
+
+            // geometry of the frame until it is packed into the shared buffers
+            std::vector<std::uint16_t> indexData;
+            std::vector<graphics::Vertex> vertexData;
         };
 
         struct Animation final
@@ -70,6 +79,11 @@ namespace ouzel::scene
             float frameInterval = 0.1F;
         };
 
+        // packs the geometry of all of the frames without buffers into one vertex and one index buffer (more if the
+        // frames have over 65536 vertices), so that loading an atlas does not create two buffers per frame
+        static void createBuffers(std::map<std::string, Animation>& animations);
+        void createBuffers() { createBuffers(animations); }
+
         std::map<std::string, Animation> animations;
         std::shared_ptr<graphics::Texture> texture;
         const graphics::BlendState* blendState = nullptr;
@@ -8,6 +8,7 @@
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #include "Path.hpp"
 #include "../utils/Utils.hpp"
@@ -19,7 +20,8 @@ namespace ouzel::storage
     public:
         Archive() = default;
 
-        explicit Archive(const Path& path):
+        explicit Archive(const Path& initPath):
+            path{initPath},
             file{path, std::ios::binary}
         {
             constexpr std::uint32_t centralDirectory = 0x02014B50U;
@@ -101,7 +103,21 @@ namespace ouzel::storage
             return entries.find(filename) != entries.end();
         }
 
+        auto& getPath() const noexcept { return path; }
+
+        // returns the offset and the size of the file, files are stored uncompressed, so they can be read in parts
+        std::pair<std::streamoff, std::size_t> getFileRange(const std::string& filename) const
+        {
+            const auto i = entries.find(filename);
+
+            if (i == entries.end())
+                throw std::runtime_error("File " + filename + " does not exist");
+
+            return {i->second.offset, i->second.size};
+        }
+
     private:
+        Path path;
         std::ifstream file;
 
         struct Entry final
@@ -0,0 +1,108 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_FILEDATA_HPP
+#define OUZEL_STORAGE_FILEDATA_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define OUZEL_STORAGE_MAP_FILES 1
+#endif
+#include "Path.hpp"
+
+namespace ouzel::storage
+{
+    // read-only contents of a file, the copies share the memory, which is either mapped from the file or owned by the
+    // data, so the files that are stored uncompressed can be decoded without copying them
+    class FileData final
+    {
+    public:
+        FileData() = default;
+
+        FileData(std::vector<std::byte> bytes)
+        {
+            if (!bytes.empty())
+            {
+                const auto buffer = std::make_shared<std::vector<std::byte>>(std::move(bytes));
+                pointer = buffer->data();
+                length = buffer->size();
+                owner = buffer;
+            }
+        }
+
+        // maps the part of the file into memory, the file is read into memory on platforms without mmap
+        static FileData map(const Path& path, std::streamoff offset, std::size_t size)
+        {
+            if (size == 0) return FileData{};
+
+#if defined(OUZEL_STORAGE_MAP_FILES)
+            const int fd = open(path.getNative().c_str(), O_RDONLY);
+            if (fd == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to open file " + std::string(path));
+
+            // the offset of the mapping must be a multiple of the page size
+            const auto pageSize = static_cast<std::streamoff>(sysconf(_SC_PAGESIZE));
+            const auto mappingOffset = offset - offset % pageSize;
+            const auto mappingSize = static_cast<std::size_t>(offset - mappingOffset) + size;
+
+            void* address = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(mappingOffset));
+            const int mapError = errno;
+            close(fd);
+
+            if (address == MAP_FAILED)
+                throw std::system_error(mapError, std::system_category(), "Failed to map file " + std::string(path));
+
+            FileData result;
+            result.pointer = static_cast<const std::byte*>(address) + (offset - mappingOffset);
+            result.length = size;
+            result.owner = std::shared_ptr<const void>(address, [mappingSize](const void* mappedAddress) noexcept {
+                munmap(const_cast<void*>(mappedAddress), mappingSize);
+            });
+            return result;
+#else
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("Failed to open file " + std::string(path));
+
+            file.seekg(offset, std::ios::beg);
+
+            std::vector<std::byte> bytes(size);
+            file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size));
+
+            if (static_cast<std::size_t>(file.gcount()) != size)
+                throw std::runtime_error("Failed to read file " + std::string(path));
+
+            return FileData{std::move(bytes)};
+#endif
+        }
+
+        auto data() const noexcept { return pointer; }
+        auto size() const noexcept { return length; }
+        auto empty() const noexcept { return length == 0; }
+
+        auto begin() const noexcept { return pointer; }
+        auto end() const noexcept { return pointer + length; }
+        auto cbegin() const noexcept { return pointer; }
+        auto cend() const noexcept { return pointer + length; }
+
+        const std::byte& operator[](std::size_t index) const noexcept { return pointer[index]; }
+
+    private:
+        std::shared_ptr<const void> owner;
+        const std::byte* pointer = nullptr;
+        std::size_t length = 0;
+    };
+}
+
+#endif // OUZEL_STORAGE_FILEDATA_HPP
@@ -360,6 +360,40 @@ namespace ouzel::storage
         return data;
     }
 
+    FileSection FileSystem::getFileSection(const Path& filename, const bool searchResources) const
+    {
+        if (searchResources)
+            for (auto& archive : archives)
+                if (archive.second.fileExists(filename))
+                {
+                    const auto range = archive.second.getFileRange(filename);
+                    return FileSection{archive.second.getPath(), range.first, range.second};
+                }
+
+        const auto path = getPath(filename, searchResources);
+
+        // file does not exist
+        if (path.isEmpty())
+            throw std::runtime_error("Failed to find file " + std::string(filename));
+
+        return FileSection{path, 0, getFileSize(path)};
+    }
+
+    FileData FileSystem::mapFile(const Path& filename, const bool searchResources)
+    {
+#if defined(__ANDROID__)
+        // the assets are compressed in the package
+        if (!filename.isAbsolute() &&
+            (!searchResources || std::none_of(archives.begin(), archives.end(), [&filename](const auto& archive) {
+                return archive.second.fileExists(filename);
+            })))
+            return FileData{readFile(filename, searchResources)};
+#endif
+
+        const auto section = getFileSection(filename, searchResources);
+        return FileData::map(section.path, section.offset, section.size);
+    }
+
     bool FileSystem::resourceFileExists(const Path& filename) const
     {
         if (filename.isAbsolute())
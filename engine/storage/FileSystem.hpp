@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <ios>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -31,6 +32,7 @@
 #  include <unistd.h>
 #endif
 #include "Archive.hpp"
+#include "FileData.hpp"
 #include "Path.hpp"
 
 namespace ouzel::core
@@ -199,6 +201,14 @@ namespace ouzel::storage
         Type time;
     };
 
+    // part of a file that holds the contents of another file, e.g. a file in an archive
+    struct FileSection final
+    {
+        Path path;
+        std::streamoff offset = 0;
+        std::size_t size = 0;
+    };
+
     class FileSystem final
     {
     public:
@@ -235,6 +245,12 @@ namespace ouzel::storage
 
         std::vector<std::byte> readFile(const Path& filename, const bool searchResources = true);
 
+        // returns the location of the file, so that it can be read in parts instead of at once
+        FileSection getFileSection(const Path& filename, const bool searchResources = true) const;
+
+        // maps the file into memory instead of copying it where possible
+        FileData mapFile(const Path& filename, const bool searchResources = true);
+
         bool resourceFileExists(const Path& filename) const;
 
         Path getPath(const Path& filename, const bool searchResources = true) const
@@ -0,0 +1,98 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_THREAD_FUTEX_HPP
+#define OUZEL_THREAD_FUTEX_HPP
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#if defined(__linux__)
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace ouzel::thread
+{
+    // counter that threads can wait on to change, the waiters spin for a while before going to sleep, so changing
+    // the value never takes a lock (and only makes a system call on Linux if a thread is sleeping)
+    class Futex final
+    {
+    public:
+        explicit Futex(std::uint32_t initValue = 0) noexcept: value{initValue} {}
+
+        Futex(const Futex&) = delete;
+        Futex& operator=(const Futex&) = delete;
+
+        Futex(Futex&&) = delete;
+        Futex& operator=(Futex&&) = delete;
+
+        std::uint32_t load() const noexcept
+        {
+            return value.load(std::memory_order_acquire);
+        }
+
+        void store(std::uint32_t newValue) noexcept
+        {
+            value.store(newValue, std::memory_order_seq_cst);
+            wakeAll();
+        }
+
+        // returns the new value
+        std::uint32_t increment() noexcept
+        {
+            const auto result = value.fetch_add(1, std::memory_order_seq_cst) + 1;
+            wakeAll();
+            return result;
+        }
+
+        // waits until the value is different from oldValue and returns the new value
+        std::uint32_t wait(std::uint32_t oldValue) noexcept
+        {
+            for (std::uint32_t i = 0; i < spinCount; ++i)
+            {
+                const auto currentValue = value.load(std::memory_order_acquire);
+                if (currentValue != oldValue) return currentValue;
+            }
+
+            for (;;)
+            {
+                const auto currentValue = value.load(std::memory_order_acquire);
+                if (currentValue != oldValue) return currentValue;
+
+#if defined(__linux__)
+                // the kernel checks the value again before sleeping, so the wake up can not be missed
+                sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+                syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&value), FUTEX_WAIT_PRIVATE,
+                        oldValue, nullptr, nullptr, 0);
+                sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+#else
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t spinCount = 1000;
+
+        void wakeAll() noexcept
+        {
+#if defined(__linux__)
+            if (sleepingCount.load(std::memory_order_seq_cst) > 0)
+                syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&value), FUTEX_WAKE_PRIVATE,
+                        INT_MAX, nullptr, nullptr, 0);
+#endif
+        }
+
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+        std::atomic<std::uint32_t> value;
+#if defined(__linux__)
+        std::atomic<std::uint32_t> sleepingCount{0};
+#endif
+    };
+}
+
+#endif // OUZEL_THREAD_FUTEX_HPP
@@ -0,0 +1,138 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_THREAD_TASK_HPP
+#define OUZEL_THREAD_TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ouzel::thread
+{
+    // move-only callable wrapper which stores small captures inline
+    class Task final
+    {
+    public:
+        static constexpr std::size_t storageSize = 6 * sizeof(void*);
+
+        Task() noexcept = default;
+
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+        Task(F&& f)
+        {
+            using Callable = std::decay_t<F>;
+
+            if constexpr (sizeof(Callable) <= storageSize &&
+                          alignof(Callable) <= alignof(std::max_align_t) &&
+                          std::is_nothrow_move_constructible_v<Callable>)
+            {
+                new (&storage) Callable(std::forward<F>(f));
+                operations = &InlineOperations<Callable>::operations;
+            }
+            else
+            {
+                new (&storage) Callable*(new Callable(std::forward<F>(f)));
+                operations = &HeapOperations<Callable>::operations;
+            }
+        }
+
+        ~Task()
+        {
+            if (operations) operations->destroy(&storage);
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept:
+            operations(other.operations)
+        {
+            if (operations)
+            {
+                operations->move(&storage, &other.storage);
+                other.operations = nullptr;
+            }
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            if (operations) operations->destroy(&storage);
+
+            operations = other.operations;
+
+            if (operations)
+            {
+                operations->move(&storage, &other.storage);
+                other.operations = nullptr;
+            }
+
+            return *this;
+        }
+
+        explicit operator bool() const noexcept { return operations != nullptr; }
+
+        void operator()()
+        {
+            operations->invoke(&storage);
+        }
+
+    private:
+        struct Operations final
+        {
+            void (*invoke)(void*);
+            void (*move)(void*, void*) noexcept; // move constructs and destroys the source
+            void (*destroy)(void*) noexcept;
+        };
+
+        template <typename Callable>
+        struct InlineOperations final
+        {
+            static void invoke(void* storage)
+            {
+                (*static_cast<Callable*>(storage))();
+            }
+
+            static void move(void* destination, void* source) noexcept
+            {
+                new (destination) Callable(std::move(*static_cast<Callable*>(source)));
+                static_cast<Callable*>(source)->~Callable();
+            }
+
+            static void destroy(void* storage) noexcept
+            {
+                static_cast<Callable*>(storage)->~Callable();
+            }
+
+            static constexpr Operations operations{&invoke, &move, &destroy};
+        };
+
+        template <typename Callable>
+        struct HeapOperations final
+        {
+            static void invoke(void* storage)
+            {
+                (**static_cast<Callable**>(storage))();
+            }
+
+            static void move(void* destination, void* source) noexcept
+            {
+                new (destination) Callable*(*static_cast<Callable**>(source));
+            }
+
+            static void destroy(void* storage) noexcept
+            {
+                delete *static_cast<Callable**>(storage);
+            }
+
+            static constexpr Operations operations{&invoke, &move, &destroy};
+        };
+
+        const Operations* operations = nullptr;
+        std::aligned_storage_t<storageSize, alignof(std::max_align_t)> storage;
+    };
+}
+
+#endif // OUZEL_THREAD_TASK_HPP
@@ -0,0 +1,154 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_THREAD_TASKQUEUE_HPP
+#define OUZEL_THREAD_TASKQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include "Task.hpp"
+
+namespace ouzel::thread
+{
+    // multiple producer, single consumer lock-free queue of tasks, the tasks are stored in a preallocated ring, so
+    // pushing a task does not allocate unless more than ringSize tasks are waiting (then they are stored in a list)
+    class TaskQueue final
+    {
+    public:
+        static constexpr std::size_t ringSize = 1024; // must be a power of two
+
+        TaskQueue():
+            cells(std::make_unique<Cell[]>(ringSize))
+        {
+            for (std::size_t i = 0; i < ringSize; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~TaskQueue()
+        {
+            deleteNodes(overflow.exchange(nullptr, std::memory_order_acquire));
+            deleteNodes(pending);
+        }
+
+        TaskQueue(const TaskQueue&) = delete;
+        TaskQueue& operator=(const TaskQueue&) = delete;
+        TaskQueue(TaskQueue&&) = delete;
+        TaskQueue& operator=(TaskQueue&&) = delete;
+
+        void push(Task task)
+        {
+            // the tasks go to the list while it is not empty, so that the tasks of a thread are executed in order
+            if (overflow.load(std::memory_order_acquire) || !pushToRing(task))
+            {
+                auto node = new Node{std::move(task), overflow.load(std::memory_order_relaxed)};
+
+                while (!overflow.compare_exchange_weak(node->next, node,
+                                                       std::memory_order_release,
+                                                       std::memory_order_relaxed));
+            }
+        }
+
+        // executes the tasks in the order they were pushed, the tasks that are pushed while executing (including the
+        // ones pushed by the tasks themselves) are executed on the next call
+        void executeAll()
+        {
+            // tasks that were not executed because of an exception are executed first
+            executePending();
+
+            const auto end = enqueuePosition.load(std::memory_order_acquire);
+
+            while (dequeuePosition != end)
+            {
+                Cell& cell = cells[dequeuePosition & (ringSize - 1)];
+                if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+                    break; // the producer has not finished storing the task yet
+
+                Task task = std::move(cell.task);
+                cell.sequence.store(dequeuePosition + ringSize, std::memory_order_release);
+                ++dequeuePosition;
+
+                if (task) task();
+            }
+
+            Node* node = overflow.exchange(nullptr, std::memory_order_acquire);
+
+            // the list is in the reverse order of pushing
+            while (node)
+            {
+                Node* next = node->next;
+                node->next = pending;
+                pending = node;
+                node = next;
+            }
+
+            executePending();
+        }
+
+    private:
+        struct Cell final
+        {
+            std::atomic<std::size_t> sequence{0};
+            Task task;
+        };
+
+        struct Node final
+        {
+            Task task;
+            Node* next = nullptr;
+        };
+
+        bool pushToRing(Task& task) noexcept
+        {
+            auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Cell& cell = cells[position & (ringSize - 1)];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                if (difference == 0)
+                {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.task = std::move(task);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                    return false; // the ring is full
+                else
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        void executePending()
+        {
+            while (pending)
+            {
+                std::unique_ptr<Node> node(pending);
+                pending = node->next;
+                if (node->task) node->task();
+            }
+        }
+
+        static void deleteNodes(Node* node) noexcept
+        {
+            while (node)
+            {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+
+        std::unique_ptr<Cell[]> cells;
+        alignas(64) std::atomic<std::size_t> enqueuePosition{0};
+        alignas(64) std::size_t dequeuePosition = 0; // accessed only by the consumer
+        Node* pending = nullptr; // tasks taken from the list but not executed yet, accessed only by the consumer
+        std::atomic<Node*> overflow{nullptr};
+    };
+}
+
+#endif // OUZEL_THREAD_TASKQUEUE_HPP
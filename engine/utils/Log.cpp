@@ -27,16 +27,249 @@
 #  include <emscripten.h>
 #endif
 
+#include <algorithm>
 #include "Log.hpp"
 
 namespace ouzel
 {
+    namespace
+    {
+        constexpr std::size_t bufferSize = 65536; // must be a power of two
+    }
+
     Log::~Log()
     {
-        if (!s.empty())
+        if (enabled && !s.empty())
             logger.log(s, level);
     }
 
+    Logger::Logger(Log::Level initThreshold):
+        threshold(initThreshold)
+    {
+#if !defined(__EMSCRIPTEN__)
+        startTime = std::chrono::steady_clock::now();
+        logThread = thread::Thread(&Logger::logLoop, this);
+#endif
+    }
+
+    Logger::~Logger()
+    {
+#if !defined(__EMSCRIPTEN__)
+        std::unique_lock lock(logMutex);
+        running = false;
+        lock.unlock();
+        logCondition.notify_all();
+
+        if (logThread.isJoinable()) logThread.join();
+#endif
+    }
+
+    void Logger::log(const std::string& str, const Log::Level level) const
+    {
+        if (!isEnabled(level)) return;
+
+#if defined(__EMSCRIPTEN__)
+        logString(str, level);
+#else
+        const auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        const auto buffer = getBuffer();
+        if (buffer && buffer->push(str, level, time))
+            logCondition.notify_one();
+        else
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    bool Logger::Buffer::push(const std::string& str, Log::Level level, std::int64_t time) noexcept
+    {
+        const auto capacity = data.size();
+
+        // messages that would take more than half of the buffer are truncated
+        const auto size = std::min(str.size(), capacity / 2 - sizeof(Header));
+        const auto recordSize = (sizeof(Header) + size + alignment - 1) & ~(alignment - 1);
+
+        auto currentHead = head.load(std::memory_order_relaxed);
+        const auto currentTail = tail.load(std::memory_order_acquire);
+
+        // the record must be contiguous, so skip the rest of the buffer if it does not fit
+        const auto contiguous = capacity - (currentHead & mask);
+        const auto padding = (contiguous < recordSize) ? contiguous : 0;
+
+        if (currentHead - currentTail + padding + recordSize > capacity)
+            return false; // buffer is full
+
+        if (padding)
+        {
+            if (padding >= sizeof(Header))
+            {
+                const Header skipHeader{skipMarker, threadId, time, level};
+                std::memcpy(&data[currentHead & mask], &skipHeader, sizeof(skipHeader));
+            }
+
+            currentHead += padding;
+        }
+
+        const Header header{static_cast<std::uint32_t>(size), threadId, time, level};
+        std::memcpy(&data[currentHead & mask], &header, sizeof(header));
+        std::memcpy(&data[(currentHead & mask) + sizeof(header)], str.data(), size);
+
+        head.store(currentHead + recordSize, std::memory_order_release);
+        return true;
+    }
+
+    bool Logger::Buffer::pop(Header& header, std::string& str)
+    {
+        auto currentTail = tail.load(std::memory_order_relaxed);
+        const auto currentHead = head.load(std::memory_order_acquire);
+
+        if (currentTail == currentHead)
+            return false; // buffer is empty
+
+        const auto contiguous = data.size() - (currentTail & mask);
+
+        if (contiguous < sizeof(Header))
+            currentTail += contiguous;
+        else
+        {
+            std::memcpy(&header, &data[currentTail & mask], sizeof(header));
+            if (header.size == skipMarker)
+                currentTail += contiguous;
+        }
+
+        std::memcpy(&header, &data[currentTail & mask], sizeof(header));
+        str.assign(reinterpret_cast<const char*>(&data[(currentTail & mask) + sizeof(header)]), header.size);
+
+        tail.store(currentTail + ((sizeof(Header) + header.size + alignment - 1) & ~(alignment - 1)),
+                   std::memory_order_release);
+        return true;
+    }
+
+    Logger::Buffer* Logger::getBuffer() const noexcept
+    {
+        // trivially destructible, so it can still be read by the destructors that run after the buffer is released
+        thread_local bool threadExited = false;
+
+        struct ThreadBuffer final
+        {
+            ~ThreadBuffer()
+            {
+                threadExited = true;
+                if (buffer) buffer->orphan();
+                buffer.reset();
+                owner = nullptr;
+            }
+
+            const Logger* owner = nullptr;
+            std::shared_ptr<Buffer> buffer;
+        };
+
+        // the messages logged while the thread exits are dropped
+        if (threadExited) return nullptr;
+
+        thread_local ThreadBuffer threadBuffer;
+
+        if (threadBuffer.owner != this)
+        {
+            try
+            {
+                std::lock_guard lock(buffersMutex);
+                auto newBuffer = std::make_shared<Buffer>(nextThreadId++, bufferSize);
+                buffers.push_back(newBuffer);
+                threadBuffer.buffer = std::move(newBuffer);
+                threadBuffer.owner = this;
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+        }
+
+        return threadBuffer.buffer.get();
+    }
+
+    void Logger::logLoop()
+    {
+        std::vector<std::pair<Buffer::Header, std::string>> records;
+
+        for (;;)
+        {
+            drain(records);
+
+            std::unique_lock lock(logMutex);
+            if (!running) break;
+            logCondition.wait_for(lock, std::chrono::milliseconds(100));
+        }
+
+        drain(records);
+    }
+
+    void Logger::drain(std::vector<std::pair<Buffer::Header, std::string>>& records)
+    {
+        std::unique_lock lock(buffersMutex);
+        std::vector<Buffer*> currentBuffers;
+        for (const auto& buffer : buffers)
+            currentBuffers.push_back(buffer.get());
+        lock.unlock();
+
+        std::size_t recordCount = 0;
+        bool hasOrphanedBuffers = false;
+        for (auto& buffer : currentBuffers)
+        {
+            // checked before popping, so that the records pushed before the thread exited are not lost
+            const auto orphaned = buffer->isOrphaned();
+
+            for (;;)
+            {
+                if (recordCount == records.size()) records.emplace_back();
+                auto& record = records[recordCount];
+                if (!buffer->pop(record.first, record.second)) break;
+                ++recordCount;
+            }
+
+            if (orphaned)
+                hasOrphanedBuffers = true;
+            else
+                buffer = nullptr;
+        }
+
+        // free the drained buffers of the threads that have exited
+        if (hasOrphanedBuffers)
+        {
+            lock.lock();
+            buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [&currentBuffers](const auto& buffer) {
+                return std::find(currentBuffers.begin(), currentBuffers.end(), buffer.get()) != currentBuffers.end();
+            }), buffers.end());
+            lock.unlock();
+        }
+
+        // merge the records of all threads in the order they were logged
+        std::stable_sort(records.begin(), records.begin() + static_cast<std::ptrdiff_t>(recordCount),
+                         [](const auto& a, const auto& b) noexcept {
+                             return a.first.time < b.first.time;
+                         });
+
+        for (std::size_t i = 0; i < recordCount; ++i)
+        {
+            const auto& record = records[i];
+            const auto milliseconds = record.first.time / 1000;
+
+            const auto millisecondString = std::to_string(1000 + milliseconds % 1000);
+            logString("[" + std::to_string(milliseconds / 1000) + "." + millisecondString.substr(1) + "] [" +
+                      std::to_string(record.first.threadId) + "] " + record.second,
+                      record.first.level);
+        }
+
+        const auto currentDroppedCount = droppedCount.load(std::memory_order_relaxed);
+        if (currentDroppedCount != reportedDroppedCount)
+        {
+            logString(std::to_string(currentDroppedCount - reportedDroppedCount) + " log messages dropped", Log::Level::warning);
+            reportedDroppedCount = currentDroppedCount;
+        }
+    }
+#endif
+
     void Logger::logString(const std::string& str, Log::Level level)
     {
 #if defined(__ANDROID__)
@@ -4,13 +4,17 @@
 #define OUZEL_UTILS_LOG_HPP
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <type_traits>
+#include <vector>
 #include "../math/Matrix.hpp"
 #include "../math/Quaternion.hpp"
 #include "../math/Size.hpp"
@@ -35,14 +39,12 @@ namespace ouzel
             all
         };
 
-        explicit Log(const Logger& initLogger, Level initLevel = Level::info):
-            logger(initLogger), level(initLevel)
-        {
-        }
+        explicit Log(const Logger& initLogger, Level initLevel = Level::info);
 
         Log(const Log& other):
             logger(other.logger),
             level(other.level),
+            enabled(other.enabled),
             s(other.s)
         {
         }
@@ -50,9 +52,11 @@ namespace ouzel
         Log(Log&& other) noexcept:
             logger(other.logger),
             level(other.level),
+            enabled(other.enabled),
             s(std::move(other.s))
         {
             other.level = Level::info;
+            other.enabled = false;
         }
 
         Log& operator=(const Log& other)
@@ -60,6 +64,7 @@ namespace ouzel
             if (&other == this) return *this;
 
             level = other.level;
+            enabled = other.enabled;
             s = other.s;
 
             return *this;
@@ -70,7 +75,9 @@ namespace ouzel
             if (&other == this) return *this;
 
             level = other.level;
+            enabled = other.enabled;
             other.level = Level::info;
+            other.enabled = false;
             s = std::move(other.s);
 
             return *this;
@@ -80,12 +87,16 @@ namespace ouzel
 
         Log& operator<<(const bool val)
         {
+            if (!enabled) return *this;
+
             s += val ? "true" : "false";
             return *this;
         }
 
         Log& operator<<(const std::uint8_t val)
         {
+            if (!enabled) return *this;
+
             constexpr char digits[] = "0123456789abcdef";
 
             for (std::uint32_t p = 0; p < 2; ++p)
@@ -99,18 +110,24 @@ namespace ouzel
             !std::is_same_v<T, std::uint8_t>>* = nullptr>
         Log& operator<<(const T val)
         {
+            if (!enabled) return *this;
+
             s += std::to_string(val);
             return *this;
         }
 
         Log& operator<<(const std::string& val)
         {
+            if (!enabled) return *this;
+
             s += val;
             return *this;
         }
 
         Log& operator<<(const char* val)
         {
+            if (!enabled) return *this;
+
             s += val;
             return *this;
         }
@@ -118,6 +135,8 @@ namespace ouzel
         template <typename T, std::enable_if_t<!std::is_same_v<T, char>>* = nullptr>
         Log& operator<<(const T* val)
         {
+            if (!enabled) return *this;
+
             constexpr char digits[] = "0123456789abcdef";
 
             const auto ptrValue = bitCast<std::uintptr_t>(val);
@@ -130,6 +149,8 @@ namespace ouzel
 
         Log& operator<<(const storage::Path& val)
         {
+            if (!enabled) return *this;
+
             s += val;
             return *this;
         }
@@ -146,6 +167,8 @@ namespace ouzel
         template <typename T, std::enable_if_t<isContainer<T>::value || std::is_array_v<T>>* = nullptr>
         Log& operator<<(const T& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
             for (const auto& i : val)
             {
@@ -160,6 +183,8 @@ namespace ouzel
         template <std::size_t N, std::size_t M, class T>
         Log& operator<<(const Matrix<N, M, T>& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (const T c : val.m)
@@ -175,6 +200,8 @@ namespace ouzel
         template <typename T>
         Log& operator<<(const Quaternion<T>& val)
         {
+            if (!enabled) return *this;
+
             s += std::to_string(val.v[0]) + "," + std::to_string(val.v[1]) + "," +
                 std::to_string(val.v[2]) + "," + std::to_string(val.v[3]);
             return *this;
@@ -183,6 +210,8 @@ namespace ouzel
         template <std::size_t N, class T>
         Log& operator<<(const Size<N, T>& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (const T c : val.v)
@@ -197,6 +226,8 @@ namespace ouzel
         template <std::size_t N, class T>
         Log& operator<<(const Vector<N, T>& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (const T c : val.v)
@@ -211,55 +242,40 @@ namespace ouzel
     private:
         const Logger& logger;
         Level level = Level::info;
+        bool enabled = false; // the level passes the threshold of the logger
         std::string s;
     };
 
     class Logger final
     {
     public:
-        explicit Logger(Log::Level initThreshold = Log::Level::all):
-            threshold(initThreshold)
-        {
-#if !defined(__EMSCRIPTEN__)
-            logThread = thread::Thread(&Logger::logLoop, this);
-#endif
-        }
+        explicit Logger(Log::Level initThreshold = Log::Level::all);
 
         Logger(const Logger&) = delete;
         Logger& operator=(const Logger&) = delete;
         Logger(Logger&&) = delete;
         Logger& operator=(Logger&&) = delete;
 
-        ~Logger()
-        {
-#if !defined(__EMSCRIPTEN__)
-            std::unique_lock lock(queueMutex);
-            commandQueue.push(Command(Command::Type::quit));
-            lock.unlock();
-            queueCondition.notify_all();
-#endif
-        }
+        ~Logger();
 
         Log log(const Log::Level level = Log::Level::info) const
         {
             return Log(*this, level);
         }
 
-        void log(const std::string& str, const Log::Level level = Log::Level::info) const
+        void log(const std::string& str, const Log::Level level = Log::Level::info) const;
+
+        bool isEnabled(const Log::Level level) const noexcept
         {
-            if (level <= threshold)
-            {
-#if defined(__EMSCRIPTEN__)
-                logString(str, level);
-#else
-                std::unique_lock lock(queueMutex);
-                commandQueue.push(Command(Command::Type::logString, level, str));
-                lock.unlock();
-                queueCondition.notify_all();
-#endif
-            }
+            return level <= threshold.load(std::memory_order_relaxed);
         }
 
+        auto getThreshold() const noexcept { return threshold.load(std::memory_order_relaxed); }
+        void setThreshold(Log::Level newThreshold) noexcept { threshold.store(newThreshold, std::memory_order_relaxed); }
+
+        // number of messages dropped because the thread's buffer was full
+        auto getDroppedCount() const noexcept { return droppedCount.load(std::memory_order_relaxed); }
+
     private:
         static void logString(const std::string& str, const Log::Level level = Log::Level::info);
 
@@ -269,57 +285,72 @@ namespace ouzel
         std::atomic<Log::Level> threshold{Log::Level::info};
 #endif
 
+        mutable std::atomic<std::size_t> droppedCount{0};
+
 #if !defined(__EMSCRIPTEN__)
-        class Command final
+        // single producer (the owning thread), single consumer (the log thread) ring of log records
+        class Buffer final
         {
         public:
-            enum class Type
+            struct Header final
             {
-                logString,
-                quit
+                std::uint32_t size; // size of the text following the header
+                std::uint32_t threadId;
+                std::int64_t time; // microseconds since the logger was created
+                Log::Level level;
             };
 
-            explicit Command(const Type initType):
-                type(initType)
+            Buffer(std::uint32_t initThreadId, std::size_t capacity):
+                threadId(initThreadId),
+                data(capacity),
+                mask(capacity - 1)
             {
             }
 
-            Command(const Type initType, const Log::Level initLevel,
-                    const std::string& initString):
-                type(initType),
-                level(initLevel),
-                str(initString)
-            {
-            }
+            bool push(const std::string& str, Log::Level level, std::int64_t time) noexcept;
+            bool pop(Header& header, std::string& str);
 
-            Type type;
-            Log::Level level = Log::Level::all;
-            std::string str;
+            // called when the owning thread exits, the log thread releases the buffer after draining it
+            void orphan() noexcept { orphaned.store(true, std::memory_order_release); }
+            bool isOrphaned() const noexcept { return orphaned.load(std::memory_order_acquire); }
+
+        private:
+            static constexpr std::uint32_t skipMarker = 0xFFFFFFFFU;
+            static constexpr std::size_t alignment = alignof(Header);
+
+            std::uint32_t threadId;
+            std::vector<std::byte> data;
+            std::size_t mask;
+            alignas(64) std::atomic<std::size_t> head{0};
+            alignas(64) std::atomic<std::size_t> tail{0};
+            std::atomic_bool orphaned{false};
         };
 
-        void logLoop()
-        {
-            for (;;)
-            {
-                std::unique_lock lock(queueMutex);
-                while (commandQueue.empty()) queueCondition.wait(lock);
-                auto command = std::move(commandQueue.front());
-                commandQueue.pop();
-                lock.unlock();
-
-                if (command.type == Command::Type::logString)
-                    logString(command.str, command.level);
-                else if (command.type == Command::Type::quit)
-                    break;
-            }
-        }
+        Buffer* getBuffer() const noexcept;
+        void logLoop();
+        void drain(std::vector<std::pair<Buffer::Header, std::string>>& records);
+
+        std::chrono::steady_clock::time_point startTime;
+
+        mutable std::mutex buffersMutex; // only held while registering a thread and while draining
+        // shared with the owning threads, so that a thread that exits after the logger is destroyed can still orphan it
+        mutable std::vector<std::shared_ptr<Buffer>> buffers;
+        mutable std::uint32_t nextThreadId = 1;
 
-        mutable std::condition_variable queueCondition;
-        mutable std::mutex queueMutex;
-        mutable std::queue<Command> commandQueue;
+        mutable std::condition_variable logCondition;
+        std::mutex logMutex;
+        bool running = true;
+        std::size_t reportedDroppedCount = 0;
         thread::Thread logThread;
 #endif
     };
+
+    inline Log::Log(const Logger& initLogger, Level initLevel):
+        logger(initLogger),
+        level(initLevel),
+        enabled(initLogger.isEnabled(initLevel))
+    {
+    }
 }
 
 #endif // OUZEL_UTILS_LOG_HPP
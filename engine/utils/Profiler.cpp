@@ -0,0 +1,197 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <fstream>
+#include <stdexcept>
+#include "Profiler.hpp"
+#include "../formats/Json.hpp"
+
+namespace ouzel
+{
+    Profiler profiler;
+
+    namespace
+    {
+        constexpr std::size_t threadBufferSize = 8192; // must be a power of two
+        constexpr std::size_t historySize = 65536;
+        constexpr std::size_t maxExitedThreadCount = 16; // the history of at most this many exited threads is kept
+
+        // trivially destructible, so that reading it never registers a thread exit handler
+        thread_local Profiler::ThreadBuffer* currentThreadBuffer = nullptr;
+        thread_local bool threadExited = false;
+
+        struct ThreadRegistration final
+        {
+            ~ThreadRegistration()
+            {
+                threadExited = true;
+                currentThreadBuffer = nullptr;
+                if (buffer) buffer->orphan();
+            }
+
+            std::shared_ptr<Profiler::ThreadBuffer> buffer;
+        };
+    }
+
+    Profiler::Profiler():
+        startTime(std::chrono::steady_clock::now())
+    {
+    }
+
+    Profiler::ThreadBuffer* Profiler::getThreadBuffer() noexcept
+    {
+        // the samples of the threads that are not registered are dropped
+        return currentThreadBuffer;
+    }
+
+    void Profiler::registerThread(const std::string& name)
+    {
+        if (threadExited) return;
+
+        thread_local ThreadRegistration registration;
+
+        std::lock_guard lock(threadsMutex);
+
+        if (registration.buffer)
+        {
+            for (auto& threadInfo : threads)
+                if (threadInfo.buffer == registration.buffer)
+                    threadInfo.name = name;
+        }
+        else
+        {
+            ThreadInfo threadInfo;
+            threadInfo.id = nextThreadId++;
+            threadInfo.name = name;
+            threadInfo.buffer = std::make_shared<ThreadBuffer>(threadInfo.id, threadBufferSize);
+            threads.push_back(std::move(threadInfo));
+
+            registration.buffer = threads.back().buffer;
+            currentThreadBuffer = registration.buffer.get();
+        }
+    }
+
+    void Profiler::collect()
+    {
+        std::lock_guard lock(threadsMutex);
+
+        std::size_t exitedThreadCount = 0;
+        for (auto& threadInfo : threads)
+        {
+            if (!threadInfo.buffer)
+            {
+                ++exitedThreadCount;
+                continue;
+            }
+
+            // checked before popping, so that the samples recorded before the thread exited are not lost
+            const auto orphaned = threadInfo.buffer->isOrphaned();
+
+            threadInfo.buffer->pop([&threadInfo](const Sample& sample) {
+                threadInfo.history.push_back(sample);
+            });
+
+            while (threadInfo.history.size() > historySize)
+                threadInfo.history.pop_front();
+
+            threadInfo.droppedCount = threadInfo.buffer->getDroppedCount();
+
+            if (orphaned)
+            {
+                threadInfo.buffer.reset();
+                ++exitedThreadCount;
+            }
+        }
+
+        // forget the oldest exited threads
+        for (auto i = threads.begin(); exitedThreadCount > maxExitedThreadCount && i != threads.end();)
+            if (!i->buffer)
+            {
+                i = threads.erase(i);
+                --exitedThreadCount;
+            }
+            else
+                ++i;
+    }
+
+    void Profiler::endFrame()
+    {
+        if (!isEnabled()) return;
+
+        collect();
+
+        const auto currentTime = getTime();
+        const auto frameTime = currentTime - previousFrameTime;
+        const bool firstFrame = previousFrameTime == 0;
+        previousFrameTime = currentTime;
+
+        if (!firstFrame && spikeThreshold.count() > 0 && frameTime > spikeThreshold.count())
+            writeTrace(spikePath);
+    }
+
+    void Profiler::setSpikeThreshold(std::chrono::microseconds threshold, const storage::Path& path)
+    {
+        spikeThreshold = threshold;
+        spikePath = path;
+    }
+
+    std::string Profiler::getTrace()
+    {
+        collect();
+
+        json::Value events = json::Value::Array{};
+
+        std::lock_guard lock(threadsMutex);
+
+        for (const auto& threadInfo : threads)
+        {
+            json::Value nameEvent;
+            nameEvent["name"] = "thread_name";
+            nameEvent["ph"] = "M";
+            nameEvent["pid"] = 0;
+            nameEvent["tid"] = threadInfo.id;
+            nameEvent["args"]["name"] = threadInfo.name;
+            events.pushBack(nameEvent);
+
+            for (const auto& sample : threadInfo.history)
+            {
+                json::Value event;
+                event["name"] = sample.name;
+                event["ph"] = "X";
+                event["ts"] = sample.start;
+                event["dur"] = sample.duration;
+                event["pid"] = 0;
+                event["tid"] = threadInfo.id;
+                events.pushBack(event);
+            }
+
+            if (const auto droppedCount = threadInfo.droppedCount)
+            {
+                json::Value counterEvent;
+                counterEvent["name"] = "dropped samples";
+                counterEvent["ph"] = "C";
+                counterEvent["ts"] = getTime();
+                counterEvent["pid"] = 0;
+                counterEvent["tid"] = threadInfo.id;
+                counterEvent["args"]["count"] = droppedCount;
+                events.pushBack(counterEvent);
+            }
+        }
+
+        json::Value trace;
+        trace["traceEvents"] = events;
+        trace["displayTimeUnit"] = "ms";
+
+        return json::encode(trace);
+    }
+
+    void Profiler::writeTrace(const storage::Path& path)
+    {
+        const auto trace = getTrace();
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open file " + std::string(path));
+
+        file.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+    }
+}
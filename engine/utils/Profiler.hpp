@@ -0,0 +1,189 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_PROFILER_HPP
+#define OUZEL_UTILS_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../core/Setup.h"
+#include "../storage/Path.hpp"
+
+namespace ouzel
+{
+    class Profiler final
+    {
+    public:
+        struct Sample final
+        {
+            const char* name = nullptr; // must point to a string literal
+            std::int64_t start = 0; // microseconds since the profiler was created
+            std::int64_t duration = 0;
+        };
+
+        // single producer (the owning thread), single consumer (the thread calling collect)
+        class ThreadBuffer final
+        {
+        public:
+            ThreadBuffer(std::uint32_t initId, std::size_t capacity):
+                id(initId),
+                samples(capacity),
+                mask(capacity - 1)
+            {
+            }
+
+            bool push(const Sample& sample) noexcept
+            {
+                const auto currentHead = head.load(std::memory_order_relaxed);
+                const auto nextHead = (currentHead + 1) & mask;
+
+                if (nextHead == tail.load(std::memory_order_acquire))
+                {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                samples[currentHead] = sample;
+                head.store(nextHead, std::memory_order_release);
+                return true;
+            }
+
+            template <class F>
+            void pop(F f)
+            {
+                auto currentTail = tail.load(std::memory_order_relaxed);
+                const auto currentHead = head.load(std::memory_order_acquire);
+
+                while (currentTail != currentHead)
+                {
+                    f(samples[currentTail]);
+                    currentTail = (currentTail + 1) & mask;
+                }
+
+                tail.store(currentTail, std::memory_order_release);
+            }
+
+            auto getId() const noexcept { return id; }
+            auto getDroppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+            // called when the owning thread exits, the buffer is released after its samples are collected
+            void orphan() noexcept { orphaned.store(true, std::memory_order_release); }
+            bool isOrphaned() const noexcept { return orphaned.load(std::memory_order_acquire); }
+
+        private:
+            std::uint32_t id;
+            std::vector<Sample> samples;
+            std::size_t mask;
+            alignas(64) std::atomic<std::size_t> head{0};
+            alignas(64) std::atomic<std::size_t> tail{0};
+            std::atomic<std::size_t> dropped{0};
+            std::atomic_bool orphaned{false};
+        };
+
+        Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+        Profiler(Profiler&&) = delete;
+        Profiler& operator=(Profiler&&) = delete;
+
+        bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+        void setEnabled(bool newEnabled) { enabled.store(newEnabled, std::memory_order_relaxed); }
+
+        std::int64_t getTime() const noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
+        void addSample(const Sample& sample) noexcept
+        {
+            if (auto threadBuffer = getThreadBuffer())
+                threadBuffer->push(sample);
+        }
+
+        // the samples are only recorded on the registered threads, so that recording a sample never locks or
+        // allocates, must not be called from real-time callbacks (register again to rename the thread)
+        void registerThread(const std::string& name);
+
+        // moves the samples from thread buffers to the history and checks for frame time spikes
+        void endFrame();
+
+        // writes the trace to the given file if a frame takes longer than the threshold, 0 disables it
+        void setSpikeThreshold(std::chrono::microseconds threshold, const storage::Path& path);
+
+        std::string getTrace();
+        void writeTrace(const storage::Path& path);
+
+    private:
+        struct ThreadInfo final
+        {
+            std::uint32_t id = 0;
+            std::string name;
+            std::shared_ptr<ThreadBuffer> buffer; // shared with the thread, released after the thread exits
+            std::size_t droppedCount = 0;
+            std::deque<Sample> history;
+        };
+
+        static ThreadBuffer* getThreadBuffer() noexcept;
+        void collect();
+
+        std::chrono::steady_clock::time_point startTime;
+        std::atomic_bool enabled{false};
+
+        std::mutex threadsMutex;
+        std::vector<ThreadInfo> threads;
+        std::uint32_t nextThreadId = 1;
+
+        std::int64_t previousFrameTime = 0;
+        std::chrono::microseconds spikeThreshold{0};
+        storage::Path spikePath;
+    };
+
+    extern Profiler profiler;
+
+#if OUZEL_ENABLE_PROFILER
+    class ProfileScope final
+    {
+    public:
+        explicit ProfileScope(const char* initName) noexcept:
+            name(initName),
+            start(profiler.isEnabled() ? profiler.getTime() : -1)
+        {
+        }
+
+        ~ProfileScope()
+        {
+            if (start >= 0 && profiler.isEnabled())
+                profiler.addSample(Profiler::Sample{name, start, profiler.getTime() - start});
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+        ProfileScope(ProfileScope&&) = delete;
+        ProfileScope& operator=(ProfileScope&&) = delete;
+
+    private:
+        const char* name;
+        std::int64_t start;
+    };
+#endif
+}
+
+#if OUZEL_ENABLE_PROFILER
+#  define OUZEL_PROFILE_CONCAT_IMPL(a, b) a##b
+#  define OUZEL_PROFILE_CONCAT(a, b) OUZEL_PROFILE_CONCAT_IMPL(a, b)
+#  define OUZEL_PROFILE_SCOPE(name) ouzel::ProfileScope OUZEL_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#  define OUZEL_PROFILE_THREAD(name) ouzel::profiler.registerThread(name)
+#  define OUZEL_PROFILE_FRAME() ouzel::profiler.endFrame()
+#else
+#  define OUZEL_PROFILE_SCOPE(name)
+#  define OUZEL_PROFILE_THREAD(name)
+#  define OUZEL_PROFILE_FRAME()
+#endif
+
+#endif // OUZEL_UTILS_PROFILER_HPP